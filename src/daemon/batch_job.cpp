@@ -0,0 +1,39 @@
+/**
+ * @file batch_job.cpp
+ * 
+ * Jobs of the batch scheduler, which renders many grammars at once
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include "batch_job.hpp"
+#include "../render/argument_parser.hpp"
+
+namespace dmalem {
+
+std::vector<batch_job> read_jobs(std::istream& istr, const std::filesystem::path& base, const std::string& sourceName) {
+    std::vector<batch_job> jobs;
+    std::string line;
+    for (size_t number = 1; std::getline(istr, line); ++number) {
+        std::istringstream fields(line);
+        std::vector<std::string> args;
+        for (std::string field; fields >> field; )
+            args.push_back(field);
+        if (args.empty() || args[0].starts_with('#'))
+            continue;
+        batch_job job;
+        job.name = sourceName + ':' + std::to_string(number);
+        if (args.size() < 2)
+            throw std::invalid_argument(job.name + ": missing grammar file");
+        try {
+            job.request = request_from_arguments({args.begin() + 1, args.end()}, base);
+        } catch (const argument_parser::error& e) {
+            throw std::invalid_argument(job.name + ": " + e.what());
+        }
+        job.outputPath = (base / args[0]).lexically_normal();
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
+
+}
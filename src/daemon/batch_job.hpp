@@ -0,0 +1,54 @@
+/**
+ * @file batch_job.hpp
+ * 
+ * Jobs of the batch scheduler, which renders many grammars at once
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "render_request.hpp"
+
+namespace dmalem {
+
+/**
+ * Render of one parser run to a file
+ */
+struct batch_job {
+    /**
+     * What to render
+     */
+    render_request request;
+    /**
+     * File that receives the rendered output
+     */
+    std::filesystem::path outputPath;
+    /**
+     * Where the job comes from, as `file:line`, for diagnostics
+     */
+    std::string name;
+};
+
+/**
+ * Reads a list of jobs
+ * 
+ * Each line is a job, except empty lines and lines that start with `#`.
+ * A job is the output file, then the arguments that `drawmealemon` takes,
+ * separated by whitespace: the grammar file, `-t`, `-o` and `-f` flags,
+ * then `--` and the tokens
+ * 
+ *     out/toy.txt grammars/toy.y -t ascii -- 1 2 3
+ *     out/sql.txt grammars/sql.y -f sessions/sql.tokens
+ * 
+ * @param istr       Stream that holds the list
+ * @param base       Directory against which relative paths are resolved
+ * @param sourceName Name of the list, used in the names of the jobs
+ * @return           The jobs, in order
+ * @throw std::invalid_argument A job is not valid, with its name in the message
+ */
+std::vector<batch_job> read_jobs(std::istream& istr, const std::filesystem::path& base, const std::string& sourceName);
+
+}
@@ -0,0 +1,80 @@
+/**
+ * @file batch_scheduler.cpp
+ * 
+ * Scheduler that builds and renders many grammars at once
+ */
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include "batch_scheduler.hpp"
+#include "parser_run.hpp"
+#include "task_pool.hpp"
+
+namespace dmalem {
+
+batch_scheduler::batch_scheduler(parser_cache& cache, size_t threads) : cache(cache), threads(threads) {
+    if (threads == 0)
+        throw std::invalid_argument(__FUNCTION__);
+}
+
+size_t batch_scheduler::run(const std::vector<batch_job>& jobs, std::ostream& log) {
+    // Each job is only written by its own task, so the tasks need no locking
+    std::vector<int> statuses(jobs.size(), 1);
+    std::vector<std::string> logs(jobs.size());
+    std::map<std::string, std::vector<size_t>> jobsByGrammar;
+    for (size_t i = 0; i < jobs.size(); ++i)
+        jobsByGrammar[jobs[i].request.grammarPath].push_back(i);
+
+    {
+        task_pool pool(threads);
+        for (const auto& [grammar, indices] : jobsByGrammar) {
+            pool.submit([&, grammar = grammar, indices = indices] {
+                std::filesystem::path wrapper;
+                try {
+                    wrapper = cache.wrapper_for(grammar);
+                } catch (const parser_cache::build_error& e) {
+                    for (size_t i : indices)
+                        logs[i] = e.what();
+                    return;
+                } catch (const std::exception& e) {
+                    for (size_t i : indices)
+                        logs[i] = std::string(e.what()) + '\n';
+                    return;
+                }
+                for (size_t i : indices) {
+                    pool.submit([&, wrapper, i] {
+                        const batch_job& job = jobs[i];
+                        std::error_code ignored;
+                        std::filesystem::create_directories(job.outputPath.parent_path(), ignored);
+                        std::ofstream output(job.outputPath);
+                        if (!output) {
+                            logs[i] = "Could not write " + job.outputPath.string() + '\n';
+                            return;
+                        }
+                        std::ostringstream jobLog;
+                        statuses[i] = render_parser_run(wrapper, job.request, output, jobLog);
+                        logs[i] = jobLog.str();
+                    });
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    size_t failures = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        std::istringstream lines(logs[i]);
+        for (std::string line; std::getline(lines, line); )
+            log << jobs[i].name << ": " << line << '\n';
+        if (statuses[i] != 0) {
+            log << jobs[i].name << ": failed with status " << statuses[i] << '\n';
+            ++failures;
+        }
+    }
+    log << jobs.size() - failures << " of " << jobs.size() << " jobs succeeded\n";
+    return failures;
+}
+
+}
@@ -0,0 +1,52 @@
+/**
+ * @file batch_scheduler.hpp
+ * 
+ * Scheduler that builds and renders many grammars at once
+ */
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include "batch_job.hpp"
+#include "parser_cache.hpp"
+
+namespace dmalem {
+
+/**
+ * Runs a list of jobs as a graph of tasks on a @ref task_pool
+ * 
+ * Each distinct grammar is one build task, and each job is one render task
+ * that depends on the build of its grammar. Builds of different grammars
+ * run in parallel, and the renders of a grammar are submitted as soon as
+ * its parser is built, so they start while other grammars are still building
+ */
+class batch_scheduler {
+public:
+    /**
+     * Constructor
+     * 
+     * @param cache   Cache of compiled parsers. Must outlive the scheduler
+     * @param threads Number of threads that build and render
+     * @throw std::invalid_argument @p threads is 0
+     */
+    batch_scheduler(parser_cache& cache, size_t threads);
+
+    /**
+     * Runs jobs to completion
+     * 
+     * The diagnostics of each job are printed once all jobs are done,
+     * in the order of the jobs, each prefixed with the name of the job
+     * 
+     * @param jobs The jobs
+     * @param log  Stream that receives the diagnostics
+     * @return     Number of jobs that failed
+     */
+    size_t run(const std::vector<batch_job>& jobs, std::ostream& log);
+
+private:
+    parser_cache& cache;
+    size_t threads;
+};
+
+}
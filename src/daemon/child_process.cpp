@@ -0,0 +1,159 @@
+/**
+ * @file child_process.cpp
+ * 
+ * Running of the programs the render daemon relies on:
+ * Lemon, the C compiler and the compiled wrappers
+ */
+
+#include <cerrno>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <system_error>
+#include <unistd.h>
+#include "child_process.hpp"
+
+extern char** environ;
+
+namespace dmalem {
+
+/**
+ * Opens a pipe with close-on-exec on both ends
+ * 
+ * @throw std::system_error The pipe could not be opened
+ */
+static void open_pipe(int (&fds)[2]) {
+    if (pipe2(fds, O_CLOEXEC) != 0)
+        throw std::system_error(errno, std::generic_category(), __FUNCTION__);
+}
+
+static void close_fd(int& fd) noexcept {
+    if (fd >= 0)
+        close(fd);
+    fd = -1;
+}
+
+child_process::child_process(const std::vector<std::string>& argv, bool mergeErrors) {
+    int in[2] = {-1, -1}, out[2] = {-1, -1}, err[2] = {-1, -1};
+    std::vector<char*> args;
+    for (const auto& arg : argv)
+        args.push_back(const_cast<char*>(arg.c_str()));
+    args.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    int error = 0;
+    try {
+        open_pipe(in);
+        open_pipe(out);
+        if (!mergeErrors)
+            open_pipe(err);
+        // The duplicates lose close-on-exec, unlike the originals
+        posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, mergeErrors ? out[1] : err[1], STDERR_FILENO);
+        error = posix_spawnp(&pid, args[0], &actions, nullptr, args.data(), environ);
+    } catch (const std::system_error& e) {
+        error = e.code().value();
+    }
+    posix_spawn_file_actions_destroy(&actions);
+    close_fd(in[0]);
+    close_fd(out[1]);
+    close_fd(err[1]);
+    inputFd = in[1];
+    outputFd = out[0];
+    errorFd = err[0];
+    if (error != 0) {
+        close_fd(inputFd);
+        close_fd(outputFd);
+        close_fd(errorFd);
+        throw std::system_error(error, std::generic_category(), argv.front());
+    }
+}
+
+child_process::~child_process() {
+    close_fd(inputFd);
+    close_fd(outputFd);
+    // The program ends once its output is closed, and with it its standard error
+    if (errorReader.joinable())
+        errorReader.join();
+    close_fd(errorFd);
+    wait();
+}
+
+int child_process::input() const noexcept {
+    return inputFd;
+}
+
+int child_process::output() const noexcept {
+    return outputFd;
+}
+
+int child_process::errors() const noexcept {
+    return errorFd;
+}
+
+void child_process::drain_errors() {
+    errorReader = std::thread([this] { errorText = read_all(errorFd); });
+}
+
+std::string child_process::drained_errors() {
+    if (errorReader.joinable())
+        errorReader.join();
+    return std::move(errorText);
+}
+
+void child_process::close_input() noexcept {
+    close_fd(inputFd);
+}
+
+int child_process::wait() noexcept {
+    if (done)
+        return status;
+    int raw;
+    while (waitpid(pid, &raw, 0) < 0) {
+        if (errno != EINTR) {
+            status = 127;
+            done = true;
+            return status;
+        }
+    }
+    status = WIFEXITED(raw) ? WEXITSTATUS(raw) : 128 + WTERMSIG(raw);
+    done = true;
+    return status;
+}
+
+std::string read_all(int fd) {
+    std::string data;
+    char buffer[4096];
+    for (;;) {
+        const ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return data;
+        data.append(buffer, static_cast<size_t>(count));
+    }
+}
+
+bool write_all(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        const ssize_t count = write(fd, data.data() + written, data.size() - written);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+        written += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+int run_program(const std::vector<std::string>& argv, std::string& output) {
+    child_process child(argv, true);
+    child.close_input();
+    output = read_all(child.output());
+    return child.wait();
+}
+
+}
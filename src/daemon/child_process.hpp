@@ -0,0 +1,109 @@
+/**
+ * @file child_process.hpp
+ * 
+ * Running of the programs the render daemon relies on:
+ * Lemon, the C compiler and the compiled wrappers
+ */
+
+#pragma once
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+
+namespace dmalem {
+
+/**
+ * Program started by the daemon, with pipes to its standard streams
+ * 
+ * All descriptors are opened with close-on-exec, so that children
+ * started at the same time by other threads do not hold on to them
+ */
+class child_process {
+public:
+    /**
+     * Starts a program
+     * 
+     * @param argv        Path to the program and its arguments
+     * @param mergeErrors Whether the standard error goes to the same pipe as the standard output
+     * @throw std::system_error The program could not be started
+     */
+    child_process(const std::vector<std::string>& argv, bool mergeErrors);
+    child_process(const child_process&) = delete;
+    child_process& operator=(const child_process&) = delete;
+    /**
+     * Closes the pipes and waits for the program to end
+     * 
+     * The standard error is read to its end first if it is being drained
+     */
+    ~child_process();
+
+    /**
+     * Write end of the pipe to the standard input, or -1 once closed
+     */
+    int input() const noexcept;
+    /**
+     * Read end of the pipe from the standard output
+     */
+    int output() const noexcept;
+    /**
+     * Read end of the pipe from the standard error, or -1 if merged with the output
+     */
+    int errors() const noexcept;
+    /**
+     * Starts reading the standard error on a thread of its own, so that a program
+     * that writes more than a pipe holds to it does not block while its output is read
+     */
+    void drain_errors();
+    /**
+     * Waits for the end of the standard error read since @ref drain_errors
+     * 
+     * @return Everything the program wrote to its standard error
+     */
+    std::string drained_errors();
+    /**
+     * Closes the standard input, so the program sees the end of its input
+     */
+    void close_input() noexcept;
+    /**
+     * Waits for the program to end
+     * 
+     * @return Exit status of the program, or 128 plus the signal that killed it
+     */
+    int wait() noexcept;
+
+private:
+    pid_t pid;
+    int inputFd = -1;
+    int outputFd = -1;
+    int errorFd = -1;
+    std::thread errorReader;
+    std::string errorText;
+    bool done = false;
+    int status = 0;
+};
+
+/**
+ * Reads from a descriptor until the end of its data
+ */
+std::string read_all(int fd);
+
+/**
+ * Writes a whole buffer to a descriptor
+ * 
+ * @return Whether everything was written
+ */
+bool write_all(int fd, const std::string& data);
+
+/**
+ * Runs a program to completion, without input
+ * 
+ * @param argv        Path to the program and its arguments
+ * @param[out] output Receives the standard output and error of the program
+ * @return            Exit status of the program, as returned by @ref child_process::wait
+ * @throw std::system_error The program could not be started
+ */
+int run_program(const std::vector<std::string>& argv, std::string& output);
+
+}
@@ -0,0 +1,151 @@
+/**
+ * @file event_ring.cpp
+ * 
+ * Renderer side of the shared memory ring through which a parser
+ * hands over its steps, as described in event_ring.h
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <system_error>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "event_ring.hpp"
+#include "event_ring_decoder.hpp"
+
+namespace dmalem {
+
+/**
+ * Atomic view of a field of the shared memory
+ */
+static std::atomic_ref<uint32_t> shared(uint32_t& field) {
+    return std::atomic_ref<uint32_t>(field);
+}
+
+/**
+ * Wakes up the parser
+ */
+static void signal(int fd) {
+    const uint64_t one = 1;
+    while (write(fd, &one, sizeof(one)) < 0 && errno == EINTR)
+        ;
+}
+
+event_ring::event_ring() {
+    memoryFd = memfd_create("dmalem-event-ring", 0);
+    dataFd = eventfd(0, 0);
+    spaceFd = eventfd(0, 0);
+    if (memoryFd < 0 || dataFd < 0 || spaceFd < 0) {
+        const int error = errno;
+        this->~event_ring();
+        throw std::system_error(error, std::generic_category(), __FUNCTION__);
+    }
+}
+
+event_ring::~event_ring() {
+    if (memory)
+        munmap(memory, size);
+    memory = nullptr;
+    for (int* fd : {&memoryFd, &dataFd, &spaceFd}) {
+        if (*fd >= 0)
+            close(*fd);
+        *fd = -1;
+    }
+}
+
+std::vector<std::string> event_ring::producer_arguments() const {
+    return {std::to_string(memoryFd), std::to_string(dataFd), std::to_string(spaceFd)};
+}
+
+bool event_ring::wait_for_data(int hangupFd, std::ostream& log) {
+    for (;;) {
+        pollfd fds[2] = {
+            {.fd = dataFd, .events = POLLIN, .revents = 0},
+            {.fd = hangupFd, .events = POLLIN, .revents = 0},
+        };
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), __FUNCTION__);
+        }
+        if (fds[0].revents & POLLIN) {
+            uint64_t count;
+            if (read(dataFd, &count, sizeof(count)) < 0 && errno != EINTR)
+                throw std::system_error(errno, std::generic_category(), __FUNCTION__);
+            return true;
+        }
+        if (fds[1].revents) {
+            // The actions of the grammar may print, which is not part of the ring
+            char buffer[4096];
+            const ssize_t count = read(hangupFd, buffer, sizeof(buffer));
+            if (count <= 0)
+                return false;
+            log.write(buffer, count);
+        }
+    }
+}
+
+void event_ring::map() {
+    struct stat status;
+    if (fstat(memoryFd, &status) != 0)
+        throw std::system_error(errno, std::generic_category(), __FUNCTION__);
+    if (static_cast<size_t>(status.st_size) < sizeof(event_ring_header))
+        throw std::invalid_argument(__FUNCTION__);
+    size = static_cast<size_t>(status.st_size);
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memoryFd, 0);
+    if (memory == MAP_FAILED) {
+        memory = nullptr;
+        throw std::system_error(errno, std::generic_category(), __FUNCTION__);
+    }
+}
+
+bool event_ring::consume(trace_action_sink& sink, int hangupFd, std::ostream& log) {
+    // The parser signals once it has set the memory up
+    if (!wait_for_data(hangupFd, log))
+        return false;
+    map();
+    auto* header = static_cast<event_ring_header*>(memory);
+    if (shared(header->magic).load(std::memory_order_acquire) != EVENT_RING_MAGIC)
+        throw std::invalid_argument(__FUNCTION__);
+    const event_ring_decoder decoder(memory, size);
+    const auto* records = reinterpret_cast<const event_ring_record*>(
+        static_cast<const char*>(memory) + header->recordsOffset);
+    const uint32_t mask = header->capacity - 1;
+
+    uint32_t tail = shared(header->tail).load();
+    bool exited = false;
+    for (;;) {
+        const uint32_t head = shared(header->head).load(std::memory_order_acquire);
+        if (head - tail > header->capacity)
+            throw std::invalid_argument(__FUNCTION__);
+        for (; tail != head; ++tail)
+            decoder.decode(records[tail & mask], sink);
+        // Make room, and wake the parser if it is waiting for it
+        shared(header->tail).store(tail);
+        if (shared(header->producerWaiting).exchange(0))
+            signal(spaceFd);
+        // Nothing more can come once the parser has exited
+        if (exited)
+            return shared(header->closed).load() != 0;
+
+        // Announce the wait, then look again so that records published
+        // by a parser that missed the flag are not left behind
+        shared(header->consumerWaiting).store(1);
+        if (shared(header->head).load() != tail)
+            continue;
+        // The parser publishes its last record before it closes the ring
+        if (shared(header->closed).load()) {
+            if (shared(header->head).load() == tail)
+                return true;
+            continue;
+        }
+        exited = !wait_for_data(hangupFd, log);
+    }
+}
+
+}
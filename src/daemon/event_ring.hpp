@@ -0,0 +1,79 @@
+/**
+ * @file event_ring.hpp
+ * 
+ * Renderer side of the shared memory ring through which a parser
+ * hands over its steps, as described in event_ring.h
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../render/trace_action_sink.hpp"
+
+namespace dmalem {
+
+/**
+ * Shared memory and eventfds of a ring, to be inherited by the ring wrapper
+ * of a parser, which sets the memory up and publishes its steps
+ * 
+ * Unlike the other descriptors of the daemon, those of the ring are not
+ * closed on exec, so a ring should only be used by a process that starts
+ * no other program while the ring is open
+ */
+class event_ring {
+public:
+    /**
+     * Creates the shared memory and the eventfds
+     * 
+     * @throw std::system_error They could not be created
+     */
+    event_ring();
+    event_ring(const event_ring&) = delete;
+    event_ring& operator=(const event_ring&) = delete;
+    /**
+     * Unmaps the memory and closes the descriptors
+     */
+    ~event_ring();
+
+    /**
+     * Arguments that give the ring wrapper the descriptors of the ring
+     */
+    std::vector<std::string> producer_arguments() const;
+
+    /**
+     * Notifies a sink of the steps of the parser until the parser closes the ring
+     * 
+     * @param sink     The sink
+     * @param hangupFd Descriptor that hangs up when the parser exits, such as the read end
+     *                 of its standard output. What the parser writes there goes to @p log
+     * @param log      Stream that receives the output of the parser
+     * @return         Whether the parser closed the ring, rather than exiting without closing it
+     * @throw std::invalid_argument The parser set up or filled the ring wrongly
+     */
+    bool consume(trace_action_sink& sink, int hangupFd, std::ostream& log);
+
+private:
+    /**
+     * Sleeps until the parser signals the data eventfd
+     * 
+     * @return Whether the parser signalled, rather than exiting
+     */
+    bool wait_for_data(int hangupFd, std::ostream& log);
+    /**
+     * Maps the memory, once the parser has sized it
+     * 
+     * @throw std::invalid_argument The memory is too small
+     */
+    void map();
+
+    int memoryFd = -1;
+    int dataFd = -1;
+    int spaceFd = -1;
+    void* memory = nullptr;
+    size_t size = 0;
+};
+
+}
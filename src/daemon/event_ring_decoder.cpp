@@ -0,0 +1,111 @@
+/**
+ * @file event_ring_decoder.cpp
+ * 
+ * Decoding of the records that a parser publishes in shared memory
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include "event_ring_decoder.hpp"
+
+namespace dmalem {
+
+/**
+ * Checks that an array lies within the ring
+ * 
+ * @throw std::invalid_argument It does not
+ */
+static void check_range(size_t offset, size_t count, size_t elementSize, size_t size) {
+    if (offset > size || count > (size - offset) / elementSize)
+        throw std::invalid_argument(__FUNCTION__);
+}
+
+event_ring_decoder::event_ring_decoder(const void* memory, size_t size) {
+    if (size < sizeof(event_ring_header))
+        throw std::invalid_argument(__FUNCTION__);
+    const auto* bytes = static_cast<const char*>(memory);
+    const auto* header = static_cast<const event_ring_header*>(memory);
+    if (header->magic != EVENT_RING_MAGIC || header->version != EVENT_RING_VERSION)
+        throw std::invalid_argument(__FUNCTION__);
+    if (header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0)
+        throw std::invalid_argument(__FUNCTION__);
+    check_range(header->recordsOffset, header->capacity, sizeof(event_ring_record), size);
+    check_range(header->rulesOffset, header->ruleCount, sizeof(event_ring_rule), size);
+    check_range(header->namesOffset, header->namesSize, 1, size);
+    stateCount = header->stateCount;
+
+    // Split the names, symbols first
+    const char* name = bytes + header->namesOffset;
+    const char* const namesEnd = name + header->namesSize;
+    auto next_name = [&]() {
+        const void* terminator = std::memchr(name, '\0', namesEnd - name);
+        if (!terminator)
+            throw std::invalid_argument("event_ring_decoder");
+        std::string_view result(name, static_cast<const char*>(terminator) - name);
+        name += result.size() + 1;
+        return result;
+    };
+    symbols.reserve(header->symbolCount);
+    for (uint32_t i = 0; i < header->symbolCount; ++i)
+        symbols.push_back(next_name());
+
+    const auto* ringRules = reinterpret_cast<const event_ring_rule*>(bytes + header->rulesOffset);
+    rules.reserve(header->ruleCount);
+    for (uint32_t i = 0; i < header->ruleCount; ++i)
+        rules.push_back({
+            .rhsCount = ringRules[i].rhsCount,
+            .lhsName  = symbol(ringRules[i].lhs),
+            .name     = next_name(),
+        });
+}
+
+std::string_view event_ring_decoder::symbol(size_t major) const {
+    if (major >= symbols.size())
+        throw std::invalid_argument(__FUNCTION__);
+    return symbols[major];
+}
+
+void event_ring_decoder::decode(const event_ring_record& r, trace_action_sink& sink) const {
+    switch (r.kind) {
+        case EVENT_RING_INPUT:
+            sink.input_token(symbol(r.major));
+            break;
+        case EVENT_RING_SHIFT:
+        case EVENT_RING_GOTO:
+            // Shifts to values past the states are shifts with pending reduce
+            if (r.value < stateCount)
+                sink.shift(static_cast<int>(r.value));
+            else
+                sink.shift_reduce();
+            break;
+        case EVENT_RING_REDUCE: {
+            if (r.value >= rules.size())
+                throw std::invalid_argument(__FUNCTION__);
+            const rule& reduced = rules[r.value];
+            sink.reduce(reduced.rhsCount, reduced.lhsName, reduced.name);
+            break;
+        }
+        case EVENT_RING_POP:
+            sink.pop();
+            break;
+        case EVENT_RING_DISCARD:
+            sink.discard();
+            break;
+        case EVENT_RING_ERROR:
+            sink.syntax_error();
+            break;
+        case EVENT_RING_ACCEPT:
+            sink.accept();
+            break;
+        case EVENT_RING_FAIL:
+            sink.failure();
+            break;
+        case EVENT_RING_OVERFLOW:
+            sink.stack_overflow();
+            break;
+        default:
+            throw std::invalid_argument(__FUNCTION__);
+    }
+}
+
+}
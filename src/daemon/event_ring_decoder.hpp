@@ -0,0 +1,63 @@
+/**
+ * @file event_ring_decoder.hpp
+ * 
+ * Decoding of the records that a parser publishes in shared memory
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "../render/trace_action_sink.hpp"
+#include "../wrapper/event_ring.h"
+
+namespace dmalem {
+
+/**
+ * Turns the records of the ring of a parser into notifications of a sink,
+ * as @ref default_trace_parser does with the lines of a trace
+ * 
+ * The names are views into the ring, which must outlive the decoder
+ */
+class event_ring_decoder {
+public:
+    /**
+     * Reads the tables of the parser from a ring
+     * 
+     * @param memory Beginning of the ring, once the parser has set it up
+     * @param size   Size of the ring in bytes
+     * @throw std::invalid_argument The ring is not set up, or its tables do not fit in it
+     */
+    event_ring_decoder(const void* memory, size_t size);
+
+    /**
+     * Notifies a sink of a record
+     * 
+     * @param r    The record
+     * @param sink The sink
+     * @throw std::invalid_argument The record is of an unknown kind,
+     *                              or refers to a symbol or rule the parser does not have
+     */
+    void decode(const event_ring_record& r, trace_action_sink& sink) const;
+
+private:
+    struct rule {
+        size_t rhsCount;
+        std::string_view lhsName;
+        std::string_view name;
+    };
+
+    /**
+     * Name of a symbol
+     * 
+     * @throw std::invalid_argument The parser does not have the symbol
+     */
+    std::string_view symbol(size_t major) const;
+
+    std::vector<std::string_view> symbols;
+    std::vector<rule> rules;
+    uint32_t stateCount;
+};
+
+}
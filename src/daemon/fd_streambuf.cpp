@@ -0,0 +1,59 @@
+/**
+ * @file fd_streambuf.cpp
+ * 
+ * Standard streams over POSIX file descriptors, such as sockets and pipes
+ */
+
+#include <cerrno>
+#include <unistd.h>
+#include "fd_streambuf.hpp"
+
+namespace dmalem {
+
+fd_streambuf::fd_streambuf(int fd) : fd(fd) {
+    setg(input.data(), input.data(), input.data());
+    setp(output.data(), output.data() + output.size());
+}
+
+fd_streambuf::~fd_streambuf() {
+    sync();
+}
+
+fd_streambuf::int_type fd_streambuf::underflow() {
+    ssize_t count;
+    do {
+        count = read(fd, input.data(), input.size());
+    } while (count < 0 && errno == EINTR);
+    if (count <= 0)
+        return traits_type::eof();
+    setg(input.data(), input.data(), input.data() + count);
+    return traits_type::to_int_type(input[0]);
+}
+
+fd_streambuf::int_type fd_streambuf::overflow(int_type c) {
+    if (sync() != 0)
+        return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+int fd_streambuf::sync() {
+    const char* begin = pbase();
+    while (begin < pptr()) {
+        const ssize_t count = write(fd, begin, pptr() - begin);
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0) {
+            setp(output.data(), output.data() + output.size());
+            return -1;
+        }
+        begin += count;
+    }
+    setp(output.data(), output.data() + output.size());
+    return 0;
+}
+
+}
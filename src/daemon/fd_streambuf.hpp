@@ -0,0 +1,45 @@
+/**
+ * @file fd_streambuf.hpp
+ * 
+ * Standard streams over POSIX file descriptors, such as sockets and pipes
+ */
+
+#pragma once
+
+#include <array>
+#include <iostream>
+
+namespace dmalem {
+
+/**
+ * Stream buffer that reads from and writes to a file descriptor
+ * 
+ * The descriptor is not closed by the buffer
+ */
+class fd_streambuf : public std::streambuf {
+public:
+    /**
+     * Constructor
+     * 
+     * @param fd Open file descriptor. Must stay open for as long as the buffer is used
+     */
+    explicit fd_streambuf(int fd);
+    /**
+     * Writes what is left in the output buffer
+     */
+    ~fd_streambuf() override;
+
+protected:
+    int_type underflow() override;
+    int_type overflow(int_type c) override;
+    int sync() override;
+
+private:
+    static constexpr size_t bufferSize = 1 << 16;
+
+    int fd;
+    std::array<char, bufferSize> input;
+    std::array<char, bufferSize> output;
+};
+
+}
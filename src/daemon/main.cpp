@@ -0,0 +1,161 @@
+/**
+ * @file main.cpp
+ * 
+ * Entry point of the render daemon, of its client, and of the batch scheduler
+ * 
+ * Usage:
+ * - `daemon serve <socket>` serves requests, with the current directory
+ *   as the root of the repository
+ * - `daemon batch <jobFile> [threads]` runs the jobs of a list, as read by @ref read_jobs,
+ *   with the current directory as the root of the repository
+ * - `daemon request <socket> <grammarFile> [-t target] [-o option]... [-f tokenFile] [-- tokens...]`
+ *   sends a request, and prints its output as `drawmealemon` would.
+ *   As with `drawmealemon`, the end of input is added after the tokens
+ * - `daemon ring [-t target] [-o option]... -- <ringWrapper> [tokenFile]` runs a ring wrapper,
+ *   and renders the steps it publishes in shared memory
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <string_view>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "batch_scheduler.hpp"
+#include "fd_streambuf.hpp"
+#include "parser_cache.hpp"
+#include "parser_run.hpp"
+#include "record_stream.hpp"
+#include "render_request.hpp"
+#include "render_server.hpp"
+#include "../render/argument_parser.hpp"
+
+using namespace dmalem;
+
+static int usage(const char* program) {
+    std::cerr << "Usage: " << program << " serve <socket>\n"
+        << "       " << program << " batch <jobFile> [threads]\n"
+        << "       " << program << " request <socket> <grammarFile> [-t target] [-o option]... [-f tokenFile] [-- tokens...]\n"
+        << "       " << program << " ring [-t target] [-o option]... -- <ringWrapper> [tokenFile]\n";
+    return EXIT_FAILURE;
+}
+
+/**
+ * Sends a request to the daemon, and forwards the records of the response
+ * 
+ * @return Exit status of the request
+ */
+static int send_request(const std::string& socketPath, const render_request& request) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << socketPath << '\n';
+        return EXIT_FAILURE;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Could not connect to the daemon at " << socketPath << ": " << std::strerror(errno) << '\n';
+        return EXIT_FAILURE;
+    }
+
+    int status = EXIT_FAILURE;
+    {
+        fd_streambuf buffer(fd);
+        std::iostream stream(&buffer);
+        write_request(stream, request);
+        record r;
+        bool finished = false;
+        try {
+            while (!finished && read_record(stream, r)) {
+                switch (r.type) {
+                    case record_type::output:
+                        std::cout << r.data << std::flush;
+                        break;
+                    case record_type::log:
+                        std::cerr << r.data << std::flush;
+                        break;
+                    case record_type::exit:
+                        status = std::atoi(r.data.c_str());
+                        finished = true;
+                        break;
+                }
+            }
+        } catch (const std::invalid_argument&) {}
+        if (!finished)
+            std::cerr << "The daemon closed the connection before the end of the response\n";
+    }
+    close(fd);
+    return status;
+}
+
+/**
+ * Runs the jobs of a list
+ * 
+ * @return Exit status of the program
+ */
+static int run_batch(const char* jobFile, size_t threads) {
+    std::ifstream file(jobFile);
+    if (!file) {
+        std::cerr << "Could not read jobs from " << jobFile << '\n';
+        return EXIT_FAILURE;
+    }
+    try {
+        const auto base = std::filesystem::absolute(jobFile).parent_path();
+        const auto jobs = read_jobs(file, base, jobFile);
+        parser_cache cache(std::filesystem::current_path());
+        return batch_scheduler(cache, std::max<size_t>(threads, 1)).run(jobs, std::cerr) ? EXIT_FAILURE : EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
+
+/**
+ * Runs a ring wrapper, with the render target given before `--` and the wrapper after it
+ * 
+ * @return Exit status of the program
+ * @throw argument_parser::error The render target arguments are not valid
+ */
+static int run_ring(const char* program, const std::vector<std::string>& args) {
+    const auto separator = std::ranges::find(args, "--");
+    if (separator == args.end() || separator + 1 == args.end())
+        return usage(program);
+    std::vector<const char*> renderArgs = {"render"};
+    for (auto i = args.begin(); i != separator; ++i)
+        renderArgs.push_back(i->c_str());
+    const auto parsed = argument_parser::parse(renderArgs.size(), renderArgs.data());
+    return render_ring_run({separator + 1, args.end()}, parsed.targetName, parsed.targetOptions, std::cout, std::cerr);
+}
+
+int main(int argc, const char* const* argv) {
+    if (argc == 3 && std::string_view(argv[1]) == "serve") {
+        try {
+            parser_cache cache(std::filesystem::current_path());
+            render_server(cache).serve(argv[2]);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+    if ((argc == 3 || argc == 4) && std::string_view(argv[1]) == "batch")
+        return run_batch(argv[2], argc == 4 ? std::strtoul(argv[3], nullptr, 10) : std::thread::hardware_concurrency());
+    const bool ring = argc >= 2 && std::string_view(argv[1]) == "ring";
+    if (!ring && (argc < 4 || std::string_view(argv[1]) != "request"))
+        return usage(argv[0]);
+    try {
+        if (ring)
+            return run_ring(argv[0], {argv + 2, argv + argc});
+        return send_request(argv[2], request_from_arguments({argv + 3, argv + argc}, std::filesystem::current_path()));
+    } catch (const argument_parser::error& e) {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ * @file parser_cache.cpp
+ * 
+ * Compiled parsers kept by the render daemon between requests
+ */
+
+#include <fstream>
+#include <iterator>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "parser_cache.hpp"
+#include "child_process.hpp"
+
+namespace fs = std::filesystem;
+
+namespace dmalem {
+
+/**
+ * Replaces every occurrence of a placeholder in a template
+ */
+static void fill_in(std::string& text, const std::string& placeholder, const std::string& value) {
+    for (size_t pos = text.find(placeholder); pos != std::string::npos; pos = text.find(placeholder, pos + value.size()))
+        text.replace(pos, placeholder.size(), value);
+}
+
+/**
+ * Runs one step of a build
+ * 
+ * @throw parser_cache::build_error The step failed
+ */
+static void run_step(const std::vector<std::string>& argv) {
+    std::string output;
+    if (run_program(argv, output) != 0)
+        throw parser_cache::build_error(output.empty() ? argv.front() + " failed\n" : output);
+}
+
+parser_cache::build_error::build_error(const std::string& output) : std::runtime_error(output) {}
+
+parser_cache::parser_cache(fs::path root) : root(std::move(root)) {}
+
+fs::path parser_cache::wrapper_for(const fs::path& grammar) {
+    const fs::path path = fs::weakly_canonical(grammar);
+    entry* cached;
+    {
+        std::lock_guard guard(lock);
+        auto& slot = entries[path];
+        if (!slot)
+            slot = std::make_unique<entry>();
+        cached = slot.get();
+    }
+    std::lock_guard guard(cached->lock);
+
+    // Grammars with the same name in different directories must not share outputs
+    std::ostringstream name;
+    name << path.stem().string() << '-' << std::hex << std::setw(16) << std::setfill('0')
+        << std::hash<std::string>()(path.string());
+    const fs::path dir = root / "out" / "parsers" / name.str();
+    const fs::path wrapper = dir / "wrapper";
+
+    bool stale = !fs::exists(wrapper);
+    if (!stale) {
+        const auto built = fs::last_write_time(wrapper);
+        for (const fs::path& source : {
+            path,
+            root / "out" / "lemon",
+            root / "src" / "lemon" / "lempar.c",
+            root / "src" / "wrapper" / "main.c",
+            root / "src" / "wrapper" / "token_file.h",
+            root / "src" / "wrapper" / "trace_filter.h",
+        })
+            stale = stale || fs::last_write_time(source) > built;
+    } else if (!fs::exists(path)) {
+        throw fs::filesystem_error("No such grammar", path, std::make_error_code(std::errc::no_such_file_or_directory));
+    }
+    if (stale)
+        build(path, dir);
+    return wrapper;
+}
+
+void parser_cache::build(const fs::path& grammar, const fs::path& dir) const {
+    fs::create_directories(dir);
+    run_step({
+        (root / "out" / "lemon").string(),
+        grammar.string(),
+        "-d" + dir.string(),
+        "-T" + (root / "src" / "lemon" / "lempar.c").string(),
+    });
+
+    // Same template as the one drawmealemon fills in, but tokens always come from a file
+    std::ifstream templateFile(root / "src" / "wrapper" / "main.c");
+    std::string source{std::istreambuf_iterator<char>(templateFile), std::istreambuf_iterator<char>()};
+    if (!templateFile)
+        throw build_error("Could not read the wrapper template\n");
+    fill_in(source, "%parser%", grammar.stem().string());
+    fill_in(source, "%tokens%", "0");
+    std::ofstream(dir / "wrapper.c") << source;
+
+    // Replace the old wrapper only once the new one is complete
+    run_step({
+        "gcc",
+        "-I" + (root / "src" / "wrapper").string(),
+        (dir / "wrapper.c").string(),
+        "-o",
+        (dir / "wrapper.tmp").string(),
+    });
+    fs::rename(dir / "wrapper.tmp", dir / "wrapper");
+}
+
+}
@@ -0,0 +1,77 @@
+/**
+ * @file parser_cache.hpp
+ * 
+ * Compiled parsers kept by the render daemon between requests
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace dmalem {
+
+/**
+ * Builds the wrapper of each grammar once, and hands it out
+ * for as long as the grammar and the tools it was built with are unchanged
+ * 
+ * Each grammar gets its own directory under `out/parsers`, so that the daemon
+ * does not get in the way of builds made by `drawmealemon`.
+ * Requests for different grammars build in parallel,
+ * and requests for the same grammar wait for a single build
+ */
+class parser_cache {
+public:
+    /**
+     * Exception that signals that Lemon or the C compiler failed on a grammar
+     */
+    class build_error : public std::runtime_error {
+    public:
+        /**
+         * Constructor
+         * 
+         * @param output What the failing tool printed
+         */
+        explicit build_error(const std::string& output);
+    };
+
+    /**
+     * Constructor
+     * 
+     * @param root Directory of the repository, which holds `out/lemon`,
+     *             the Lemon template and the wrapper templates
+     */
+    explicit parser_cache(std::filesystem::path root);
+
+    /**
+     * Finds the wrapper of a grammar, and builds it first if it is missing or out of date
+     * 
+     * @param grammar Absolute path to the grammar file
+     * @return        Path to the executable wrapper, which reads tokens from a file given as argument
+     * @throw build_error The wrapper could not be built
+     * @throw std::filesystem::filesystem_error The grammar file cannot be accessed
+     */
+    std::filesystem::path wrapper_for(const std::filesystem::path& grammar);
+
+private:
+    /**
+     * Cached build of a grammar, locked while it is checked or built
+     */
+    struct entry {
+        std::mutex lock;
+    };
+
+    /**
+     * Builds the wrapper of a grammar in a given directory
+     */
+    void build(const std::filesystem::path& grammar, const std::filesystem::path& dir) const;
+
+    std::filesystem::path root;
+    std::mutex lock;
+    std::map<std::filesystem::path, std::unique_ptr<entry>> entries;
+};
+
+}
@@ -0,0 +1,91 @@
+/**
+ * @file parser_run.cpp
+ * 
+ * Rendering of a run of a compiled parser, shared by the render daemon and the batch scheduler
+ */
+
+#include <string>
+#include "parser_run.hpp"
+#include "child_process.hpp"
+#include "event_ring.hpp"
+#include "fd_streambuf.hpp"
+#include "../render/default_target_factory.hpp"
+#include "../render/default_trace_parser.hpp"
+
+namespace dmalem {
+
+int render_parser_run(
+    const std::filesystem::path& wrapper,
+    const render_request& request,
+    std::ostream& output,
+    std::ostream& log
+) {
+    try {
+        auto targetFactory = default_target_factory(output);
+        auto target = targetFactory.create_by_name(request.targetName, request.targetOptions);
+
+        child_process parser({
+            wrapper.string(),
+            request.tokenFile.empty() ? "/dev/stdin" : request.tokenFile,
+        }, false);
+        parser.drain_errors();
+        std::string tokens;
+        for (int token : request.tokens)
+            tokens += std::to_string(token) + ' ';
+        // The wrapper reads all of its tokens before it starts tracing
+        write_all(parser.input(), tokens);
+        parser.close_input();
+
+        fd_streambuf traceBuffer(parser.output());
+        std::istream trace(&traceBuffer);
+        default_trace_parser().log_to(log).set_target(*target).parse(trace);
+        target->finalize();
+        log << parser.drained_errors();
+        return parser.wait();
+    } catch (const target_factory::bad_render_target_name& e) {
+        log << "Unknown render target: " << e.the_name() << '\n';
+    } catch (const std::exception& e) {
+        log << e.what() << '\n';
+    }
+    return 1;
+}
+
+int render_ring_run(
+    const std::vector<std::string>& wrapperArguments,
+    const std::string& targetName,
+    const std::vector<std::string>& targetOptions,
+    std::ostream& output,
+    std::ostream& log
+) {
+    try {
+        auto targetFactory = default_target_factory(output);
+        auto target = targetFactory.create_by_name(targetName, targetOptions);
+
+        event_ring ring;
+        std::vector<std::string> argv = {wrapperArguments.at(0)};
+        for (auto& argument : ring.producer_arguments())
+            argv.push_back(std::move(argument));
+        argv.insert(argv.end(), wrapperArguments.begin() + 1, wrapperArguments.end());
+        // The standard input of the wrapper stays open while the ring is read,
+        // and its standard output hangs up when it exits
+        child_process parser(argv, false);
+        parser.drain_errors();
+        const bool closed = ring.consume(*target, parser.output(), log);
+        target->finalize();
+        parser.close_input();
+        log << parser.drained_errors();
+        const int status = parser.wait();
+        if (!closed) {
+            log << "The parser exited without closing the ring\n";
+            return status ? status : 1;
+        }
+        return status;
+    } catch (const target_factory::bad_render_target_name& e) {
+        log << "Unknown render target: " << e.the_name() << '\n';
+    } catch (const std::exception& e) {
+        log << e.what() << '\n';
+    }
+    return 1;
+}
+
+}
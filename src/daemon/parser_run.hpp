@@ -0,0 +1,57 @@
+/**
+ * @file parser_run.hpp
+ * 
+ * Rendering of a run of a compiled parser, shared by the render daemon and the batch scheduler
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "render_request.hpp"
+
+namespace dmalem {
+
+/**
+ * Runs the wrapper of a parser on the tokens of a request, and renders its trace
+ * while it is produced
+ * 
+ * Failures are reported to @p log rather than thrown
+ * 
+ * @param wrapper Path to the wrapper, as returned by @ref parser_cache::wrapper_for
+ * @param request The request, whose grammar is ignored
+ * @param output  Stream that receives the rendered output
+ * @param log     Stream that receives the diagnostics
+ * @return        Exit status of the wrapper, or 1 if it could not be run or rendered
+ */
+int render_parser_run(
+    const std::filesystem::path& wrapper,
+    const render_request& request,
+    std::ostream& output,
+    std::ostream& log
+);
+
+/**
+ * Runs a ring wrapper, and renders the steps it publishes in shared memory
+ * 
+ * The arguments of the wrapper are preceded by those that give it the ring.
+ * Failures are reported to @p log rather than thrown
+ * 
+ * @param wrapperArguments Path to the ring wrapper and its own arguments
+ * @param targetName       Name of the render target, empty for the default one
+ * @param targetOptions    Options of the render target
+ * @param output           Stream that receives the rendered output
+ * @param log              Stream that receives the diagnostics
+ * @return                 Exit status of the wrapper, or 1 if it could not be run or rendered
+ */
+int render_ring_run(
+    const std::vector<std::string>& wrapperArguments,
+    const std::string& targetName,
+    const std::vector<std::string>& targetOptions,
+    std::ostream& output,
+    std::ostream& log
+);
+
+}
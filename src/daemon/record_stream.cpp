@@ -0,0 +1,81 @@
+/**
+ * @file record_stream.cpp
+ * 
+ * Framing of the responses of the render daemon
+ */
+
+#include <charconv>
+#include <stdexcept>
+#include "record_stream.hpp"
+
+namespace dmalem {
+
+static bool is_record_type(char c) noexcept {
+    return c == static_cast<char>(record_type::output)
+        || c == static_cast<char>(record_type::log)
+        || c == static_cast<char>(record_type::exit);
+}
+
+void write_record(std::ostream& ostr, record_type type, std::string_view data) {
+    ostr << static_cast<char>(type) << data.size() << '\n';
+    ostr.write(data.data(), static_cast<std::streamsize>(data.size()));
+    ostr.flush();
+}
+
+bool read_record(std::istream& istr, record& value) {
+    const auto type = istr.get();
+    if (type == std::istream::traits_type::eof())
+        return false;
+    std::string header;
+    if (!is_record_type(static_cast<char>(type)) || !std::getline(istr, header))
+        throw std::invalid_argument(__FUNCTION__);
+    size_t length;
+    auto result = std::from_chars(header.data(), header.data() + header.size(), length);
+    if (result.ec != std::errc() || result.ptr != header.data() + header.size())
+        throw std::invalid_argument(__FUNCTION__);
+    value.type = static_cast<record_type>(type);
+    value.data.resize(length);
+    if (!istr.read(value.data.data(), static_cast<std::streamsize>(length)))
+        throw std::invalid_argument(__FUNCTION__);
+    return true;
+}
+
+record_streambuf::record_streambuf(std::ostream& sink, record_type type) : sink(sink), type(type) {}
+
+record_streambuf::~record_streambuf() {
+    sync();
+}
+
+record_streambuf::int_type record_streambuf::overflow(int_type c) {
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+        return traits_type::not_eof(c);
+    buffer.push_back(traits_type::to_char_type(c));
+    if (c == '\n' || buffer.size() >= maxRecordSize)
+        sync();
+    return c;
+}
+
+std::streamsize record_streambuf::xsputn(const char* s, std::streamsize n) {
+    const std::string_view chunk(s, static_cast<size_t>(n));
+    buffer.append(chunk);
+    // Send the complete lines, and keep the start of the last one
+    const size_t end = chunk.rfind('\n');
+    if (end != std::string_view::npos) {
+        const size_t length = buffer.size() - chunk.size() + end + 1;
+        write_record(sink, type, std::string_view(buffer).substr(0, length));
+        buffer.erase(0, length);
+    }
+    if (buffer.size() >= maxRecordSize)
+        sync();
+    return n;
+}
+
+int record_streambuf::sync() {
+    if (!buffer.empty()) {
+        write_record(sink, type, buffer);
+        buffer.clear();
+    }
+    return sink ? 0 : -1;
+}
+
+}
@@ -0,0 +1,99 @@
+/**
+ * @file record_stream.hpp
+ * 
+ * Framing of the responses of the render daemon
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace dmalem {
+
+/**
+ * Kinds of records in a response, which tell the client what to do with their data
+ */
+enum class record_type : char {
+    /**
+     * Rendered output, for the standard output of the client
+     */
+    output = 'O',
+    /**
+     * Diagnostics, for the standard error of the client
+     */
+    log = 'E',
+    /**
+     * Last record of a response, whose data is the decimal exit status of the request
+     */
+    exit = 'X',
+};
+
+/**
+ * Chunk of a response
+ * 
+ * On the wire, a record is its type, the decimal length of its data,
+ * a line break, and then the data itself
+ */
+struct record {
+    record_type type;
+    std::string data;
+};
+
+/**
+ * Writes a record, and flushes the stream so the client sees it right away
+ * 
+ * @param ostr Stream that receives the record
+ * @param type Type of the record
+ * @param data Data of the record
+ */
+void write_record(std::ostream& ostr, record_type type, std::string_view data);
+
+/**
+ * Reads a record
+ * 
+ * @param istr       Stream positioned at the start of a record
+ * @param[out] value Receives the record
+ * @return           Whether a record was read, false at the end of the stream
+ * @throw std::invalid_argument The stream holds a malformed or truncated record
+ */
+bool read_record(std::istream& istr, record& value);
+
+/**
+ * Stream buffer that packs whatever is written to it into records of a given type
+ * 
+ * Records are sent at the end of each line, so the client sees the output
+ * as it is produced, and on flush
+ */
+class record_streambuf : public std::streambuf {
+public:
+    /**
+     * Constructor
+     * 
+     * @param sink Stream that receives the records. Must outlive the buffer
+     * @param type Type of the records
+     */
+    record_streambuf(std::ostream& sink, record_type type);
+    /**
+     * Sends what is left in the buffer
+     */
+    ~record_streambuf() override;
+
+protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char* s, std::streamsize n) override;
+    int sync() override;
+
+private:
+    /**
+     * Size of the buffer past which a record is sent, even within a line
+     */
+    static constexpr size_t maxRecordSize = 1 << 16;
+
+    std::ostream& sink;
+    record_type type;
+    std::string buffer;
+};
+
+}
@@ -0,0 +1,125 @@
+/**
+ * @file render_request.cpp
+ * 
+ * Requests sent to the render daemon
+ */
+
+#include <stdexcept>
+#include <utility>
+#include "render_request.hpp"
+#include "../render/argument_parser.hpp"
+#include "../render/string_reader.hpp"
+
+namespace dmalem {
+
+/**
+ * Writes one line of a request
+ * 
+ * @throw std::invalid_argument The value contains a line break
+ */
+static void write_field(std::ostream& ostr, const char* keyword, const std::string& value) {
+    if (value.find('\n') != std::string::npos)
+        throw std::invalid_argument(__FUNCTION__);
+    ostr << keyword << ' ' << value << '\n';
+}
+
+render_request read_request(std::istream& istr) {
+    render_request request;
+    bool hasGrammar = false, hasTarget = false, hasTokens = false, hasTokenFile = false;
+    std::string line;
+    for (;;) {
+        if (!std::getline(istr, line))
+            throw std::invalid_argument(__FUNCTION__);
+        if (line.empty())
+            break;
+        const size_t space = line.find(' ');
+        const std::string_view keyword = std::string_view(line).substr(0, space);
+        const std::string value = space == std::string::npos ? "" : line.substr(space + 1);
+        bool duplicate = false;
+        if (keyword == "grammar") {
+            duplicate = std::exchange(hasGrammar, true);
+            request.grammarPath = value;
+        } else if (keyword == "target") {
+            duplicate = std::exchange(hasTarget, true);
+            request.targetName = value;
+        } else if (keyword == "option") {
+            request.targetOptions.push_back(value);
+        } else if (keyword == "tokenfile") {
+            duplicate = std::exchange(hasTokenFile, true);
+            request.tokenFile = value;
+        } else if (keyword == "tokens") {
+            duplicate = std::exchange(hasTokens, true);
+            string_reader reader(value);
+            for (reader.take_ws(); !reader.is_done(); reader.take_ws()) {
+                int token;
+                if (!reader.take_int(token))
+                    throw std::invalid_argument(__FUNCTION__);
+                request.tokens.push_back(token);
+            }
+        } else {
+            throw std::invalid_argument(__FUNCTION__);
+        }
+        if (duplicate)
+            throw std::invalid_argument(__FUNCTION__);
+    }
+    if (request.grammarPath.empty())
+        throw std::invalid_argument(__FUNCTION__);
+    return request;
+}
+
+void write_request(std::ostream& ostr, const render_request& request) {
+    write_field(ostr, "grammar", request.grammarPath);
+    if (!request.targetName.empty())
+        write_field(ostr, "target", request.targetName);
+    for (const auto& option : request.targetOptions)
+        write_field(ostr, "option", option);
+    if (!request.tokenFile.empty())
+        write_field(ostr, "tokenfile", request.tokenFile);
+    if (!request.tokens.empty()) {
+        ostr << "tokens";
+        for (int token : request.tokens)
+            ostr << ' ' << token;
+        ostr << '\n';
+    }
+    ostr << '\n';
+    ostr.flush();
+}
+
+render_request request_from_arguments(const std::vector<std::string>& args, const std::filesystem::path& base) {
+    if (args.empty())
+        throw argument_parser::error(argument_parser::error_code::missing_argument, "");
+    render_request request;
+    request.grammarPath = (base / args[0]).lexically_normal().string();
+    // The render target arguments are checked by the parser of the renderer
+    std::vector<const char*> renderArgs = {"render"};
+    size_t i = 1;
+    for (; i < args.size() && args[i] != "--"; ++i) {
+        if (args[i].starts_with("-f")) {
+            std::string path = args[i].substr(2);
+            if (path.empty()) {
+                if (++i >= args.size())
+                    throw argument_parser::error(argument_parser::error_code::missing_argument, args[i - 1].c_str());
+                path = args[i];
+            }
+            request.tokenFile = (base / path).lexically_normal().string();
+        } else {
+            renderArgs.push_back(args[i].c_str());
+        }
+    }
+    auto parsed = argument_parser::parse(renderArgs.size(), renderArgs.data());
+    request.targetName = parsed.targetName;
+    request.targetOptions = parsed.targetOptions;
+    if (request.tokenFile.empty()) {
+        for (++i; i < args.size(); ++i) {
+            string_reader reader(args[i]);
+            int token;
+            if (!reader.take_int(token) || !reader.is_done())
+                throw argument_parser::error(argument_parser::error_code::missing_flag, args[i].c_str());
+            request.tokens.push_back(token);
+        }
+        request.tokens.push_back(0);
+    }
+    return request;
+}
+
+}
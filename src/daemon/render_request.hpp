@@ -0,0 +1,85 @@
+/**
+ * @file render_request.hpp
+ * 
+ * Requests sent to the render daemon
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace dmalem {
+
+/**
+ * Everything the render daemon needs to draw the trace of a parser
+ * 
+ * On the wire, a request is a series of lines, each made of a keyword,
+ * a space and a value, and ends with an empty line:
+ * 
+ *     grammar /abs/path/to/grammar.y
+ *     target ascii
+ *     option some-option
+ *     tokens 1 2 3 0
+ * 
+ * Only `grammar` is required, and only `option` may be repeated
+ */
+struct render_request {
+    /**
+     * Absolute path to the grammar file
+     */
+    std::string grammarPath;
+    /**
+     * Absolute path to a file of tokens, parsed instead of @ref tokens if not empty
+     */
+    std::string tokenFile;
+    /**
+     * Tokens fed to the parser, including the end of input
+     */
+    std::vector<int> tokens;
+    /**
+     * Identifier of the render target, empty for the default one
+     */
+    std::string targetName;
+    /**
+     * Options passed to the render target
+     */
+    std::vector<std::string> targetOptions;
+};
+
+/**
+ * Reads a request
+ * 
+ * @param istr Stream positioned at the start of the request,
+ *             left right after the empty line that ends it
+ * @return     The request
+ * @throw std::invalid_argument The request is malformed or incomplete
+ */
+render_request read_request(std::istream& istr);
+
+/**
+ * Writes a request, in the format read by @ref read_request
+ * 
+ * @param ostr    Stream that receives the request
+ * @param request The request
+ * @throw std::invalid_argument A field of the request does not fit on a single line
+ */
+void write_request(std::ostream& ostr, const render_request& request);
+
+/**
+ * Builds a request from arguments in the format of `drawmealemon`: the grammar file,
+ * then `-t`, `-o` and `-f` flags, then `--` and the tokens
+ * 
+ * As in `drawmealemon`, the end of input is added after the tokens,
+ * and tokens are ignored if a token file is given
+ * 
+ * @param args Arguments, starting with the grammar file
+ * @param base Directory against which relative paths are resolved
+ * @return     The request, with absolute paths
+ * @throw argument_parser::error The arguments are not valid
+ */
+render_request request_from_arguments(const std::vector<std::string>& args, const std::filesystem::path& base);
+
+}
@@ -0,0 +1,89 @@
+/**
+ * @file render_server.cpp
+ * 
+ * Render daemon, which answers render requests over a Unix socket
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <system_error>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "render_server.hpp"
+#include "fd_streambuf.hpp"
+#include "parser_run.hpp"
+#include "record_stream.hpp"
+
+namespace dmalem {
+
+render_server::render_server(parser_cache& cache) : cache(cache) {}
+
+void render_server::serve(const std::string& socketPath) {
+    // A client that goes away must not take the daemon with it
+    std::signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+        throw std::system_error(ENAMETOOLONG, std::generic_category(), socketPath);
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    const int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener < 0)
+        throw std::system_error(errno, std::generic_category(), "socket");
+    unlink(socketPath.c_str());
+    if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        throw std::system_error(errno, std::generic_category(), socketPath);
+    if (listen(listener, SOMAXCONN) != 0)
+        throw std::system_error(errno, std::generic_category(), "listen");
+
+    for (;;) {
+        const int fd = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "accept");
+        }
+        std::thread([this, fd] { handle(fd); }).detach();
+    }
+}
+
+int render_server::render(const render_request& request, std::ostream& ostr) {
+    int status = 1;
+    {
+        record_streambuf outputBuffer(ostr, record_type::output);
+        record_streambuf logBuffer(ostr, record_type::log);
+        std::ostream output(&outputBuffer);
+        std::ostream log(&logBuffer);
+        try {
+            status = render_parser_run(cache.wrapper_for(request.grammarPath), request, output, log);
+        } catch (const parser_cache::build_error& e) {
+            log << e.what();
+        } catch (const std::exception& e) {
+            log << e.what() << '\n';
+        }
+        output.flush();
+        log.flush();
+    }
+    write_record(ostr, record_type::exit, std::to_string(status));
+    return status;
+}
+
+void render_server::handle(int fd) {
+    {
+        fd_streambuf buffer(fd);
+        std::iostream stream(&buffer);
+        try {
+            render(read_request(stream), stream);
+        } catch (const std::invalid_argument&) {
+            write_record(stream, record_type::log, "Malformed request\n");
+            write_record(stream, record_type::exit, "2");
+        }
+    }
+    close(fd);
+}
+
+}
@@ -0,0 +1,58 @@
+/**
+ * @file render_server.hpp
+ * 
+ * Render daemon, which answers render requests over a Unix socket
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include "parser_cache.hpp"
+#include "render_request.hpp"
+
+namespace dmalem {
+
+/**
+ * Accepts connections on a Unix socket, and answers one @ref render_request per connection
+ * 
+ * Each connection is served by its own thread. The response is a series of records,
+ * as written by @ref write_record: the rendered output and the diagnostics,
+ * streamed while the parser runs, and then the exit status
+ */
+class render_server {
+public:
+    /**
+     * Constructor
+     * 
+     * @param cache Cache of compiled parsers. Must outlive the server
+     */
+    explicit render_server(parser_cache& cache);
+
+    /**
+     * Serves connections until the process is stopped
+     * 
+     * @param socketPath Path of the socket, replaced if it already exists
+     * @throw std::system_error The socket could not be set up
+     */
+    [[noreturn]] void serve(const std::string& socketPath);
+
+    /**
+     * Answers a request
+     * 
+     * @param request The request
+     * @param ostr    Stream that receives the records of the response
+     * @return        Exit status of the request, zero on success
+     */
+    int render(const render_request& request, std::ostream& ostr);
+
+private:
+    /**
+     * Reads a request from a connection and answers it, then closes the connection
+     */
+    void handle(int fd);
+
+    parser_cache& cache;
+};
+
+}
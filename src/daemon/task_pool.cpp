@@ -0,0 +1,110 @@
+/**
+ * @file task_pool.cpp
+ * 
+ * Work-stealing pool of threads
+ */
+
+#include <stdexcept>
+#include "task_pool.hpp"
+
+namespace dmalem {
+
+/**
+ * Pool of the current thread, if it belongs to one
+ */
+static thread_local const task_pool* currentPool = nullptr;
+/**
+ * Index of the current thread in its pool
+ */
+static thread_local size_t currentIndex = 0;
+
+task_pool::task_pool(size_t threads) {
+    if (threads == 0)
+        throw std::invalid_argument(__FUNCTION__);
+    for (size_t i = 0; i < threads; ++i)
+        queues.push_back(std::make_unique<queue>());
+    for (size_t i = 0; i < threads; ++i)
+        this->threads.emplace_back(&task_pool::work, this, i);
+}
+
+task_pool::~task_pool() {
+    wait();
+    {
+        std::lock_guard guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void task_pool::submit(task t) {
+    size_t index;
+    {
+        // Count the task before it can be run, so that it cannot finish before it is counted
+        std::lock_guard guard(lock);
+        ++pending;
+        index = currentPool == this ? currentIndex : nextQueue++ % queues.size();
+    }
+    {
+        std::lock_guard guard(queues[index]->lock);
+        queues[index]->tasks.push_back(std::move(t));
+    }
+    {
+        std::lock_guard guard(lock);
+        ++available;
+    }
+    wake.notify_one();
+}
+
+void task_pool::wait() {
+    std::unique_lock guard(lock);
+    idle.wait(guard, [this] { return pending == 0; });
+}
+
+bool task_pool::try_take(size_t self, task& t) {
+    {
+        std::lock_guard guard(queues[self]->lock);
+        if (!queues[self]->tasks.empty()) {
+            t = std::move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues.size(); ++i) {
+        queue& victim = *queues[(self + i) % queues.size()];
+        std::lock_guard guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            t = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void task_pool::work(size_t self) {
+    currentPool = this;
+    currentIndex = self;
+    for (;;) {
+        {
+            std::unique_lock guard(lock);
+            wake.wait(guard, [this] { return available > 0 || stopping; });
+            if (available == 0)
+                return;
+            // Claim one of the queued tasks, which no other thread can take from now on
+            --available;
+        }
+        task t;
+        while (!try_take(self, t))
+            std::this_thread::yield();
+        t();
+        {
+            std::lock_guard guard(lock);
+            if (--pending == 0)
+                idle.notify_all();
+        }
+    }
+}
+
+}
@@ -0,0 +1,92 @@
+/**
+ * @file task_pool.hpp
+ * 
+ * Work-stealing pool of threads
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dmalem {
+
+/**
+ * Runs tasks on a fixed set of threads
+ * 
+ * Each thread has its own queue. Tasks submitted by a task go to the queue
+ * of its thread, which runs the newest ones first, so a task that depends
+ * on another one usually runs right after it. Threads that run out of tasks
+ * steal the oldest ones from the other queues
+ */
+class task_pool {
+public:
+    /**
+     * Task to run, which must not throw
+     */
+    using task = std::function<void()>;
+
+    /**
+     * Constructor
+     * 
+     * @param threads Number of threads, at least 1
+     * @throw std::invalid_argument @p threads is 0
+     */
+    explicit task_pool(size_t threads);
+    task_pool(const task_pool&) = delete;
+    task_pool& operator=(const task_pool&) = delete;
+    /**
+     * Waits for all tasks to finish, and stops the threads
+     */
+    ~task_pool();
+
+    /**
+     * Submits a task, from any thread including those of the pool
+     */
+    void submit(task t);
+    /**
+     * Waits until every task submitted so far, and every task they submit, has finished
+     */
+    void wait();
+
+private:
+    struct queue {
+        std::mutex lock;
+        std::deque<task> tasks;
+    };
+
+    /**
+     * Takes a task from the queue of a thread, or steals one from another queue
+     */
+    bool try_take(size_t self, task& t);
+    /**
+     * Body of each thread
+     */
+    void work(size_t self);
+
+    std::vector<std::unique_ptr<queue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    /**
+     * Number of tasks in the queues not yet claimed by a thread
+     */
+    size_t available = 0;
+    /**
+     * Number of tasks submitted and not finished
+     */
+    size_t pending = 0;
+    /**
+     * Queue that receives the next task submitted from outside the pool
+     */
+    size_t nextQueue = 0;
+    bool stopping = false;
+};
+
+}
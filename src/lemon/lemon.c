@@ -12,6 +12,7 @@
 #include <ctype.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <time.h>
 
 #define ISSPACE(X) isspace((unsigned char)(X))
 #define ISDIGIT(X) isdigit((unsigned char)(X))
@@ -74,6 +75,13 @@ struct MemChunk {
 */
 static MemChunk *memChunkList = 0;
 
+/*
+** Total number of bytes obtained from malloc() by lemon_malloc().  Since
+** lemon_free() does not return memory to the system, this is also the
+** peak size of the heap.
+*/
+static size_t memAllocated = 0;
+
 /*
 ** Wrappers around malloc(), calloc(), realloc() and free().
 **
@@ -98,6 +106,7 @@ static void *lemon_malloc(size_t nByte){
   p->pNext = memChunkList;
   p->sz = nByte;
   memChunkList = p;
+  memAllocated += nByte + sizeof(MemChunk);
   return (void*)&p[1];
 }
 static void *lemon_calloc(size_t nElem, size_t sz){
@@ -135,6 +144,73 @@ static void lemon_free_all(void){
   }
 }
 
+/*
+** Timing of the phases of parser generation, for the -s statistics report.
+**
+** Exactly one phase is current at any time.  phase_enter() charges the
+** wall-clock time and the memory allocated since the previous call to
+** the phase that was current until then, and makes another phase current.
+** A phase may be entered more than once, and its figures accumulate.
+*/
+enum e_phase {
+  PHASE_NONE,            /* Command line handling, statistics report, etc. */
+  PHASE_PARSE,           /* Parse(), other than preprocessing */
+  PHASE_PREPROCESS,      /* preprocess_input() */
+  PHASE_PRECEDENCES,     /* FindRulePrecedences() */
+  PHASE_FIRSTSETS,       /* FindFirstSets() */
+  PHASE_STATES,          /* FindStates() */
+  PHASE_LINKS,           /* FindLinks() */
+  PHASE_FOLLOWSETS,      /* FindFollowSets() */
+  PHASE_ACTIONS,         /* FindActions() */
+  PHASE_COMPRESS,        /* CompressTables() */
+  PHASE_RESORT,          /* ResortStates() */
+  PHASE_REPORTOUTPUT,    /* ReportOutput() */
+  PHASE_REPORTTABLE,     /* ReportTable() and ReportHeader() */
+  PHASE_COUNT            /* Number of phases.  Must be last */
+};
+
+static struct {
+  const char *zLabel;    /* Label of the phase in the statistics report */
+  int nEnter;            /* Number of times the phase was entered */
+  double seconds;        /* Total wall-clock time spent in the phase */
+  size_t nAlloc;         /* Total bytes allocated in the phase */
+} phaseStats[PHASE_COUNT] = {
+  { "other", 0, 0, 0 },
+  { "parsing", 0, 0, 0 },
+  { "preprocessing", 0, 0, 0 },
+  { "FindRulePrecedences", 0, 0, 0 },
+  { "FindFirstSets", 0, 0, 0 },
+  { "FindStates", 0, 0, 0 },
+  { "FindLinks", 0, 0, 0 },
+  { "FindFollowSets", 0, 0, 0 },
+  { "FindActions", 0, 0, 0 },
+  { "CompressTables", 0, 0, 0 },
+  { "ResortStates", 0, 0, 0 },
+  { "ReportOutput", 0, 0, 0 },
+  { "ReportTable", 0, 0, 0 },
+};
+static enum e_phase phaseCurrent = PHASE_NONE;
+static double phaseStart = 0;
+static size_t phaseStartAlloc = 0;
+
+/* Return the current wall-clock time in seconds */
+static double phase_clock(void){
+  struct timespec ts;
+  if( timespec_get(&ts, TIME_UTC)==0 ) return 0;
+  return (double)ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+/* End the current phase and begin the given one */
+static void phase_enter(enum e_phase ePhase){
+  double now = phase_clock();
+  phaseStats[phaseCurrent].seconds += now - phaseStart;
+  phaseStats[phaseCurrent].nAlloc += memAllocated - phaseStartAlloc;
+  phaseStats[ePhase].nEnter++;
+  phaseCurrent = ePhase;
+  phaseStart = now;
+  phaseStartAlloc = memAllocated;
+}
+
 /*
 ** Compilers are starting to complain about the use of sprintf() and strcpy(),
 ** saying they are unsafe.  So we define our own versions of those routines too.
@@ -292,9 +368,10 @@ void Plink_copy(struct plink **, struct plink *);
 void Plink_delete(struct plink *);
 
 /********** From the file "report.h" *************************************/
+struct tables;
 void Reprint(struct lemon *);
 void ReportOutput(struct lemon *);
-void ReportTable(struct lemon *, int, int);
+void ReportTable(struct lemon *, int, int, struct tables *);
 void ReportHeader(struct lemon *);
 void CompressTables(struct lemon *);
 void ResortStates(struct lemon *);
@@ -444,6 +521,26 @@ struct state {
 };
 #define NO_OFFSET (-2147483647)
 
+/* The parser tables that ReportTable() writes, as computed from the
+** states of the automaton.  The -i option saves them, so that they are
+** not recomputed when only the action code of the grammar changes. */
+struct tables {
+  int nstate;              /* Number of states */
+  int nxstate;             /* nstate with tail degenerate states removed */
+  int nconflict;           /* Number of parsing conflicts */
+  int nrule;               /* Number of rules */
+  int nAction;             /* Number of entries in yy_action[] */
+  int *aAction;            /* yy_action[], negative for no action */
+  int nLookahead;          /* Number of entries in yy_lookahead[] */
+  int *aLookahead;         /* yy_lookahead[], negative for no lookahead */
+  int *aTknOfst;           /* iTknOfst of each of the nxstate states */
+  int *aNtOfst;            /* iNtOfst of each of the nxstate states */
+  int *aDfltReduce;        /* iDfltReduce of each of the nxstate states */
+  int mnTknOfst, mxTknOfst;  /* Smallest and largest of aTknOfst[] */
+  int mnNtOfst, mxNtOfst;    /* Smallest and largest of aNtOfst[] */
+  char *aDoesReduce;       /* doesReduce of each rule, by rule number */
+};
+
 /* A followset propagation link indicates that the contents of one
 ** configuration followset should be propagated to another whenever
 ** the first changes. */
@@ -515,14 +612,6 @@ struct lemon {
 
 /**************** From the file "table.h" *********************************/
 /*
-** All code in this file has been automatically generated
-** from a specification in the file
-**              "table.q"
-** by the associative array code building program "aagen".
-** Do not edit this file!  Instead, edit the specification
-** file, then rerun aagen.
-*/
-/*
 ** Code for processing tables in the LEMON parser generator.
 */
 /* Routines for handling a strings */
@@ -1714,8 +1803,10 @@ static struct rule *Rule_sort(struct rule *rp){
   return rp;
 }
 
-/* forward reference */
+/* forward references */
 static const char *minimum_size_type(int lwr, int upr, int *pnByte);
+PRIVATE char *file_makename(struct lemon *, const char *);
+PRIVATE FILE *tplt_open(struct lemon *);
 
 /* Print a single line of the "Parser Stats" output
 */
@@ -1726,6 +1817,272 @@ static void stats_line(const char *zLabel, int iValue){
          iValue);
 }
 
+/* Print the "Phase timings" part of the "Parser Stats" output
+*/
+static void stats_phases(void){
+  int i;
+  double total = 0;
+  phase_enter(PHASE_NONE);
+  printf("Phase timings (wall-clock ms, KB allocated):\n");
+  for(i=1; i<PHASE_COUNT; i++){
+    int nLabel;
+    if( phaseStats[i].nEnter==0 ) continue;
+    nLabel = lemonStrlen(phaseStats[i].zLabel);
+    printf("  %s%.*s %11.3f %9d\n", phaseStats[i].zLabel,
+           29-nLabel, "................................",
+           phaseStats[i].seconds*1000.0, (int)(phaseStats[i].nAlloc/1024));
+    total += phaseStats[i].seconds;
+  }
+  printf("  %s%.*s %11.3f\n", "total", 24,
+         "................................", total*1000.0);
+  stats_line("peak heap size (KB)", (int)(memAllocated/1024));
+}
+
+/*
+** Support for incremental regeneration (the -i option).
+**
+** A fingerprint of everything that the generated files depend on (the
+** grammar, the template and the command-line options that affect the
+** output) is saved in a "*.fp" file next to the outputs, together with
+** the number of parsing conflicts.  When the next run computes the same
+** fingerprint and finds all of the outputs in place, the automaton is not
+** recomputed and no file is touched.  Otherwise, the outputs are staged by
+** file_open_staged() so that those whose content did not change (typically
+** the "*.h" and "*.out" files after an edit to the action code) keep their
+** modification times.
+**
+** A second fingerprint covers only what the automaton depends on: the
+** symbols, the rules without their action code, the precedences, the
+** start symbol and the options.  The parser tables are saved next to it
+** in a "*.lalr" file, so that when only the action code changed, the
+** tables are reused instead of computing the automaton again, and the
+** "*.out" report, which does not show the action code, is left alone.
+*/
+typedef unsigned long long fingerprint_t;
+
+/* Fold the content of an open stream into a 64-bit FNV-1a hash */
+static fingerprint_t fingerprint_stream(fingerprint_t h, FILE *in){
+  int c;
+  while( (c = getc(in))!=EOF ){
+    h ^= (unsigned char)c;
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+/* Fold a zero-terminated string (including the terminator) into a hash */
+static fingerprint_t fingerprint_str(fingerprint_t h, const char *z){
+  do{
+    h ^= (unsigned char)*z;
+    h *= 0x100000001b3ULL;
+  }while( *(z++) );
+  return h;
+}
+
+/* Fold an integer into a hash */
+static fingerprint_t fingerprint_int(fingerprint_t h, int v){
+  char zBuf[20];
+  lemon_sprintf(zBuf, "%d", v);
+  return fingerprint_str(h, zBuf);
+}
+
+/* Fold a symbol, by name, into a hash.  A null symbol has no name. */
+static fingerprint_t fingerprint_sym(fingerprint_t h, struct symbol *sp){
+  int i;
+  if( sp==0 ) return fingerprint_str(h, "");
+  h = fingerprint_str(h, sp->name);
+  h = fingerprint_int(h, sp->nsubsym);
+  for(i=0; i<sp->nsubsym; i++) h = fingerprint_str(h, sp->subsym[i]->name);
+  return h;
+}
+
+/* Compute the fingerprint of what the automaton and the "*.out" report
+** depend on, once the grammar is parsed and its rules are numbered.
+** The action code of the rules is left out, but not whether they have
+** any, which decides their numbers. */
+static fingerprint_t fingerprint_automaton(
+  struct lemon *lemp,
+  const char *zOptions
+){
+  fingerprint_t h = 0xcbf29ce484222325ULL;
+  struct rule *rp;
+  int i;
+
+  h = fingerprint_str(h, zOptions);
+  h = fingerprint_int(h, lemp->nterminal);
+  h = fingerprint_int(h, lemp->nsymbol);
+  h = fingerprint_str(h, lemp->start ? lemp->start : "");
+  h = fingerprint_int(h, lemp->startRule->iRule);
+  h = fingerprint_sym(h, lemp->wildcard);
+  for(i=0; i<lemp->nsymbol; i++){
+    struct symbol *sp = lemp->symbols[i];
+    h = fingerprint_sym(h, sp);
+    h = fingerprint_int(h, sp->type);
+    h = fingerprint_int(h, sp->prec);
+    h = fingerprint_int(h, sp->assoc);
+    h = fingerprint_int(h, sp->bContent);
+    h = fingerprint_sym(h, sp->fallback);
+  }
+  for(rp=lemp->rule; rp; rp=rp->next){
+    h = fingerprint_int(h, rp->iRule);
+    h = fingerprint_sym(h, rp->lhs);
+    h = fingerprint_int(h, rp->nrhs);
+    for(i=0; i<rp->nrhs; i++) h = fingerprint_sym(h, rp->rhs[i]);
+    h = fingerprint_sym(h, rp->precsym);
+    h = fingerprint_int(h, rp->noCode);
+    h = fingerprint_int(h, rp->neverReduce);
+  }
+  return h ? h : 1;
+}
+
+/* Compute the fingerprint of the inputs of the generator.  zOptions
+** describes the command-line options that affect the outputs.  Return
+** 0 if some input cannot be read. */
+static fingerprint_t fingerprint_inputs(struct lemon *lemp, const char *zOptions){
+  fingerprint_t h = 0xcbf29ce484222325ULL;
+  FILE *in;
+  int i;
+
+  h = fingerprint_str(h, zOptions);
+  for(i=0; i<nDefine; i++) h = fingerprint_str(h, azDefine[i]);
+  in = fopen(lemp->filename, "rb");
+  if( in==0 ) return 0;
+  h = fingerprint_stream(h, in);
+  fclose(in);
+  in = tplt_open(lemp);
+  if( in==0 ) return 0;
+  h = fingerprint_stream(h, in);
+  fclose(in);
+  return h ? h : 1;
+}
+
+/* Return TRUE if an output file with the given suffix exists */
+static int fingerprint_output_exists(struct lemon *lemp, const char *suffix){
+  char *name = file_makename(lemp, suffix);
+  int exists = access(name, 0)==0;
+  lemon_free(name);
+  return exists;
+}
+
+/* Read the fingerprint saved by the previous run.  Return 0 if there
+** is none.  The number of conflicts of that run is written to *pnConflict */
+static fingerprint_t fingerprint_load(struct lemon *lemp, int *pnConflict){
+  fingerprint_t h = 0;
+  char *name = file_makename(lemp, ".fp");
+  FILE *in = fopen(name, "rb");
+  if( in ){
+    if( fscanf(in, "%llx %d", &h, pnConflict)!=2 ) h = 0;
+    fclose(in);
+  }
+  lemon_free(name);
+  return h;
+}
+
+/* Save the fingerprint of this run, or remove a stale one if h is 0 */
+static void fingerprint_save(struct lemon *lemp, fingerprint_t h){
+  char *name = file_makename(lemp, ".fp");
+  FILE *out;
+  remove(name);
+  if( h ){
+    out = fopen(name, "wb");
+    if( out ){
+      fprintf(out, "%016llx %d\n", h, lemp->nconflict);
+      fclose(out);
+    }
+  }
+  lemon_free(name);
+}
+
+/* Write an array of integers to a "*.lalr" file, one line per array */
+static void tables_write(FILE *out, const int *a, int n){
+  int i;
+  for(i=0; i<n; i++) fprintf(out, "%s%d", i ? " " : "", a[i]);
+  fprintf(out, "\n");
+}
+
+/* Read an array of integers written by tables_write().  Return FALSE
+** if they cannot be read. */
+static int tables_read(FILE *in, int *a, int n){
+  int i;
+  for(i=0; i<n; i++){
+    if( fscanf(in, "%d", &a[i])!=1 ) return LEMON_FALSE;
+  }
+  return LEMON_TRUE;
+}
+
+/* Save the parser tables computed for the automaton with fingerprint h,
+** or remove stale ones if h is 0 */
+static void tables_save(struct lemon *lemp, fingerprint_t h, struct tables *t){
+  char *name = file_makename(lemp, ".lalr");
+  FILE *out;
+  int i;
+  remove(name);
+  if( h && t->aAction ){
+    out = fopen(name, "wb");
+    if( out ){
+      fprintf(out, "%016llx %d %d %d %d %d %d %d %d %d %d\n", h,
+              t->nstate, t->nxstate, t->nconflict, t->nrule,
+              t->nAction, t->nLookahead, t->mnTknOfst, t->mxTknOfst,
+              t->mnNtOfst, t->mxNtOfst);
+      tables_write(out, t->aAction, t->nAction);
+      tables_write(out, t->aLookahead, t->nLookahead);
+      tables_write(out, t->aTknOfst, t->nxstate);
+      tables_write(out, t->aNtOfst, t->nxstate);
+      tables_write(out, t->aDfltReduce, t->nxstate);
+      for(i=0; i<t->nrule; i++) fprintf(out, "%d", t->aDoesReduce[i]);
+      fprintf(out, "\n");
+      fclose(out);
+    }
+  }
+  lemon_free(name);
+}
+
+/* Load the parser tables saved for the automaton with fingerprint h.
+** Return FALSE, with t left empty, if there are none. */
+static int tables_load(struct lemon *lemp, fingerprint_t h, struct tables *t){
+  char *name = file_makename(lemp, ".lalr");
+  FILE *in = fopen(name, "rb");
+  fingerprint_t hSaved = 0;
+  int ok = LEMON_FALSE;
+  int i, c = 0;
+
+  lemon_free(name);
+  memset(t, 0, sizeof(*t));
+  if( in==0 ) return LEMON_FALSE;
+  if( fscanf(in, "%llx %d %d %d %d %d %d %d %d %d %d", &hSaved,
+             &t->nstate, &t->nxstate, &t->nconflict, &t->nrule,
+             &t->nAction, &t->nLookahead, &t->mnTknOfst, &t->mxTknOfst,
+             &t->mnNtOfst, &t->mxNtOfst)==11
+   && hSaved==h && t->nrule==lemp->nrule
+   && t->nxstate>0 && t->nxstate<=t->nstate
+   && t->nAction>=0 && t->nLookahead>=0
+  ){
+    t->aAction = (int *) lemon_calloc(t->nAction+1, sizeof(int));
+    t->aLookahead = (int *) lemon_calloc(t->nLookahead+1, sizeof(int));
+    t->aTknOfst = (int *) lemon_calloc(t->nxstate+1, sizeof(int));
+    t->aNtOfst = (int *) lemon_calloc(t->nxstate+1, sizeof(int));
+    t->aDfltReduce = (int *) lemon_calloc(t->nxstate+1, sizeof(int));
+    t->aDoesReduce = (char *) lemon_calloc(t->nrule+1, sizeof(char));
+    ok = tables_read(in, t->aAction, t->nAction)
+      && tables_read(in, t->aLookahead, t->nLookahead)
+      && tables_read(in, t->aTknOfst, t->nxstate)
+      && tables_read(in, t->aNtOfst, t->nxstate)
+      && tables_read(in, t->aDfltReduce, t->nxstate);
+    while( ok && (c = getc(in))!=EOF && ISSPACE(c) ){}
+    for(i=0; ok && i<t->nrule; i++){
+      if( c!='0' && c!='1' ){
+        ok = LEMON_FALSE;
+      }else{
+        t->aDoesReduce[i] = (char)(c - '0');
+        c = getc(in);
+      }
+    }
+  }
+  fclose(in);
+  if( !ok ) memset(t, 0, sizeof(*t));
+  return ok;
+}
+
 /*
 ** Comparison function used by qsort() to sort the azDefine[] array.
 */
@@ -1748,6 +2105,7 @@ int main(int argc, char **argv){
   static int noResort = 0;
   static int sqlFlag = 0;
   static int printPP = 0;
+  static int incremental = 0;
   
   static struct s_options options[] = {
     {OPT_FLAG, "b", (char*)&basisflag, "Print only the basis in report."},
@@ -1757,6 +2115,8 @@ int main(int argc, char **argv){
     {OPT_FLAG, "E", (char*)&printPP, "Print input file after preprocessing."},
     {OPT_FSTR, "f", 0, "Ignored.  (Placeholder for -f compiler options.)"},
     {OPT_FLAG, "g", (char*)&rpflag, "Print grammar without actions."},
+    {OPT_FLAG, "i", (char*)&incremental,
+                    "Skip regeneration if no input has changed."},
     {OPT_FSTR, "I", 0, "Ignored.  (Placeholder for '-I' compiler options.)"},
     {OPT_FLAG, "m", (char*)&mhflag, "Output a makeheaders compatible file."},
     {OPT_FLAG, "l", (char*)&nolinenosflag, "Do not print #line statements."},
@@ -1779,6 +2139,10 @@ int main(int argc, char **argv){
   int exitcode;
   struct lemon lem;
   struct rule *rp;
+  fingerprint_t fingerprint = 0;
+  fingerprint_t automaton = 0;
+  char zOptions[100];
+  struct tables tables;
 
   OptInit(argv,options,stderr);
   if( version ){
@@ -1789,6 +2153,7 @@ int main(int argc, char **argv){
     fprintf(stderr,"Exactly one filename argument is required.\n");
     exit(1);
   }
+  phase_enter(PHASE_NONE);
   memset(&lem, 0, sizeof(lem));
   lem.errorcnt = 0;
   qsort(azDefine, nDefine, sizeof(azDefine[0]), defineCmp);
@@ -1803,9 +2168,41 @@ int main(int argc, char **argv){
   lem.basisflag = basisflag;
   lem.nolinenosflag = nolinenosflag;
   lem.printPreprocessed = printPP;
+
+  /* Skip everything if the outputs of a previous run are still current.
+  ** Statistics are not saved, so they always need a full run. */
+  if( incremental && !rpflag && !printPP ){
+    int nConflict = 0;
+    /* Every flag counts, except those that cannot change the outputs, so
+    ** that flags added later never reuse outputs made without them */
+    zOptions[0] = 0;
+    for(i=0; options[i].label; i++){
+      if( options[i].type==OPT_FLAG && strchr("Egisx", options[i].label[0])==0 ){
+        lemon_sprintf(&zOptions[lemonStrlen(zOptions)], "%s%d",
+                      options[i].label, *(int*)options[i].arg);
+      }
+    }
+    if( user_templatename ) lemon_strcat(zOptions, "T");
+    fingerprint = fingerprint_inputs(&lem, zOptions);
+    lem.errorcnt = 0;
+    if( fingerprint && !statistics
+     && fingerprint==fingerprint_load(&lem, &nConflict)
+     && fingerprint_output_exists(&lem, ".c")
+     && (mhflag || fingerprint_output_exists(&lem, ".h"))
+     && (quiet || fingerprint_output_exists(&lem, ".out"))
+     && (!sqlFlag || fingerprint_output_exists(&lem, ".sql"))
+    ){
+      if( nConflict > 0 ){
+        fprintf(stderr,"%d parsing conflicts.\n",nConflict);
+      }
+      lemon_free_all();
+      exit(nConflict > 0 ? 1 : 0);
+    }
+  }
   Symbol_new("$");
 
   /* Parse the input file */
+  phase_enter(PHASE_PARSE);
   Parse(&lem);
   if( lem.printPreprocessed || lem.errorcnt ) exit(lem.errorcnt);
   if( lem.nrule==0 ){
@@ -1845,49 +2242,87 @@ int main(int argc, char **argv){
   if( rpflag ){
     Reprint(&lem);
   }else{
-    /* Initialize the size for all follow and first sets */
-    SetSize(lem.nterminal+1);
-
-    /* Find the precedence for every production rule (that has one) */
-    FindRulePrecedences(&lem);
-
-    /* Compute the lambda-nonterminals and the first-sets for every
-    ** nonterminal */
-    FindFirstSets(&lem);
-
-    /* Compute all LR(0) states.  Also record follow-set propagation
-    ** links so that the follow-set can be computed later */
-    lem.nstate = 0;
-    FindStates(&lem);
-    lem.sorted = State_arrayof();
-
-    /* Tie up loose ends on the propagation links */
-    FindLinks(&lem);
-
-    /* Compute the follow set of every reducible configuration */
-    FindFollowSets(&lem);
-
-    /* Compute the action tables */
-    FindActions(&lem);
-
-    /* Compress the action tables */
-    if( compress==0 ) CompressTables(&lem);
+    /* Reuse the tables of the previous run if the automaton is the same,
+    ** as after an edit to the action code only */
+    memset(&tables, 0, sizeof(tables));
+    if( fingerprint ){
+      automaton = fingerprint_automaton(&lem, zOptions);
+      if( !statistics && (quiet || fingerprint_output_exists(&lem, ".out")) ){
+        tables_load(&lem, automaton, &tables);
+      }
+    }
+    if( tables.aAction ){
+      lem.nstate = tables.nstate;
+      lem.nxstate = tables.nxstate;
+      lem.nconflict = tables.nconflict;
+    }else{
+      /* Initialize the size for all follow and first sets */
+      SetSize(lem.nterminal+1);
+
+      /* Find the precedence for every production rule (that has one) */
+      phase_enter(PHASE_PRECEDENCES);
+      FindRulePrecedences(&lem);
+
+      /* Compute the lambda-nonterminals and the first-sets for every
+      ** nonterminal */
+      phase_enter(PHASE_FIRSTSETS);
+      FindFirstSets(&lem);
+
+      /* Compute all LR(0) states.  Also record follow-set propagation
+      ** links so that the follow-set can be computed later */
+      phase_enter(PHASE_STATES);
+      lem.nstate = 0;
+      FindStates(&lem);
+      lem.sorted = State_arrayof();
+
+      /* Tie up loose ends on the propagation links */
+      phase_enter(PHASE_LINKS);
+      FindLinks(&lem);
+
+      /* Compute the follow set of every reducible configuration */
+      phase_enter(PHASE_FOLLOWSETS);
+      FindFollowSets(&lem);
+
+      /* Compute the action tables */
+      phase_enter(PHASE_ACTIONS);
+      FindActions(&lem);
+
+      /* Compress the action tables */
+      if( compress==0 ){
+        phase_enter(PHASE_COMPRESS);
+        CompressTables(&lem);
+      }
 
-    /* Reorder and renumber the states so that states with fewer choices
-    ** occur at the end.  This is an optimization that helps make the
-    ** generated parser tables smaller. */
-    if( noResort==0 ) ResortStates(&lem);
+      /* Reorder and renumber the states so that states with fewer choices
+      ** occur at the end.  This is an optimization that helps make the
+      ** generated parser tables smaller. */
+      if( noResort==0 ){
+        phase_enter(PHASE_RESORT);
+        ResortStates(&lem);
+      }
 
-    /* Generate a report of the parser generated.  (the "y.output" file) */
-    if( !quiet ) ReportOutput(&lem);
+      /* Generate a report of the parser generated.  (the "y.output" file) */
+      if( !quiet ){
+        phase_enter(PHASE_REPORTOUTPUT);
+        ReportOutput(&lem);
+      }
+    }
 
     /* Generate the source code for the parser */
-    ReportTable(&lem, mhflag, sqlFlag);
+    phase_enter(PHASE_REPORTTABLE);
+    ReportTable(&lem, mhflag, sqlFlag, &tables);
 
     /* Produce a header file for use by the scanner.  (This step is
     ** omitted if the "-m" option is used because makeheaders will
     ** generate the file for us.) */
     if( !mhflag ) ReportHeader(&lem);
+
+    /* Remember the inputs that produced the outputs */
+    if( incremental && fingerprint ){
+      fingerprint_save(&lem, lem.errorcnt ? 0 : fingerprint);
+      tables_save(&lem, lem.errorcnt ? 0 : automaton, &tables);
+    }
+    phase_enter(PHASE_NONE);
   }
   if( statistics ){
     printf("Parser statistics:\n");
@@ -1900,6 +2335,7 @@ int main(int argc, char **argv){
     stats_line("action table entries", lem.nactiontab);
     stats_line("lookahead table entries", lem.nlookaheadtab);
     stats_line("total table size (bytes)", lem.tablesize);
+    stats_phases();
   }
   if( lem.nconflict > 0 ){
     fprintf(stderr,"%d parsing conflicts.\n",lem.nconflict);
@@ -3123,7 +3559,9 @@ void Parse(struct lemon *gp)
   filebuf[filesize] = 0;
 
   /* Make an initial pass through the file to handle %ifdef and %ifndef */
+  phase_enter(PHASE_PREPROCESS);
   preprocess_input(filebuf);
+  phase_enter(PHASE_PARSE);
   if( gp->printPreprocessed ){
     printf("%s\n", filebuf);
     return;
@@ -3352,6 +3790,85 @@ PRIVATE FILE *file_open(
   return fp;
 }
 
+/* Generate the name of the temporary file in which an output file
+** is staged by file_open_staged() */
+PRIVATE char *file_stagedname(const char *name)
+{
+  char *staged = (char*)lemon_malloc( lemonStrlen(name)+5 );
+  if( staged==0 ){
+    fprintf(stderr,"Can't allocate space for a filename.\n");
+    exit(1);
+  }
+  lemon_strcpy(staged, name);
+  lemon_strcat(staged, ".tmp");
+  return staged;
+}
+
+/* Open an output file like file_open() does for writing, except that
+** the output is written to a temporary file next to the real one.
+** The name of the real file is written into *pzName, and the stream
+** must be closed with file_commit() to move the output in place. */
+PRIVATE FILE *file_open_staged(
+  struct lemon *lemp,
+  const char *suffix,
+  char **pzName
+){
+  FILE *fp;
+  char *staged;
+
+  if( lemp->outname ) lemon_free(lemp->outname);
+  lemp->outname = file_makename(lemp, suffix);
+  *pzName = file_makename(lemp, suffix);
+  staged = file_stagedname(*pzName);
+  fp = fopen(staged,"wb");
+  if( fp==0 ){
+    fprintf(stderr,"Can't open file \"%s\".\n",staged);
+    lemp->errorcnt++;
+  }
+  lemon_free(staged);
+  return fp;
+}
+
+/* Return TRUE if the two files exist and have the same content */
+PRIVATE int file_same_content(const char *zA, const char *zB)
+{
+  char bufA[4096], bufB[4096];
+  size_t nA, nB;
+  int same = 0;
+  FILE *a = fopen(zA,"rb");
+  FILE *b = fopen(zB,"rb");
+  if( a && b ){
+    do{
+      nA = fread(bufA, 1, sizeof(bufA), a);
+      nB = fread(bufB, 1, sizeof(bufB), b);
+      same = nA==nB && memcmp(bufA, bufB, nA)==0;
+    }while( same && nA>0 );
+  }
+  if( a ) fclose(a);
+  if( b ) fclose(b);
+  return same;
+}
+
+/* Close a stream opened by file_open_staged().  The real output file
+** is only replaced if its content has changed, so that its modification
+** time stays the same and anything built from it is not rebuilt. */
+PRIVATE void file_commit(struct lemon *lemp, FILE *fp, char *name)
+{
+  char *staged = file_stagedname(name);
+  fclose(fp);
+  if( file_same_content(staged, name) ){
+    remove(staged);
+  }else{
+    remove(name);
+    if( rename(staged, name)!=0 ){
+      fprintf(stderr,"Can't rename \"%s\" to \"%s\".\n",staged,name);
+      lemp->errorcnt++;
+    }
+  }
+  lemon_free(staged);
+  lemon_free(name);
+}
+
 /* Print the text of a rule
 */
 void rule_print(FILE *out, struct rule *rp){
@@ -3548,8 +4065,9 @@ void ReportOutput(struct lemon *lemp)
   struct action *ap;
   struct rule *rp;
   FILE *fp;
+  char *name;
 
-  fp = file_open(lemp,".out","wb");
+  fp = file_open_staged(lemp,".out",&name);
   if( fp==0 ) return;
   for(i=0; i<lemp->nxstate; i++){
     stp = lemp->sorted[i];
@@ -3635,7 +4153,7 @@ void ReportOutput(struct lemon *lemp)
     }
     fprintf(fp,"\n");
   }
-  fclose(fp);
+  file_commit(lemp, fp, name);
   return;
 }
 
@@ -4408,27 +4926,132 @@ static void writeRuleText(FILE *out, struct rule *rp){
 }
 
 
+/*
+** Compute the parser tables of ReportTable() from the states of the
+** automaton, which must be complete.  The action values of lemp must
+** be set.
+*/
+PRIVATE void ComputeTables(struct lemon *lemp, struct tables *t){
+  struct state *stp;
+  struct action *ap;
+  struct acttab *pActtab;
+  struct axset *ax;
+  int i;
+
+  ax = (struct axset *) lemon_calloc(lemp->nxstate*2, sizeof(ax[0]));
+  if( ax==0 ){
+    fprintf(stderr,"malloc failed\n");
+    exit(1);
+  }
+  for(i=0; i<lemp->nxstate; i++){
+    stp = lemp->sorted[i];
+    ax[i*2].stp = stp;
+    ax[i*2].isTkn = 1;
+    ax[i*2].nAction = stp->nTknAct;
+    ax[i*2+1].stp = stp;
+    ax[i*2+1].isTkn = 0;
+    ax[i*2+1].nAction = stp->nNtAct;
+  }
+  t->mxTknOfst = t->mnTknOfst = 0;
+  t->mxNtOfst = t->mnNtOfst = 0;
+  /* In an effort to minimize the action table size, use the heuristic
+  ** of placing the largest action sets first */
+  for(i=0; i<lemp->nxstate*2; i++) ax[i].iOrder = i;
+  qsort(ax, lemp->nxstate*2, sizeof(ax[0]), axset_compare);
+  pActtab = acttab_alloc(lemp->nsymbol, lemp->nterminal);
+  for(i=0; i<lemp->nxstate*2 && ax[i].nAction>0; i++){
+    stp = ax[i].stp;
+    if( ax[i].isTkn ){
+      for(ap=stp->ap; ap; ap=ap->next){
+        int action;
+        if( ap->sp->index>=lemp->nterminal ) continue;
+        action = compute_action(lemp, ap);
+        if( action<0 ) continue;
+        acttab_action(pActtab, ap->sp->index, action);
+      }
+      stp->iTknOfst = acttab_insert(pActtab, 1);
+      if( stp->iTknOfst<t->mnTknOfst ) t->mnTknOfst = stp->iTknOfst;
+      if( stp->iTknOfst>t->mxTknOfst ) t->mxTknOfst = stp->iTknOfst;
+    }else{
+      for(ap=stp->ap; ap; ap=ap->next){
+        int action;
+        if( ap->sp->index<lemp->nterminal ) continue;
+        if( ap->sp->index==lemp->nsymbol ) continue;
+        action = compute_action(lemp, ap);
+        if( action<0 ) continue;
+        acttab_action(pActtab, ap->sp->index, action);
+      }
+      stp->iNtOfst = acttab_insert(pActtab, 0);
+      if( stp->iNtOfst<t->mnNtOfst ) t->mnNtOfst = stp->iNtOfst;
+      if( stp->iNtOfst>t->mxNtOfst ) t->mxNtOfst = stp->iNtOfst;
+    }
+#if 0  /* Uncomment for a trace of how the yy_action[] table fills out */
+    { int jj, nn;
+      for(jj=nn=0; jj<pActtab->nAction; jj++){
+        if( pActtab->aAction[jj].action<0 ) nn++;
+      }
+      printf("%4d: State %3d %s n: %2d size: %5d freespace: %d\n",
+             i, stp->statenum, ax[i].isTkn ? "Token" : "Var  ",
+             ax[i].nAction, pActtab->nAction, nn);
+    }
+#endif
+  }
+  lemon_free(ax);
+
+  /* Mark rules that are actually used for reduce actions after all
+  ** optimizations have been applied
+  */
+  t->aDoesReduce = (char *) lemon_calloc(lemp->nrule+1, sizeof(char));
+  for(i=0; i<lemp->nxstate; i++){
+    for(ap=lemp->sorted[i]->ap; ap; ap=ap->next){
+      if( ap->type==REDUCE || ap->type==SHIFTREDUCE ){
+        t->aDoesReduce[ap->x.rp->iRule] = 1;
+      }
+    }
+  }
+
+  /* Copy out the tables, with the offsets of the states */
+  t->nstate = lemp->nstate;
+  t->nxstate = lemp->nxstate;
+  t->nconflict = lemp->nconflict;
+  t->nrule = lemp->nrule;
+  t->nAction = acttab_action_size(pActtab);
+  t->aAction = (int *) lemon_calloc(t->nAction+1, sizeof(int));
+  for(i=0; i<t->nAction; i++) t->aAction[i] = acttab_yyaction(pActtab, i);
+  t->nLookahead = acttab_lookahead_size(pActtab);
+  t->aLookahead = (int *) lemon_calloc(t->nLookahead+1, sizeof(int));
+  for(i=0; i<t->nLookahead; i++){
+    t->aLookahead[i] = acttab_yylookahead(pActtab, i);
+  }
+  t->aTknOfst = (int *) lemon_calloc(lemp->nxstate+1, sizeof(int));
+  t->aNtOfst = (int *) lemon_calloc(lemp->nxstate+1, sizeof(int));
+  t->aDfltReduce = (int *) lemon_calloc(lemp->nxstate+1, sizeof(int));
+  for(i=0; i<lemp->nxstate; i++){
+    stp = lemp->sorted[i];
+    t->aTknOfst[i] = stp->iTknOfst;
+    t->aNtOfst[i] = stp->iNtOfst;
+    t->aDfltReduce[i] = stp->iDfltReduce;
+  }
+  acttab_free(pActtab);
+}
+
 /* Generate C source code for the parser */
 void ReportTable(
   struct lemon *lemp,
   int mhflag,     /* Output in makeheaders format if true */
-  int sqlFlag     /* Generate the *.sql file too */
+  int sqlFlag,    /* Generate the *.sql file too */
+  struct tables *t /* The tables, computed here unless reused by -i */
 ){
   FILE *out, *in, *sql;
   int  lineno;
-  struct state *stp;
-  struct action *ap;
   struct rule *rp;
-  struct acttab *pActtab;
   int i, j, n, sz, mn, mx;
   int nLookAhead;
   int szActionType;     /* sizeof(YYACTIONTYPE) */
   int szCodeType;       /* sizeof(YYCODETYPE)   */
   const char *name;
-  int mnTknOfst, mxTknOfst;
-  int mnNtOfst, mxNtOfst;
-  struct axset *ax;
   char *prefix;
+  char *outName, *sqlName;
 
   lemp->minShiftReduce = lemp->nstate;
   lemp->errAction = lemp->minShiftReduce + lemp->nrule;
@@ -4439,7 +5062,7 @@ void ReportTable(
 
   in = tplt_open(lemp);
   if( in==0 ) return;
-  out = file_open(lemp,".c","wb");
+  out = file_open_staged(lemp,".c",&outName);
   if( out==0 ){
     fclose(in);
     return;
@@ -4447,10 +5070,10 @@ void ReportTable(
   if( sqlFlag==0 ){
     sql = 0;
   }else{
-    sql = file_open(lemp, ".sql", "wb");
+    sql = file_open_staged(lemp, ".sql", &sqlName);
     if( sql==0 ){
       fclose(in);
-      fclose(out);
+      file_commit(lemp, out, outName);
       return;
     }
     fprintf(sql,
@@ -4658,78 +5281,16 @@ void ReportTable(
 
   /* Compute the action table, but do not output it yet.  The action
   ** table must be computed before generating the YYNSTATE macro because
-  ** we need to know how many states can be eliminated.
+  ** we need to know how many states can be eliminated.  Tables reused
+  ** by the -i option are already there.
   */
-  ax = (struct axset *) lemon_calloc(lemp->nxstate*2, sizeof(ax[0]));
-  if( ax==0 ){
-    fprintf(stderr,"malloc failed\n");
-    exit(1);
-  }
-  for(i=0; i<lemp->nxstate; i++){
-    stp = lemp->sorted[i];
-    ax[i*2].stp = stp;
-    ax[i*2].isTkn = 1;
-    ax[i*2].nAction = stp->nTknAct;
-    ax[i*2+1].stp = stp;
-    ax[i*2+1].isTkn = 0;
-    ax[i*2+1].nAction = stp->nNtAct;
-  }
-  mxTknOfst = mnTknOfst = 0;
-  mxNtOfst = mnNtOfst = 0;
-  /* In an effort to minimize the action table size, use the heuristic
-  ** of placing the largest action sets first */
-  for(i=0; i<lemp->nxstate*2; i++) ax[i].iOrder = i;
-  qsort(ax, lemp->nxstate*2, sizeof(ax[0]), axset_compare);
-  pActtab = acttab_alloc(lemp->nsymbol, lemp->nterminal);
-  for(i=0; i<lemp->nxstate*2 && ax[i].nAction>0; i++){
-    stp = ax[i].stp;
-    if( ax[i].isTkn ){
-      for(ap=stp->ap; ap; ap=ap->next){
-        int action;
-        if( ap->sp->index>=lemp->nterminal ) continue;
-        action = compute_action(lemp, ap);
-        if( action<0 ) continue;
-        acttab_action(pActtab, ap->sp->index, action);
-      }
-      stp->iTknOfst = acttab_insert(pActtab, 1);
-      if( stp->iTknOfst<mnTknOfst ) mnTknOfst = stp->iTknOfst;
-      if( stp->iTknOfst>mxTknOfst ) mxTknOfst = stp->iTknOfst;
-    }else{
-      for(ap=stp->ap; ap; ap=ap->next){
-        int action;
-        if( ap->sp->index<lemp->nterminal ) continue;
-        if( ap->sp->index==lemp->nsymbol ) continue;
-        action = compute_action(lemp, ap);
-        if( action<0 ) continue;
-        acttab_action(pActtab, ap->sp->index, action);
-      }
-      stp->iNtOfst = acttab_insert(pActtab, 0);
-      if( stp->iNtOfst<mnNtOfst ) mnNtOfst = stp->iNtOfst;
-      if( stp->iNtOfst>mxNtOfst ) mxNtOfst = stp->iNtOfst;
-    }
-#if 0  /* Uncomment for a trace of how the yy_action[] table fills out */
-    { int jj, nn;
-      for(jj=nn=0; jj<pActtab->nAction; jj++){
-        if( pActtab->aAction[jj].action<0 ) nn++;
-      }
-      printf("%4d: State %3d %s n: %2d size: %5d freespace: %d\n",
-             i, stp->statenum, ax[i].isTkn ? "Token" : "Var  ",
-             ax[i].nAction, pActtab->nAction, nn);
-    }
-#endif
-  }
-  lemon_free(ax);
+  if( t->aAction==0 ) ComputeTables(lemp, t);
 
   /* Mark rules that are actually used for reduce actions after all
   ** optimizations have been applied
   */
-  for(rp=lemp->rule; rp; rp=rp->next) rp->doesReduce = LEMON_FALSE;
-  for(i=0; i<lemp->nxstate; i++){
-    for(ap=lemp->sorted[i]->ap; ap; ap=ap->next){
-      if( ap->type==REDUCE || ap->type==SHIFTREDUCE ){
-        ap->x.rp->doesReduce = 1;
-      }
-    }
+  for(rp=lemp->rule; rp; rp=rp->next){
+    rp->doesReduce = t->aDoesReduce[rp->iRule];
   }
 
   /* Finish rendering the constants now that the action table has
@@ -4781,12 +5342,12 @@ void ReportTable(
   */
 
   /* Output the yy_action table */
-  lemp->nactiontab = n = acttab_action_size(pActtab);
+  lemp->nactiontab = n = t->nAction;
   lemp->tablesize += n*szActionType;
   fprintf(out,"#define YY_ACTTAB_COUNT (%d)\n", n); lineno++;
   fprintf(out,"static const YYACTIONTYPE yy_action[] = {\n"); lineno++;
   for(i=j=0; i<n; i++){
-    int action = acttab_yyaction(pActtab, i);
+    int action = t->aAction[i];
     if( action<0 ) action = lemp->noAction;
     if( j==0 ) fprintf(out," /* %5d */ ", i);
     fprintf(out, " %4d,", action);
@@ -4800,11 +5361,11 @@ void ReportTable(
   fprintf(out, "};\n"); lineno++;
 
   /* Output the yy_lookahead table */
-  lemp->nlookaheadtab = n = acttab_lookahead_size(pActtab);
+  lemp->nlookaheadtab = n = t->nLookahead;
   lemp->tablesize += n*szCodeType;
   fprintf(out,"static const YYCODETYPE yy_lookahead[] = {\n"); lineno++;
   for(i=j=0; i<n; i++){
-    int la = acttab_yylookahead(pActtab, i);
+    int la = t->aLookahead[i];
     if( la<0 ) la = lemp->nsymbol;
     if( j==0 ) fprintf(out," /* %5d */ ", i);
     fprintf(out, " %4d,", la);
@@ -4835,18 +5396,17 @@ void ReportTable(
 
   /* Output the yy_shift_ofst[] table */
   n = lemp->nxstate;
-  while( n>0 && lemp->sorted[n-1]->iTknOfst==NO_OFFSET ) n--;
+  while( n>0 && t->aTknOfst[n-1]==NO_OFFSET ) n--;
   fprintf(out, "#define YY_SHIFT_COUNT    (%d)\n", n-1); lineno++;
-  fprintf(out, "#define YY_SHIFT_MIN      (%d)\n", mnTknOfst); lineno++;
-  fprintf(out, "#define YY_SHIFT_MAX      (%d)\n", mxTknOfst); lineno++;
+  fprintf(out, "#define YY_SHIFT_MIN      (%d)\n", t->mnTknOfst); lineno++;
+  fprintf(out, "#define YY_SHIFT_MAX      (%d)\n", t->mxTknOfst); lineno++;
   fprintf(out, "static const %s yy_shift_ofst[] = {\n",
-       minimum_size_type(mnTknOfst, lemp->nterminal+lemp->nactiontab, &sz));
+       minimum_size_type(t->mnTknOfst, lemp->nterminal+lemp->nactiontab, &sz));
        lineno++;
   lemp->tablesize += n*sz;
   for(i=j=0; i<n; i++){
     int ofst;
-    stp = lemp->sorted[i];
-    ofst = stp->iTknOfst;
+    ofst = t->aTknOfst[i];
     if( ofst==NO_OFFSET ) ofst = lemp->nactiontab;
     if( j==0 ) fprintf(out," /* %5d */ ", i);
     fprintf(out, " %4d,", ofst);
@@ -4861,18 +5421,17 @@ void ReportTable(
 
   /* Output the yy_reduce_ofst[] table */
   n = lemp->nxstate;
-  while( n>0 && lemp->sorted[n-1]->iNtOfst==NO_OFFSET ) n--;
+  while( n>0 && t->aNtOfst[n-1]==NO_OFFSET ) n--;
   fprintf(out, "#define YY_REDUCE_COUNT (%d)\n", n-1); lineno++;
-  fprintf(out, "#define YY_REDUCE_MIN   (%d)\n", mnNtOfst); lineno++;
-  fprintf(out, "#define YY_REDUCE_MAX   (%d)\n", mxNtOfst); lineno++;
+  fprintf(out, "#define YY_REDUCE_MIN   (%d)\n", t->mnNtOfst); lineno++;
+  fprintf(out, "#define YY_REDUCE_MAX   (%d)\n", t->mxNtOfst); lineno++;
   fprintf(out, "static const %s yy_reduce_ofst[] = {\n",
-          minimum_size_type(mnNtOfst-1, mxNtOfst, &sz)); lineno++;
+          minimum_size_type(t->mnNtOfst-1, t->mxNtOfst, &sz)); lineno++;
   lemp->tablesize += n*sz;
   for(i=j=0; i<n; i++){
     int ofst;
-    stp = lemp->sorted[i];
-    ofst = stp->iNtOfst;
-    if( ofst==NO_OFFSET ) ofst = mnNtOfst - 1;
+    ofst = t->aNtOfst[i];
+    if( ofst==NO_OFFSET ) ofst = t->mnNtOfst - 1;
     if( j==0 ) fprintf(out," /* %5d */ ", i);
     fprintf(out, " %4d,", ofst);
     if( j==9 || i==n-1 ){
@@ -4889,12 +5448,11 @@ void ReportTable(
   n = lemp->nxstate;
   lemp->tablesize += n*szActionType;
   for(i=j=0; i<n; i++){
-    stp = lemp->sorted[i];
     if( j==0 ) fprintf(out," /* %5d */ ", i);
-    if( stp->iDfltReduce<0 ){
+    if( t->aDfltReduce[i]<0 ){
       fprintf(out, " %4d,", lemp->errAction);
     }else{
-      fprintf(out, " %4d,", stp->iDfltReduce + lemp->minReduce);
+      fprintf(out, " %4d,", t->aDfltReduce[i] + lemp->minReduce);
     }
     if( j==9 || i==n-1 ){
       fprintf(out, "\n"); lineno++;
@@ -5100,10 +5658,9 @@ void ReportTable(
   /* Append any addition code the user desires */
   tplt_print(out,lemp,lemp->extracode,&lineno);
 
-  acttab_free(pActtab);
   fclose(in);
-  fclose(out);
-  if( sql ) fclose(sql);
+  file_commit(lemp, out, outName);
+  if( sql ) file_commit(lemp, sql, sqlName);
   return;
 }
 
@@ -5384,24 +5941,194 @@ int SetUnion(char *s1, char *s2)
 }
 /********************** From the file "table.c" ****************************/
 /*
-** All code in this file has been automatically generated
-** from a specification in the file
-**              "table.q"
-** by the associative array code building program "aagen".
-** Do not edit this file!  Instead, edit the specification
-** file, then rerun aagen.
-*/
-/*
 ** Code for processing tables in the LEMON parser generator.
+**
+** These tables were originally generated by the associative array code
+** building program "aagen" as four separate chained hash tables with a
+** fixed initial size.  They now share one open-addressing implementation
+** (the "hashtable" object below) that grows whenever its load factor
+** is exceeded, so that large grammars do not degrade into long probe
+** sequences in State_find() and Configtable_find().
 */
 
-PRIVATE unsigned strhash(const char *x)
+/* Mixing steps of the 32-bit MurmurHash3 finalizer.  Used to spread
+** the bits of the weak, arithmetic hashes below over the full width
+** of the result, so that masking with the table size works well. */
+PRIVATE unsigned hashmix(unsigned h)
 {
-  unsigned h = 0;
-  while( *x ) h = h*13 + *(x++);
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
   return h;
 }
 
+/* Fold one more value into a running hash */
+PRIVATE unsigned hashcombine(unsigned h, unsigned v)
+{
+  return hashmix(h ^ (v + 0x9e3779b9u + (h << 6) + (h >> 2)));
+}
+
+/* Hash a string (32-bit FNV-1a, followed by a final mixing step) */
+PRIVATE unsigned strhash(const char *x)
+{
+  unsigned h = 2166136261u;
+  while( *x ){
+    h ^= (unsigned char)*(x++);
+    h *= 16777619u;
+  }
+  return hashmix(h);
+}
+
+/* There is one instance of this structure for every element stored
+** in a hashtable.  Elements are kept in insertion order, which is
+** the order in which the *_arrayof() routines return them. */
+struct s_htentry {
+  const void *key;         /* The key */
+  void *data;              /* The data */
+  unsigned hash;           /* Full hash of the key, cached for regrowth */
+};
+
+/* Generic open-addressing hash table with linear probing.
+**
+** The element storage "tbl" is a dense array in insertion order.  The
+** "slot" array is the actual hash table: each slot holds one plus the
+** index of an element in "tbl", or zero if the slot is empty.  The slot
+** array always has a power of 2 size, and is doubled whenever inserting
+** another element would push its load factor over HT_MAXLOAD_NUM /
+** HT_MAXLOAD_DEN.  Because elements are never removed individually
+** (only all at once), no tombstones are needed.
+*/
+struct s_hashtable {
+  int size;                /* Number of slots.  A power of 2 */
+  int count;               /* Number of elements in tbl */
+  int alloc;               /* Number of elements tbl has room for */
+  int *slot;               /* The hash table proper */
+  struct s_htentry *tbl;   /* The data stored here */
+  unsigned (*xHash)(const void*);           /* Hash function for keys */
+  int (*xCmp)(const void*, const void*);    /* Key comparison, 0 if equal */
+};
+
+/* Maximum load factor of a hashtable, as a fraction */
+#define HT_MAXLOAD_NUM 3
+#define HT_MAXLOAD_DEN 4
+
+/* Initialize a hashtable with room for at least nInit elements */
+PRIVATE void hashtable_init(
+  struct s_hashtable *ht,
+  int nInit,
+  unsigned (*xHash)(const void*),
+  int (*xCmp)(const void*, const void*)
+){
+  int size = 8;
+  while( size*HT_MAXLOAD_NUM < nInit*HT_MAXLOAD_DEN ) size *= 2;
+  ht->size = size;
+  ht->count = 0;
+  ht->alloc = size*HT_MAXLOAD_NUM/HT_MAXLOAD_DEN;
+  ht->slot = (int*)lemon_calloc(size, sizeof(int));
+  ht->tbl = (struct s_htentry*)lemon_calloc(ht->alloc, sizeof(struct s_htentry));
+  ht->xHash = xHash;
+  ht->xCmp = xCmp;
+}
+
+/* Locate the slot that holds the given key, or the empty slot where
+** it would be inserted if it is not present */
+PRIVATE int *hashtable_probe(
+  const struct s_hashtable *ht,
+  const void *key,
+  unsigned hash
+){
+  unsigned mask = (unsigned)ht->size - 1;
+  unsigned h = hash & mask;
+  while( ht->slot[h] ){
+    const struct s_htentry *np = &ht->tbl[ht->slot[h]-1];
+    if( np->hash==hash && (*ht->xCmp)(np->key,key)==0 ) break;
+    h = (h+1) & mask;
+  }
+  return &ht->slot[h];
+}
+
+/* Double the number of slots of a hashtable, and the room for its
+** elements.  Return TRUE if successful. */
+PRIVATE int hashtable_grow(struct s_hashtable *ht)
+{
+  int i;
+  int size = ht->size*2;
+  unsigned mask = (unsigned)size - 1;
+  int *slot = (int*)lemon_calloc(size, sizeof(int));
+  struct s_htentry *tbl;
+  if( slot==0 ) return 0;
+  tbl = (struct s_htentry*)lemon_realloc(ht->tbl,
+            sizeof(struct s_htentry)*(size*HT_MAXLOAD_NUM/HT_MAXLOAD_DEN));
+  if( tbl==0 ) return 0;
+  /* The cached hashes spare us calling xHash on every element again */
+  for(i=0; i<ht->count; i++){
+    unsigned h = tbl[i].hash & mask;
+    while( slot[h] ) h = (h+1) & mask;
+    slot[h] = i+1;
+  }
+  lemon_free(ht->slot);
+  ht->slot = slot;
+  ht->tbl = tbl;
+  ht->size = size;
+  ht->alloc = size*HT_MAXLOAD_NUM/HT_MAXLOAD_DEN;
+  return 1;
+}
+
+/* Insert a new record into a hashtable.  Return TRUE if successful.
+** Prior data with the same key is NOT overwritten */
+PRIVATE int hashtable_insert(struct s_hashtable *ht, const void *key, void *data)
+{
+  unsigned hash = (*ht->xHash)(key);
+  int *pSlot = hashtable_probe(ht, key, hash);
+  struct s_htentry *np;
+  if( *pSlot ){
+    /* An existing entry with the same key is found. */
+    /* Fail because overwrite is not allowed. */
+    return 0;
+  }
+  if( ht->count>=ht->alloc ){
+    if( !hashtable_grow(ht) ) return 0;  /* Fail due to malloc failure */
+    pSlot = hashtable_probe(ht, key, hash);
+  }
+  np = &ht->tbl[ht->count++];
+  np->key = key;
+  np->data = data;
+  np->hash = hash;
+  *pSlot = ht->count;
+  return 1;
+}
+
+/* Return a pointer to data assigned to the given key.  Return NULL
+** if no such key. */
+PRIVATE void *hashtable_find(const struct s_hashtable *ht, const void *key)
+{
+  int *pSlot = hashtable_probe(ht, key, (*ht->xHash)(key));
+  return *pSlot ? ht->tbl[*pSlot-1].data : 0;
+}
+
+/* Return an array of pointers to all data in a hashtable, in insertion
+** order.  The array is obtained from malloc.  Return NULL if memory
+** allocation problems, or if the array is empty. */
+PRIVATE void **hashtable_arrayof(const struct s_hashtable *ht)
+{
+  void **array;
+  int i;
+  array = (void **)lemon_calloc(ht->count, sizeof(void *));
+  if( array ){
+    for(i=0; i<ht->count; i++) array[i] = ht->tbl[i].data;
+  }
+  return array;
+}
+
+/* Remove all data from a hashtable, keeping its current capacity */
+PRIVATE void hashtable_clear(struct s_hashtable *ht)
+{
+  memset(ht->slot, 0, sizeof(int)*ht->size);
+  ht->count = 0;
+}
+
 /* Works like strdup, sort of.  Save a string in malloced memory, but
 ** keep strings in a table so that the same string is not in more
 ** than one place.
@@ -5422,119 +6149,39 @@ const char *Strsafe(const char *y)
   return z;
 }
 
-/* There is one instance of the following structure for each
-** associative array of type "x1".
-*/
-struct s_x1 {
-  int size;               /* The number of available slots. */
-                          /*   Must be a power of 2 greater than or */
-                          /*   equal to 1 */
-  int count;              /* Number of currently slots filled */
-  struct s_x1node *tbl;  /* The data stored here */
-  struct s_x1node **ht;  /* Hash table for lookups */
-};
-
-/* There is one instance of this structure for every data element
-** in an associative array of type "x1".
-*/
-typedef struct s_x1node {
-  const char *data;        /* The data */
-  struct s_x1node *next;   /* Next entry with the same hash */
-  struct s_x1node **from;  /* Previous link */
-} x1node;
+/* Hash and comparison callbacks of string-keyed tables */
+PRIVATE unsigned strhash_cb(const void *x)
+{
+  return strhash((const char *)x);
+}
+PRIVATE int strcmp_cb(const void *a, const void *b)
+{
+  return strcmp((const char *)a, (const char *)b);
+}
 
-/* There is only one instance of the array, which is the following */
-static struct s_x1 *x1a;
+/* The table of saved strings.  Keys and data are the same string */
+static struct s_hashtable *x1a;
 
 /* Allocate a new associative array */
 void Strsafe_init(void){
   if( x1a ) return;
-  x1a = (struct s_x1*)lemon_malloc( sizeof(struct s_x1) );
-  if( x1a ){
-    x1a->size = 1024;
-    x1a->count = 0;
-    x1a->tbl = (x1node*)lemon_calloc(1024, sizeof(x1node) + sizeof(x1node*));
-    if( x1a->tbl==0 ){
-      lemon_free(x1a);
-      x1a = 0;
-    }else{
-      int i;
-      x1a->ht = (x1node**)&(x1a->tbl[1024]);
-      for(i=0; i<1024; i++) x1a->ht[i] = 0;
-    }
-  }
+  x1a = (struct s_hashtable*)lemon_malloc( sizeof(struct s_hashtable) );
+  if( x1a ) hashtable_init(x1a, 256, strhash_cb, strcmp_cb);
 }
 /* Insert a new record into the array.  Return TRUE if successful.
 ** Prior data with the same key is NOT overwritten */
 int Strsafe_insert(const char *data)
 {
-  x1node *np;
-  unsigned h;
-  unsigned ph;
-
   if( x1a==0 ) return 0;
-  ph = strhash(data);
-  h = ph & (x1a->size-1);
-  np = x1a->ht[h];
-  while( np ){
-    if( strcmp(np->data,data)==0 ){
-      /* An existing entry with the same key is found. */
-      /* Fail because overwrite is not allows. */
-      return 0;
-    }
-    np = np->next;
-  }
-  if( x1a->count>=x1a->size ){
-    /* Need to make the hash table bigger */
-    int i,arrSize;
-    struct s_x1 array;
-    array.size = arrSize = x1a->size*2;
-    array.count = x1a->count;
-    array.tbl = (x1node*)lemon_calloc(arrSize, sizeof(x1node)+sizeof(x1node*));
-    if( array.tbl==0 ) return 0;  /* Fail due to malloc failure */
-    array.ht = (x1node**)&(array.tbl[arrSize]);
-    for(i=0; i<arrSize; i++) array.ht[i] = 0;
-    for(i=0; i<x1a->count; i++){
-      x1node *oldnp, *newnp;
-      oldnp = &(x1a->tbl[i]);
-      h = strhash(oldnp->data) & (arrSize-1);
-      newnp = &(array.tbl[i]);
-      if( array.ht[h] ) array.ht[h]->from = &(newnp->next);
-      newnp->next = array.ht[h];
-      newnp->data = oldnp->data;
-      newnp->from = &(array.ht[h]);
-      array.ht[h] = newnp;
-    }
-    /* lemon_free(x1a->tbl); // This program was originally for 16-bit machines.
-    ** Don't worry about freeing memory on modern platforms. */
-    *x1a = array;
-  }
-  /* Insert the new data */
-  h = ph & (x1a->size-1);
-  np = &(x1a->tbl[x1a->count++]);
-  np->data = data;
-  if( x1a->ht[h] ) x1a->ht[h]->from = &(np->next);
-  np->next = x1a->ht[h];
-  x1a->ht[h] = np;
-  np->from = &(x1a->ht[h]);
-  return 1;
+  return hashtable_insert(x1a, data, (void *)data);
 }
 
 /* Return a pointer to data assigned to the given key.  Return NULL
 ** if no such key. */
 const char *Strsafe_find(const char *key)
 {
-  unsigned h;
-  x1node *np;
-
   if( x1a==0 ) return 0;
-  h = strhash(key) & (x1a->size-1);
-  np = x1a->ht[h];
-  while( np ){
-    if( strcmp(np->data,key)==0 ) break;
-    np = np->next;
-  }
-  return np ? np->data : 0;
+  return (const char *)hashtable_find(x1a, key);
 }
 
 /* Return a pointer to the (terminal or nonterminal) symbol "x".
@@ -5589,123 +6236,29 @@ int Symbolcmpp(const void *_a, const void *_b)
   return i1==i2 ? a->index - b->index : i1 - i2;
 }
 
-/* There is one instance of the following structure for each
-** associative array of type "x2".
-*/
-struct s_x2 {
-  int size;               /* The number of available slots. */
-                          /*   Must be a power of 2 greater than or */
-                          /*   equal to 1 */
-  int count;              /* Number of currently slots filled */
-  struct s_x2node *tbl;  /* The data stored here */
-  struct s_x2node **ht;  /* Hash table for lookups */
-};
-
-/* There is one instance of this structure for every data element
-** in an associative array of type "x2".
-*/
-typedef struct s_x2node {
-  struct symbol *data;     /* The data */
-  const char *key;         /* The key */
-  struct s_x2node *next;   /* Next entry with the same hash */
-  struct s_x2node **from;  /* Previous link */
-} x2node;
-
-/* There is only one instance of the array, which is the following */
-static struct s_x2 *x2a;
+/* The table of grammar symbols, keyed by name */
+static struct s_hashtable *x2a;
 
 /* Allocate a new associative array */
 void Symbol_init(void){
   if( x2a ) return;
-  x2a = (struct s_x2*)lemon_malloc( sizeof(struct s_x2) );
-  if( x2a ){
-    x2a->size = 128;
-    x2a->count = 0;
-    x2a->tbl = (x2node*)lemon_calloc(128, sizeof(x2node) + sizeof(x2node*));
-    if( x2a->tbl==0 ){
-      lemon_free(x2a);
-      x2a = 0;
-    }else{
-      int i;
-      x2a->ht = (x2node**)&(x2a->tbl[128]);
-      for(i=0; i<128; i++) x2a->ht[i] = 0;
-    }
-  }
+  x2a = (struct s_hashtable*)lemon_malloc( sizeof(struct s_hashtable) );
+  if( x2a ) hashtable_init(x2a, 64, strhash_cb, strcmp_cb);
 }
 /* Insert a new record into the array.  Return TRUE if successful.
 ** Prior data with the same key is NOT overwritten */
 int Symbol_insert(struct symbol *data, const char *key)
 {
-  x2node *np;
-  unsigned h;
-  unsigned ph;
-
   if( x2a==0 ) return 0;
-  ph = strhash(key);
-  h = ph & (x2a->size-1);
-  np = x2a->ht[h];
-  while( np ){
-    if( strcmp(np->key,key)==0 ){
-      /* An existing entry with the same key is found. */
-      /* Fail because overwrite is not allows. */
-      return 0;
-    }
-    np = np->next;
-  }
-  if( x2a->count>=x2a->size ){
-    /* Need to make the hash table bigger */
-    int i,arrSize;
-    struct s_x2 array;
-    array.size = arrSize = x2a->size*2;
-    array.count = x2a->count;
-    array.tbl = (x2node*)lemon_calloc(arrSize, sizeof(x2node)+sizeof(x2node*));
-    if( array.tbl==0 ) return 0;  /* Fail due to malloc failure */
-    array.ht = (x2node**)&(array.tbl[arrSize]);
-    for(i=0; i<arrSize; i++) array.ht[i] = 0;
-    for(i=0; i<x2a->count; i++){
-      x2node *oldnp, *newnp;
-      oldnp = &(x2a->tbl[i]);
-      h = strhash(oldnp->key) & (arrSize-1);
-      newnp = &(array.tbl[i]);
-      if( array.ht[h] ) array.ht[h]->from = &(newnp->next);
-      newnp->next = array.ht[h];
-      newnp->key = oldnp->key;
-      newnp->data = oldnp->data;
-      newnp->from = &(array.ht[h]);
-      array.ht[h] = newnp;
-    }
-    /* lemon_free(x2a->tbl); // This program was originally written for 16-bit
-    ** machines.  Don't worry about freeing this trivial amount of memory
-    ** on modern platforms.  Just leak it. */
-    *x2a = array;
-  }
-  /* Insert the new data */
-  h = ph & (x2a->size-1);
-  np = &(x2a->tbl[x2a->count++]);
-  np->key = key;
-  np->data = data;
-  if( x2a->ht[h] ) x2a->ht[h]->from = &(np->next);
-  np->next = x2a->ht[h];
-  x2a->ht[h] = np;
-  np->from = &(x2a->ht[h]);
-  return 1;
+  return hashtable_insert(x2a, key, data);
 }
 
 /* Return a pointer to data assigned to the given key.  Return NULL
 ** if no such key. */
 struct symbol *Symbol_find(const char *key)
 {
-  unsigned h;
-  x2node *np;
-
   if( x2a==0 ) return 0;
-  h = strhash(key) & (x2a->size-1);
-  np = x2a->ht[h];
-  while( np ){
-    if( strcmp(np->key,key)==0 ) break;
-    np = np->next;
-  }
-  return np ? np->data : 0;
+  return (struct symbol *)hashtable_find(x2a, key);
 }
 
 /* Return the n-th data.  Return NULL if n is out of range. */
@@ -5713,7 +6266,7 @@ struct symbol *Symbol_Nth(int n)
 {
   struct symbol *data;
   if( x2a && n>0 && n<=x2a->count ){
-    data = x2a->tbl[n-1].data;
+    data = (struct symbol *)x2a->tbl[n-1].data;
   }else{
     data = 0;
   }
@@ -5731,15 +6284,8 @@ int Symbol_count()
 ** problems, or if the array is empty. */
 struct symbol **Symbol_arrayof()
 {
-  struct symbol **array;
-  int i,arrSize;
   if( x2a==0 ) return 0;
-  arrSize = x2a->count;
-  array = (struct symbol **)lemon_calloc(arrSize, sizeof(struct symbol *));
-  if( array ){
-    for(i=0; i<arrSize; i++) array[i] = x2a->tbl[i].data;
-  }
-  return array;
+  return (struct symbol **)hashtable_arrayof(x2a);
 }
 
 /* Compare two configurations */
@@ -5773,7 +6319,8 @@ PRIVATE unsigned statehash(struct config *a)
 {
   unsigned h=0;
   while( a ){
-    h = h*571 + a->rp->index*37 + a->dot;
+    h = hashcombine(h, (unsigned)a->rp->index);
+    h = hashcombine(h, (unsigned)a->dot);
     a = a->bp;
   }
   return h;
@@ -5788,259 +6335,90 @@ struct state *State_new()
   return newstate;
 }
 
-/* There is one instance of the following structure for each
-** associative array of type "x3".
-*/
-struct s_x3 {
-  int size;               /* The number of available slots. */
-                          /*   Must be a power of 2 greater than or */
-                          /*   equal to 1 */
-  int count;              /* Number of currently slots filled */
-  struct s_x3node *tbl;  /* The data stored here */
-  struct s_x3node **ht;  /* Hash table for lookups */
-};
-
-/* There is one instance of this structure for every data element
-** in an associative array of type "x3".
-*/
-typedef struct s_x3node {
-  struct state *data;                  /* The data */
-  struct config *key;                   /* The key */
-  struct s_x3node *next;   /* Next entry with the same hash */
-  struct s_x3node **from;  /* Previous link */
-} x3node;
+/* Hash and comparison callbacks of the state table */
+PRIVATE unsigned statehash_cb(const void *x)
+{
+  return statehash((struct config *)x);
+}
+PRIVATE int statecmp_cb(const void *a, const void *b)
+{
+  return statecmp((struct config *)a, (struct config *)b);
+}
 
-/* There is only one instance of the array, which is the following */
-static struct s_x3 *x3a;
+/* The table of LR(0) states, keyed by their basis configurations */
+static struct s_hashtable *x3a;
 
 /* Allocate a new associative array */
 void State_init(void){
   if( x3a ) return;
-  x3a = (struct s_x3*)lemon_malloc( sizeof(struct s_x3) );
-  if( x3a ){
-    x3a->size = 128;
-    x3a->count = 0;
-    x3a->tbl = (x3node*)lemon_calloc(128, sizeof(x3node) + sizeof(x3node*));
-    if( x3a->tbl==0 ){
-      lemon_free(x3a);
-      x3a = 0;
-    }else{
-      int i;
-      x3a->ht = (x3node**)&(x3a->tbl[128]);
-      for(i=0; i<128; i++) x3a->ht[i] = 0;
-    }
-  }
+  x3a = (struct s_hashtable*)lemon_malloc( sizeof(struct s_hashtable) );
+  if( x3a ) hashtable_init(x3a, 128, statehash_cb, statecmp_cb);
 }
 /* Insert a new record into the array.  Return TRUE if successful.
 ** Prior data with the same key is NOT overwritten */
 int State_insert(struct state *data, struct config *key)
 {
-  x3node *np;
-  unsigned h;
-  unsigned ph;
-
   if( x3a==0 ) return 0;
-  ph = statehash(key);
-  h = ph & (x3a->size-1);
-  np = x3a->ht[h];
-  while( np ){
-    if( statecmp(np->key,key)==0 ){
-      /* An existing entry with the same key is found. */
-      /* Fail because overwrite is not allows. */
-      return 0;
-    }
-    np = np->next;
-  }
-  if( x3a->count>=x3a->size ){
-    /* Need to make the hash table bigger */
-    int i,arrSize;
-    struct s_x3 array;
-    array.size = arrSize = x3a->size*2;
-    array.count = x3a->count;
-    array.tbl = (x3node*)lemon_calloc(arrSize, sizeof(x3node)+sizeof(x3node*));
-    if( array.tbl==0 ) return 0;  /* Fail due to malloc failure */
-    array.ht = (x3node**)&(array.tbl[arrSize]);
-    for(i=0; i<arrSize; i++) array.ht[i] = 0;
-    for(i=0; i<x3a->count; i++){
-      x3node *oldnp, *newnp;
-      oldnp = &(x3a->tbl[i]);
-      h = statehash(oldnp->key) & (arrSize-1);
-      newnp = &(array.tbl[i]);
-      if( array.ht[h] ) array.ht[h]->from = &(newnp->next);
-      newnp->next = array.ht[h];
-      newnp->key = oldnp->key;
-      newnp->data = oldnp->data;
-      newnp->from = &(array.ht[h]);
-      array.ht[h] = newnp;
-    }
-    lemon_free(x3a->tbl);
-    *x3a = array;
-  }
-  /* Insert the new data */
-  h = ph & (x3a->size-1);
-  np = &(x3a->tbl[x3a->count++]);
-  np->key = key;
-  np->data = data;
-  if( x3a->ht[h] ) x3a->ht[h]->from = &(np->next);
-  np->next = x3a->ht[h];
-  x3a->ht[h] = np;
-  np->from = &(x3a->ht[h]);
-  return 1;
+  return hashtable_insert(x3a, key, data);
 }
 
 /* Return a pointer to data assigned to the given key.  Return NULL
 ** if no such key. */
 struct state *State_find(struct config *key)
 {
-  unsigned h;
-  x3node *np;
-
   if( x3a==0 ) return 0;
-  h = statehash(key) & (x3a->size-1);
-  np = x3a->ht[h];
-  while( np ){
-    if( statecmp(np->key,key)==0 ) break;
-    np = np->next;
-  }
-  return np ? np->data : 0;
+  return (struct state *)hashtable_find(x3a, key);
 }
 
 /* Return an array of pointers to all data in the table.
-** The array is obtained from malloc.  Return NULL if memory allocation
+** The array is obtained from malloc.  Return NULL if memory
 ** problems, or if the array is empty. */
 struct state **State_arrayof(void)
 {
-  struct state **array;
-  int i,arrSize;
   if( x3a==0 ) return 0;
-  arrSize = x3a->count;
-  array = (struct state **)lemon_calloc(arrSize, sizeof(struct state *));
-  if( array ){
-    for(i=0; i<arrSize; i++) array[i] = x3a->tbl[i].data;
-  }
-  return array;
+  return (struct state **)hashtable_arrayof(x3a);
 }
 
 /* Hash a configuration */
 PRIVATE unsigned confighash(struct config *a)
 {
-  unsigned h=0;
-  h = a->rp->index*37 + a->dot;
-  return h;
+  return hashcombine((unsigned)a->rp->index, (unsigned)a->dot);
 }
 
-/* There is one instance of the following structure for each
-** associative array of type "x4".
-*/
-struct s_x4 {
-  int size;               /* The number of available slots. */
-                          /*   Must be a power of 2 greater than or */
-                          /*   equal to 1 */
-  int count;              /* Number of currently slots filled */
-  struct s_x4node *tbl;  /* The data stored here */
-  struct s_x4node **ht;  /* Hash table for lookups */
-};
-
-/* There is one instance of this structure for every data element
-** in an associative array of type "x4".
-*/
-typedef struct s_x4node {
-  struct config *data;                  /* The data */
-  struct s_x4node *next;   /* Next entry with the same hash */
-  struct s_x4node **from;  /* Previous link */
-} x4node;
+/* Hash and comparison callbacks of the configuration table */
+PRIVATE unsigned confighash_cb(const void *x)
+{
+  return confighash((struct config *)x);
+}
+PRIVATE int configcmp_cb(const void *a, const void *b)
+{
+  return Configcmp((const char *)a, (const char *)b);
+}
 
-/* There is only one instance of the array, which is the following */
-static struct s_x4 *x4a;
+/* The table of configurations of the state under construction.
+** Keys and data are the same configuration */
+static struct s_hashtable *x4a;
 
 /* Allocate a new associative array */
 void Configtable_init(void){
   if( x4a ) return;
-  x4a = (struct s_x4*)lemon_malloc( sizeof(struct s_x4) );
-  if( x4a ){
-    x4a->size = 64;
-    x4a->count = 0;
-    x4a->tbl = (x4node*)lemon_calloc(64, sizeof(x4node) + sizeof(x4node*));
-    if( x4a->tbl==0 ){
-      lemon_free(x4a);
-      x4a = 0;
-    }else{
-      int i;
-      x4a->ht = (x4node**)&(x4a->tbl[64]);
-      for(i=0; i<64; i++) x4a->ht[i] = 0;
-    }
-  }
+  x4a = (struct s_hashtable*)lemon_malloc( sizeof(struct s_hashtable) );
+  if( x4a ) hashtable_init(x4a, 64, confighash_cb, configcmp_cb);
 }
 /* Insert a new record into the array.  Return TRUE if successful.
 ** Prior data with the same key is NOT overwritten */
 int Configtable_insert(struct config *data)
 {
-  x4node *np;
-  unsigned h;
-  unsigned ph;
-
   if( x4a==0 ) return 0;
-  ph = confighash(data);
-  h = ph & (x4a->size-1);
-  np = x4a->ht[h];
-  while( np ){
-    if( Configcmp((const char *) np->data,(const char *) data)==0 ){
-      /* An existing entry with the same key is found. */
-      /* Fail because overwrite is not allows. */
-      return 0;
-    }
-    np = np->next;
-  }
-  if( x4a->count>=x4a->size ){
-    /* Need to make the hash table bigger */
-    int i,arrSize;
-    struct s_x4 array;
-    array.size = arrSize = x4a->size*2;
-    array.count = x4a->count;
-    array.tbl = (x4node*)lemon_calloc(arrSize,
-                                      sizeof(x4node) + sizeof(x4node*));
-    if( array.tbl==0 ) return 0;  /* Fail due to malloc failure */
-    array.ht = (x4node**)&(array.tbl[arrSize]);
-    for(i=0; i<arrSize; i++) array.ht[i] = 0;
-    for(i=0; i<x4a->count; i++){
-      x4node *oldnp, *newnp;
-      oldnp = &(x4a->tbl[i]);
-      h = confighash(oldnp->data) & (arrSize-1);
-      newnp = &(array.tbl[i]);
-      if( array.ht[h] ) array.ht[h]->from = &(newnp->next);
-      newnp->next = array.ht[h];
-      newnp->data = oldnp->data;
-      newnp->from = &(array.ht[h]);
-      array.ht[h] = newnp;
-    }
-    *x4a = array;
-  }
-  /* Insert the new data */
-  h = ph & (x4a->size-1);
-  np = &(x4a->tbl[x4a->count++]);
-  np->data = data;
-  if( x4a->ht[h] ) x4a->ht[h]->from = &(np->next);
-  np->next = x4a->ht[h];
-  x4a->ht[h] = np;
-  np->from = &(x4a->ht[h]);
-  return 1;
+  return hashtable_insert(x4a, data, data);
 }
 
 /* Return a pointer to data assigned to the given key.  Return NULL
 ** if no such key. */
 struct config *Configtable_find(struct config *key)
 {
-  int h;
-  x4node *np;
-
   if( x4a==0 ) return 0;
-  h = confighash(key) & (x4a->size-1);
-  np = x4a->ht[h];
-  while( np ){
-    if( Configcmp((const char *) np->data,(const char *) key)==0 ) break;
-    np = np->next;
-  }
-  return np ? np->data : 0;
+  return (struct config *)hashtable_find(x4a, key);
 }
 
 /* Remove all data from the table.  Pass each data to the function "f"
@@ -6049,8 +6427,7 @@ void Configtable_clear(int(*f)(struct config *))
 {
   int i;
   if( x4a==0 || x4a->count==0 ) return;
-  if( f ) for(i=0; i<x4a->count; i++) (*f)(x4a->tbl[i].data);
-  for(i=0; i<x4a->size; i++) x4a->ht[i] = 0;
-  x4a->count = 0;
+  if( f ) for(i=0; i<x4a->count; i++) (*f)((struct config *)x4a->tbl[i].data);
+  hashtable_clear(x4a);
   return;
 }
@@ -221,6 +221,65 @@ struct yyStackEntry {
 };
 typedef struct yyStackEntry yyStackEntry;
 
+#if !defined(NDEBUG) || defined(YYFLIGHTRECORDER) || defined(YYPROFILE)
+#include <stdio.h>
+#endif
+#ifdef YYFLIGHTRECORDER
+/* The dump of the flight recorder rebuilds the stack with YYREALLOC(),
+** which is realloc() unless %realloc names another function */
+#include <stdlib.h>
+#endif
+
+#if defined(YYFLIGHTRECORDER) || defined(YYEVENTSINK) || !defined(NDEBUG)
+/* Kinds of the steps of a parser, as kept by the flight recorder, as
+** given to YYEVENTSINK and as selected by ParseTraceFilter().  A program
+** may define YYEVENTSINK(P,K,M,V,X) to be told of every step of parser P,
+** of kind K, with the symbol M, value V and extra X described below,
+** whether tracing is compiled in or not. */
+#define YYEV_INPUT     1   /* Lookahead M read, value is the state or action */
+#define YYEV_SHIFT     2   /* Shift of token M, value is the new state */
+#define YYEV_GOTO      3   /* Shift of the LHS M of a reduce, value is the new state */
+#define YYEV_REDUCE    4   /* Reduce to M, value is the rule, extra the state popped back to */
+#define YYEV_POP       5   /* Pop of symbol M during error recovery or cleanup */
+#define YYEV_DISCARD   6   /* Lookahead M discarded during error recovery */
+#define YYEV_ERROR     7   /* Syntax error */
+#define YYEV_ACCEPT    8   /* Accept */
+#define YYEV_FAIL      9   /* Parse failure */
+#define YYEV_OVERFLOW 10   /* Stack overflow */
+#endif /* defined(YYFLIGHTRECORDER) || defined(YYEVENTSINK) || ... */
+
+#ifdef YYFLIGHTRECORDER
+/* The flight recorder keeps the last YYFLIGHTRECORDER steps of each
+** parser in a ring of compact events, even when tracing is compiled out,
+** so that they can be dumped as a trace after something went wrong.
+** Define YYFLIGHTRECORDER to a power of two to turn it on. */
+#if YYFLIGHTRECORDER<=0 || (YYFLIGHTRECORDER & (YYFLIGHTRECORDER-1))!=0
+# error "YYFLIGHTRECORDER must be a power of two"
+#endif
+typedef struct yyFlightEvent {
+  unsigned char kind;    /* One of the YYEV_ codes */
+  YYCODETYPE major;      /* Symbol of the event, if any */
+  YYACTIONTYPE value;    /* State, action or rule, depending on the kind */
+  YYACTIONTYPE extra;    /* State popped back to by a reduce */
+} yyFlightEvent;
+typedef struct yyFlightFrame {
+  YYACTIONTYPE stateno;  /* The state-number, as in yyStackEntry */
+  YYCODETYPE major;      /* The symbol, as in yyStackEntry */
+} yyFlightFrame;
+#endif /* YYFLIGHTRECORDER */
+
+#ifndef NDEBUG
+/* Filter of a trace, as set by ParseTraceFilter() and
+** ParseTraceFilterInstance() */
+typedef struct yyTraceFilterSet {
+  int on;                                /* True if any line is left out */
+  unsigned int mKind;                    /* Bit 1<<K for each kind K kept */
+  int nMinDepth;                         /* Depth of the stack to keep from */
+  unsigned char aRule[(YYNRULE+7)/8];    /* Bit of each rule kept */
+  unsigned char aState[(YYNSTATE+7)/8];  /* Bit of each state kept */
+} yyTraceFilterSet;
+#endif /* NDEBUG */
+
 /* The state of the parser is completely contained in an instance of
 ** the following structure */
 struct yyParser {
@@ -228,11 +287,33 @@ struct yyParser {
 #ifdef YYTRACKMAXSTACKDEPTH
   int yyhwm;                    /* High-water mark of the stack */
 #endif
+#ifdef YYTRACKREDUCECOUNT
+  unsigned long long yynreduce; /* Number of reductions performed */
+#endif
 #ifndef YYNOERRORRECOVERY
   int yyerrcnt;                 /* Shifts left before out of the error */
 #endif
   ParseARG_SDECL                /* A place to hold %extra_argument */
   ParseCTX_SDECL                /* A place to hold %extra_context */
+#ifndef NDEBUG
+  FILE *yyTraceFILE;            /* Trace of this parser, or NULL for the global one */
+  char *yyTracePrompt;          /* Prompt of the trace of this parser */
+  yyTraceFilterSet yyTraceFilter; /* Filter of the trace of this parser */
+#endif
+#ifdef YYFLIGHTRECORDER
+  yyFlightEvent yyfrRing[YYFLIGHTRECORDER]; /* Last events of the parser */
+  unsigned int yyfrNext;        /* Slot of the ring that receives the next event */
+  unsigned int yyfrCount;       /* Number of events in the ring */
+  yyFlightFrame *yyfrBase;      /* Stack before the oldest event, without entry 0 */
+  int yyfrBaseSize;             /* Number of entries of yyfrBase in use */
+  yyFlightFrame yyfrBase0[YYSTACKDEPTH];  /* Initial space of yyfrBase */
+  FILE *yyfrOut;                /* Receives the automatic dump, or NULL */
+  int yyfrPending;              /* Set when an automatic dump is due */
+#endif
+#if YYGROWABLESTACK
+  int yygrowPercent;                  /* Size of a grown stack, in percent of the old */
+  yyStackEntry *yystackUser;          /* Stack space of the caller, or NULL */
+#endif
   yyStackEntry *yystackEnd;           /* Last entry in the stack */
   yyStackEntry *yystack;              /* The parser stack */
   yyStackEntry yystk0[YYSTACKDEPTH];  /* Initial stack space */
@@ -240,12 +321,39 @@ struct yyParser {
 typedef struct yyParser yyParser;
 
 #include <assert.h>
+#include <string.h>
 #ifndef NDEBUG
 #include <stdio.h>
-static FILE *yyTraceFILE = 0;
-static char *yyTracePrompt = 0;
+/* Storage class of the trace destination.  Programs that run parsers
+** in several threads may define it as _Thread_local, so that each
+** thread traces its parsers to its own stream. */
+#ifndef YYTRACESTORAGE
+# define YYTRACESTORAGE
+#endif
+static YYTRACESTORAGE FILE *yyTraceFILE = 0;
+static YYTRACESTORAGE char *yyTracePrompt = 0;
+static YYTRACESTORAGE yyTraceFilterSet yyTraceFilter;
 #endif /* NDEBUG */
 
+#ifdef YYACTIONTIMING
+/* Define YYACTIONTIMING to trace how long the code of each reduce action
+** takes, after the line that announces the reduce.  The times are read
+** from YYACTIONCLOCK(), which must count nanoseconds, and which programs
+** may define to read a cheaper clock. */
+#ifdef NDEBUG
+#error "YYACTIONTIMING writes to the trace, which NDEBUG compiles out"
+#endif
+#ifndef YYACTIONCLOCK
+#include <time.h>
+static long long yyActionClock(void){
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (long long)ts.tv_sec*1000000000 + ts.tv_nsec;
+}
+# define YYACTIONCLOCK() yyActionClock()
+#endif
+#endif /* YYACTIONTIMING */
+
 #ifndef NDEBUG
 /* 
 ** Turn parser tracing on by giving a stream to which to write the trace
@@ -270,39 +378,228 @@ void ParseTrace(FILE *TraceFILE, char *zTracePrompt){
   if( yyTraceFILE==0 ) yyTracePrompt = 0;
   else if( yyTracePrompt==0 ) yyTraceFILE = 0;
 }
+
+/*
+** Turn tracing on for a single parser, independently of ParseTrace(),
+** so that parsers used in different threads can trace to different
+** streams without sharing any state.  Tracing of the parser falls back
+** to the global trace set by ParseTrace() when either argument is NULL.
+** ParseInit() and ParseAlloc() reset the trace of the parser and its
+** filter, so call this after them.
+**
+** Inputs:
+** <ul>
+** <li> A pointer to the parser.
+** <li> A FILE* to which trace output of the parser should be written.
+** <li> A prefix string written at the beginning of every
+**      line of trace output of the parser.
+** </ul>
+**
+** Outputs:
+** None.
+*/
+void ParseTraceInstance(void *p, FILE *TraceFILE, char *zTracePrompt){
+  yyParser *pParser = (yyParser*)p;
+  pParser->yyTraceFILE = TraceFILE;
+  pParser->yyTracePrompt = zTracePrompt;
+  if( TraceFILE==0 || zTracePrompt==0 ){
+    pParser->yyTraceFILE = 0;
+    pParser->yyTracePrompt = 0;
+  }
+}
+
+/* Trace stream and prompt of a parser, which may be NULL for the
+** global ones: its own if it has one, or else the global ones */
+#define yyTraceOut(P) ((P) && (P)->yyTraceFILE ? (P)->yyTraceFILE : yyTraceFILE)
+#define yyTracePre(P) ((P) && (P)->yyTraceFILE ? (P)->yyTracePrompt : yyTracePrompt)
+/* Filter of the trace of a parser, which goes along with its stream */
+#define yyTraceFlt(P) \
+  ((P) && (P)->yyTraceFILE ? &(P)->yyTraceFilter : &yyTraceFilter)
+
+/*
+** Set filter F from the arguments of ParseTraceFilter().
+*/
+static void yyTraceFilterSetUp(
+  yyTraceFilterSet *f,          /* The filter to set */
+  const unsigned char *aRule,   /* Rules to trace, or NULL for all */
+  const unsigned char *aState,  /* States to trace, or NULL for all */
+  unsigned int mKind,           /* Kinds of steps to trace */
+  int nMinDepth                 /* Fewest entries above the first to trace */
+){
+  unsigned int mAll = 0;
+  int i;
+  for(i=YYEV_INPUT; i<=YYEV_OVERFLOW; i++) mAll |= 1u<<i;
+  if( aRule ){
+    memcpy(f->aRule, aRule, sizeof(f->aRule));
+  }else{
+    memset(f->aRule, 0xff, sizeof(f->aRule));
+  }
+  if( aState ){
+    memcpy(f->aState, aState, sizeof(f->aState));
+  }else{
+    memset(f->aState, 0xff, sizeof(f->aState));
+  }
+  f->mKind = mKind;
+  f->nMinDepth = nMinDepth;
+  f->on = aRule!=0 || aState!=0 || (mKind & mAll)!=mAll || nMinDepth>0;
+}
+
+/*
+** Trace only the steps of interest, such as the reductions of a rule
+** or what happens in a region of the state machine, so that tracing a
+** large input for them costs little more than not tracing at all.  The
+** filter is checked before a line is formatted, and a line is written
+** when all of the following hold:
+** <ul>
+** <li> Its kind K, among the YYEV_ codes, has bit 1<<K set in mKind.
+**      Lines about the stack growing are of the YYEV_OVERFLOW kind, and
+**      FALLBACK and WILDCARD lines of the YYEV_INPUT kind.
+** <li> The state on top of the stack, or below it if the top is a
+**      pending reduce, has its bit set in aState.  Bit S of a set is
+**      (aState[S/8]>>(S%8))&1.
+** <li> For reduces, the shifts that follow them and the times of their
+**      actions, the rule has its bit set in aRule.
+** <li> The stack holds at least nMinDepth entries above the first.
+** </ul>
+** The contents of the stack, written after each token, are left out.
+** The sets are copied, and NULL keeps all rules or states.  The filter
+** applies to the traces of the parsers that use the global trace set by
+** ParseTrace(), and ParseTraceFilterInstance() sets the filter of a
+** parser with its own trace.  While it leaves anything out, the trace of
+** each input starts with a "Filtered trace." line, so that readers of the
+** trace know steps are missing.  It is turned off with
+** ParseTraceFilter(0, 0, ~0u, 0).
+*/
+void ParseTraceFilter(
+  const unsigned char *aRule,   /* Rules to trace, or NULL for all */
+  const unsigned char *aState,  /* States to trace, or NULL for all */
+  unsigned int mKind,           /* Kinds of steps to trace */
+  int nMinDepth                 /* Fewest entries above the first to trace */
+){
+  yyTraceFilterSetUp(&yyTraceFilter, aRule, aState, mKind, nMinDepth);
+}
+
+/*
+** Filter the trace of a single parser, which has its own trace set by
+** ParseTraceInstance(), as ParseTraceFilter() filters the global trace.
+** ParseInit() and ParseAlloc() turn the filter of the parser off.
+*/
+void ParseTraceFilterInstance(
+  void *p,                      /* The parser */
+  const unsigned char *aRule,   /* Rules to trace, or NULL for all */
+  const unsigned char *aState,  /* States to trace, or NULL for all */
+  unsigned int mKind,           /* Kinds of steps to trace */
+  int nMinDepth                 /* Fewest entries above the first to trace */
+){
+  yyParser *pParser = (yyParser*)p;
+  yyTraceFilterSetUp(&pParser->yyTraceFilter, aRule, aState, mKind, nMinDepth);
+}
+
+/*
+** Return true if filter F keeps a line of kind K written for parser P,
+** about rule R, or about no rule if R is negative.  Without a parser,
+** only the kind is checked.
+*/
+static int yyTraceKeep(
+  const yyTraceFilterSet *f,
+  const yyParser *p,
+  int kind,
+  int ruleno
+){
+  const yyStackEntry *yytos;
+  int stateno;
+  if( ((f->mKind>>kind) & 1)==0 ) return 0;
+  if( ruleno>=0 && ((f->aRule[ruleno/8]>>(ruleno%8)) & 1)==0 ){
+    return 0;
+  }
+  if( p==0 ) return 1;
+  yytos = p->yytos;
+  if( yytos - p->yystack < f->nMinDepth ) return 0;
+  stateno = yytos->stateno;
+  if( stateno>=YYNSTATE && yytos>p->yystack ) stateno = yytos[-1].stateno;
+  return stateno>=YYNSTATE
+      || ((f->aState[stateno/8]>>(stateno%8)) & 1)!=0;
+}
+
+/* True if parser P traces, and a line of kind K about rule R passes the
+** filter of the trace */
+#define yyTraceOn(P,K,R) \
+  (yyTraceOut(P) && (!yyTraceFlt(P)->on || yyTraceKeep(yyTraceFlt(P),P,K,R)))
 #endif /* NDEBUG */
 
-#if defined(YYCOVERAGE) || !defined(NDEBUG)
+#if defined(YYCOVERAGE) || !defined(NDEBUG) || defined(YYFLIGHTRECORDER) \
+ || defined(YYEVENTSINK)
 /* For tracing shifts, the names of all terminals and nonterminals
 ** are required.  The following table supplies these names */
 static const char *const yyTokenName[] = { 
 %%
 };
-#endif /* defined(YYCOVERAGE) || !defined(NDEBUG) */
+#endif /* defined(YYCOVERAGE) || !defined(NDEBUG) || ... */
 
-#ifndef NDEBUG
+#if !defined(NDEBUG) || defined(YYFLIGHTRECORDER) || defined(YYEVENTSINK) \
+ || defined(YYPROFILE)
 /* For tracing reduce actions, the names of all rules are required.
 */
 static const char *const yyRuleName[] = {
 %%
 };
-#endif /* NDEBUG */
+#endif /* !defined(NDEBUG) || defined(YYFLIGHTRECORDER) || ... */
+
+#ifdef YYFLIGHTRECORDER
+static void yyFlightApply(yyFlightFrame*, int*, const yyFlightEvent*);
+
+/*
+** Record an event in the flight recorder of a parser.  When the ring is
+** full, the oldest event is applied to the copy of the stack that the
+** ring starts from, and replaced.
+*/
+static void yyFlightRecord(
+  yyParser *p,                  /* The parser */
+  int kind,                     /* One of the YYEV_ codes */
+  int major,                    /* Symbol of the event */
+  int value,                    /* State, action or rule of the event */
+  int extra                     /* State popped back to by a reduce */
+){
+  yyFlightEvent *e = &p->yyfrRing[p->yyfrNext];
+  if( p->yyfrCount==YYFLIGHTRECORDER ){
+    yyFlightApply(p->yyfrBase, &p->yyfrBaseSize, e);
+  }else{
+    p->yyfrCount++;
+  }
+  e->kind = (unsigned char)kind;
+  e->major = (YYCODETYPE)major;
+  e->value = (YYACTIONTYPE)value;
+  e->extra = (YYACTIONTYPE)extra;
+  p->yyfrNext = (p->yyfrNext+1) & (YYFLIGHTRECORDER-1);
+}
+#endif /* YYFLIGHTRECORDER */
+
+/* Hand a step of a parser to the flight recorder and to YYEVENTSINK */
+#if defined(YYFLIGHTRECORDER) && defined(YYEVENTSINK)
+# define yyTraceEvent(P,K,M,V,X) \
+    do{ yyFlightRecord(P,K,M,V,X); YYEVENTSINK(P,K,M,V,X); }while(0)
+#elif defined(YYFLIGHTRECORDER)
+# define yyTraceEvent(P,K,M,V,X) yyFlightRecord(P,K,M,V,X)
+#elif defined(YYEVENTSINK)
+# define yyTraceEvent(P,K,M,V,X) YYEVENTSINK(P,K,M,V,X)
+#else
+# define yyTraceEvent(P,K,M,V,X)
+#endif
 
 
 #if YYGROWABLESTACK
 /*
-** Try to increase the size of the parser stack.  Return the number
-** of errors.  Return 0 on success.
+** Move the parser stack to newSize entries, on the heap.  The space of
+** the parser and the space supplied with ParseStackBuffer() are left
+** to their owners.  Return the number of errors.  Return 0 on success.
 */
-static int yyGrowStack(yyParser *p){
+static int yyResizeStack(yyParser *p, int newSize){
   int oldSize = 1 + (int)(p->yystackEnd - p->yystack);
-  int newSize;
   int idx;
   yyStackEntry *pNew;
 
-  newSize = oldSize*2 + 100;
   idx = (int)(p->yytos - p->yystack);
-  if( p->yystack==p->yystk0 ){
+  if( p->yystack==p->yystk0 || p->yystack==p->yystackUser ){
     pNew = YYREALLOC(0, newSize*sizeof(pNew[0]));
     if( pNew==0 ) return 1;
     memcpy(pNew, p->yystack, oldSize*sizeof(pNew[0]));
@@ -312,15 +609,106 @@ static int yyGrowStack(yyParser *p){
   }
   p->yystack = pNew;
   p->yytos = &p->yystack[idx];
+#ifdef YYFLIGHTRECORDER
+  {
+    /* The copy of the stack kept by the flight recorder is never
+    ** deeper than the stack itself, so it grows along */
+    yyFlightFrame *pBase;
+    if( p->yyfrBase==p->yyfrBase0 ){
+      pBase = YYREALLOC(0, newSize*sizeof(pBase[0]));
+      if( pBase==0 ) return 1;
+      memcpy(pBase, p->yyfrBase, p->yyfrBaseSize*sizeof(pBase[0]));
+    }else{
+      pBase = YYREALLOC(p->yyfrBase, newSize*sizeof(pBase[0]));
+      if( pBase==0 ) return 1;
+    }
+    p->yyfrBase = pBase;
+  }
+#endif
 #ifndef NDEBUG
-  if( yyTraceFILE ){
-    fprintf(yyTraceFILE,"%sStack grows from %d to %d entries.\n",
-            yyTracePrompt, oldSize, newSize);
+  /* The new top of the stack is not set yet, so only the kind is checked */
+  if( yyTraceOut(p)
+   && (!yyTraceFlt(p)->on || yyTraceKeep(yyTraceFlt(p),0,YYEV_OVERFLOW,-1)) ){
+    fprintf(yyTraceOut(p),"%sStack grows from %d to %d entries of %d bytes.\n",
+            yyTracePre(p), oldSize, newSize, (int)sizeof(pNew[0]));
   }
 #endif
   p->yystackEnd = &p->yystack[newSize-1];
   return 0;
 }
+
+/*
+** Try to increase the size of the parser stack, as set by
+** ParseStackPolicy().  Return the number of errors.  Return 0 on success.
+*/
+static int yyGrowStack(yyParser *p){
+  int oldSize = 1 + (int)(p->yystackEnd - p->yystack);
+  return yyResizeStack(p, (int)((long long)oldSize*p->yygrowPercent/100) + 100);
+}
+
+/*
+** Set how the stack of a parser grows.  If it has fewer than nInitial
+** entries, it grows to nInitial entries right away.  Whenever it is
+** full, it then grows to growPercent percent of its size, plus 100
+** entries, so that 100 grows it linearly.  By default, it starts with
+** YYSTACKDEPTH entries, and doubles.  A growPercent below 100 keeps
+** the current growth.
+**
+** Return nonzero if the stack could not grow to nInitial entries.
+*/
+int ParseStackPolicy(void *p, int nInitial, int growPercent){
+  yyParser *pParser = (yyParser*)p;
+  if( growPercent>=100 ) pParser->yygrowPercent = growPercent;
+  if( nInitial > 1 + (int)(pParser->yystackEnd - pParser->yystack) ){
+    return yyResizeStack(pParser, nInitial);
+  }
+  return 0;
+}
+
+/*
+** Have a parser use the nByte bytes at pBuf as its stack, for as long
+** as they are enough.  The buffer must be aligned as malloc() aligns
+** memory, and must outlive the parser, or its next ParseStackBuffer()
+** call, as the caller keeps ownership of it.  When the stack outgrows
+** it, it moves to the heap as set by ParseStackPolicy().
+**
+** The parser must not be in the middle of an input, as when it has
+** just been initialized or has accepted its input.  Return nonzero if
+** it is, if the buffer cannot hold two entries, or if the flight
+** recorder could not grow along.
+*/
+int ParseStackBuffer(void *p, void *pBuf, size_t nByte){
+  yyParser *pParser = (yyParser*)p;
+  int nEntry = (int)(nByte/sizeof(yyStackEntry));
+  int oldSize = 1 + (int)(pParser->yystackEnd - pParser->yystack);
+  yyStackEntry *pNew = (yyStackEntry*)pBuf;
+  if( nEntry<2 || pParser->yytos!=pParser->yystack ) return 1;
+#ifdef YYFLIGHTRECORDER
+  if( nEntry>oldSize ){
+    yyFlightFrame *pBase;
+    if( pParser->yyfrBase==pParser->yyfrBase0 ){
+      pBase = YYREALLOC(0, nEntry*sizeof(pBase[0]));
+      if( pBase==0 ) return 1;
+      memcpy(pBase, pParser->yyfrBase, pParser->yyfrBaseSize*sizeof(pBase[0]));
+    }else{
+      pBase = YYREALLOC(pParser->yyfrBase, nEntry*sizeof(pBase[0]));
+      if( pBase==0 ) return 1;
+    }
+    pParser->yyfrBase = pBase;
+  }
+#else
+  (void)oldSize;
+#endif
+  pNew[0] = pParser->yystack[0];
+  if( pParser->yystack!=pParser->yystk0 && pParser->yystack!=pParser->yystackUser ){
+    YYFREE(pParser->yystack);
+  }
+  pParser->yystackUser = pNew;
+  pParser->yystack = pNew;
+  pParser->yytos = pNew;
+  pParser->yystackEnd = &pNew[nEntry-1];
+  return 0;
+}
 #endif /* YYGROWABLESTACK */
 
 #if !YYGROWABLESTACK
@@ -346,15 +734,35 @@ void ParseInit(void *yypRawParser ParseCTX_PDECL){
   ParseCTX_STORE
 #ifdef YYTRACKMAXSTACKDEPTH
   yypParser->yyhwm = 0;
+#endif
+#ifdef YYTRACKREDUCECOUNT
+  yypParser->yynreduce = 0;
 #endif
   yypParser->yystack = yypParser->yystk0;
   yypParser->yystackEnd = &yypParser->yystack[YYSTACKDEPTH-1];
+#if YYGROWABLESTACK
+  yypParser->yygrowPercent = 200;
+  yypParser->yystackUser = 0;
+#endif
 #ifndef YYNOERRORRECOVERY
   yypParser->yyerrcnt = -1;
 #endif
   yypParser->yytos = yypParser->yystack;
   yypParser->yystack[0].stateno = 0;
   yypParser->yystack[0].major = 0;
+#ifndef NDEBUG
+  yypParser->yyTraceFILE = 0;
+  yypParser->yyTracePrompt = 0;
+  yypParser->yyTraceFilter.on = 0;
+#endif
+#ifdef YYFLIGHTRECORDER
+  yypParser->yyfrNext = 0;
+  yypParser->yyfrCount = 0;
+  yypParser->yyfrBase = yypParser->yyfrBase0;
+  yypParser->yyfrBaseSize = 0;
+  yypParser->yyfrOut = 0;
+  yypParser->yyfrPending = 0;
+#endif
 }
 
 #ifndef Parse_ENGINEALWAYSONSTACK
@@ -426,40 +834,84 @@ static void yy_pop_parser_stack(yyParser *pParser){
   assert( pParser->yytos > pParser->yystack );
   yytos = pParser->yytos--;
 #ifndef NDEBUG
-  if( yyTraceFILE ){
-    fprintf(yyTraceFILE,"%sPopping %s\n",
-      yyTracePrompt,
+  if( yyTraceOn(pParser, YYEV_POP, -1) ){
+    fprintf(yyTraceOut(pParser),"%sPopping %s\n",
+      yyTracePre(pParser),
       yyTokenName[yytos->major]);
   }
 #endif
+  yyTraceEvent(pParser, YYEV_POP, yytos->major, 0, 0);
   yy_destructor(pParser, yytos->major, &yytos->minor);
 }
 
 /*
-** Clear all secondary memory allocations from the parser
+** Pop every element left in the stack, calling its destructor.
 */
-void ParseFinalize(void *p){
-  yyParser *pParser = (yyParser*)p;
-
+static void yy_pop_all(yyParser *pParser){
   /* In-lined version of calling yy_pop_parser_stack() for each
   ** element left in the stack */
   yyStackEntry *yytos = pParser->yytos;
   while( yytos>pParser->yystack ){
 #ifndef NDEBUG
-    if( yyTraceFILE ){
-      fprintf(yyTraceFILE,"%sPopping %s\n",
-        yyTracePrompt,
+    if( yyTraceOn(pParser, YYEV_POP, -1) ){
+      fprintf(yyTraceOut(pParser),"%sPopping %s\n",
+        yyTracePre(pParser),
         yyTokenName[yytos->major]);
     }
 #endif
+    yyTraceEvent(pParser, YYEV_POP, yytos->major, 0, 0);
     if( yytos->major>=YY_MIN_DSTRCTR ){
       yy_destructor(pParser, yytos->major, &yytos->minor);
     }
     yytos--;
   }
+  pParser->yytos = pParser->yystack;
+}
+
+/*
+** Get a parser ready for a new input, in the state ParseInit() leaves
+** it in, but without giving up the stack space it has grown.  The
+** destructors of the elements left in the stack are called, as
+** ParseFinalize() does.  The trace, the stack policy and buffer, and
+** the automatic dump of the flight recorder stay as they were set.
+*/
+void ParseReset(void *p){
+  yyParser *pParser = (yyParser*)p;
+  yy_pop_all(pParser);
+#ifdef YYTRACKMAXSTACKDEPTH
+  pParser->yyhwm = 0;
+#endif
+#ifdef YYTRACKREDUCECOUNT
+  pParser->yynreduce = 0;
+#endif
+#ifndef YYNOERRORRECOVERY
+  pParser->yyerrcnt = -1;
+#endif
+  pParser->yystack[0].stateno = 0;
+  pParser->yystack[0].major = 0;
+#ifdef YYFLIGHTRECORDER
+  pParser->yyfrNext = 0;
+  pParser->yyfrCount = 0;
+  pParser->yyfrBaseSize = 0;
+  pParser->yyfrPending = 0;
+#endif
+}
+
+/*
+** Clear all secondary memory allocations from the parser
+*/
+void ParseFinalize(void *p){
+  yyParser *pParser = (yyParser*)p;
+
+  yy_pop_all(pParser);
 
 #if YYGROWABLESTACK
-  if( pParser->yystack!=pParser->yystk0 ) YYFREE(pParser->yystack);
+  if( pParser->yystack!=pParser->yystk0 && pParser->yystack!=pParser->yystackUser ){
+    YYFREE(pParser->yystack);
+  }
+#ifdef YYFLIGHTRECORDER
+  if( pParser->yyfrBase!=pParser->yyfrBase0 ) YYFREE(pParser->yyfrBase);
+#endif
 #endif
 }
 
@@ -484,6 +936,78 @@ void ParseFree(
 }
 #endif /* Parse_ENGINEALWAYSONSTACK */
 
+#if defined(YYPARSERPOOL) && !defined(Parse_ENGINEALWAYSONSTACK)
+/* Storage class of the pool of parsers.  Each thread has a pool of its
+** own, of up to YYPARSERPOOL parsers, so that taking a parser from it
+** needs no lock.  Single-threaded programs may define it as empty. */
+#ifndef YYPOOLSTORAGE
+# define YYPOOLSTORAGE _Thread_local
+#endif
+static YYPOOLSTORAGE yyParser *yyPool[YYPARSERPOOL];
+static YYPOOLSTORAGE int yyPoolCount = 0;
+
+/*
+** Take a parser from the pool of the calling thread, or allocate one
+** with mallocProc when the pool is empty.  The parser is in the state
+** ParseAlloc() leaves it in, except that it keeps the stack it grew
+** while parsing earlier inputs.
+*/
+void *ParsePoolAcquire(void *(*mallocProc)(YYMALLOCARGTYPE) ParseCTX_PDECL){
+  yyParser *yypParser;
+  if( yyPoolCount==0 ) return ParseAlloc(mallocProc ParseCTX_PARAM);
+  yypParser = yyPool[--yyPoolCount];
+  ParseCTX_STORE
+  return (void*)yypParser;
+}
+
+/*
+** Give a parser back to the pool of the calling thread, or free it with
+** freeProc when the pool is full.  What is left of its input is popped
+** with ParseReset(), while it is still traced, and then the settings of
+** its last user are dropped: its trace, the automatic dump of its flight
+** recorder, its stack policy and the stack buffer of the caller.
+*/
+void ParsePoolRelease(void *p, void (*freeProc)(void*)){
+  yyParser *pParser = (yyParser*)p;
+  if( p==0 ) return;
+  if( yyPoolCount>=YYPARSERPOOL ){
+    ParseFree(p, freeProc);
+    return;
+  }
+  ParseReset(p);
+#ifndef NDEBUG
+  pParser->yyTraceFILE = 0;
+  pParser->yyTracePrompt = 0;
+  pParser->yyTraceFilter.on = 0;
+#endif
+#ifdef YYFLIGHTRECORDER
+  pParser->yyfrOut = 0;
+#endif
+#if YYGROWABLESTACK
+  pParser->yygrowPercent = 200;
+  if( pParser->yystack==pParser->yystackUser ){
+    pParser->yystack = pParser->yystk0;
+    pParser->yystackEnd = &pParser->yystack[YYSTACKDEPTH-1];
+    pParser->yytos = pParser->yystack;
+    pParser->yystack[0].stateno = 0;
+    pParser->yystack[0].major = 0;
+  }
+  pParser->yystackUser = 0;
+#endif
+  yyPool[yyPoolCount++] = pParser;
+}
+
+/*
+** Free the parsers in the pool of the calling thread with freeProc.
+** A thread that released parsers calls it before it exits.
+*/
+void ParsePoolDrain(void (*freeProc)(void*)){
+  while( yyPoolCount>0 ){
+    ParseFree(yyPool[--yyPoolCount], freeProc);
+  }
+}
+#endif /* YYPARSERPOOL */
+
 /*
 ** Return the peak depth of the stack for a parser.
 */
@@ -494,6 +1018,16 @@ int ParseStackPeak(void *p){
 }
 #endif
 
+/*
+** Return the number of reductions a parser has performed.
+*/
+#ifdef YYTRACKREDUCECOUNT
+unsigned long long ParseReduceCount(void *p){
+  yyParser *pParser = (yyParser*)p;
+  return pParser->yynreduce;
+}
+#endif
+
 /* This array of booleans keeps track of the parser statement
 ** coverage.  The element yycoverage[X][Y] is set when the parser
 ** is in state X and has a lookahead token Y.  In a well-tested
@@ -531,16 +1065,59 @@ int ParseCoverage(FILE *out){
 }
 #endif
 
+/* These counters profile the parser, for all parsers of the program:
+** yyprofReduce[R] counts the reductions by rule R, yyprofShift[S]
+** the tokens shifted in state S, yyprofError[S] the syntax errors
+** detected in state S, and yyprofDepth is the deepest the stack of
+** any parser has been.
+*/
+#if defined(YYPROFILE)
+static unsigned long long yyprofReduce[YYNRULE];
+static unsigned long long yyprofShift[YYNSTATE];
+static unsigned long long yyprofError[YYNSTATE];
+static int yyprofDepth;
+#define yyProfileState(A,S)  ((S)<YYNSTATE ? (void)(A)[S]++ : (void)0)
+#define yyProfileDepth(P) \
+  ((int)((P)->yytos - (P)->yystack)>yyprofDepth ? \
+    (void)(yyprofDepth = (int)((P)->yytos - (P)->yystack)) : (void)0)
+#else
+# define yyProfileState(A,S)
+# define yyProfileDepth(P)
+#endif
+
+/*
+** Write the profile counters into out, as a "lemon-profile 1" line,
+** a "rules <n> states <n> depth <n>" line, a "rule <rule> <reductions>
+** <name>" line per rule and a "state <state> <shifts> <errors>" line
+** per state.
+*/
+#if defined(YYPROFILE)
+void ParseProfile(FILE *out){
+  int i;
+  fprintf(out,"lemon-profile 1\n");
+  fprintf(out,"rules %d states %d depth %d\n", YYNRULE, YYNSTATE, yyprofDepth);
+  for(i=0; i<YYNRULE; i++){
+    fprintf(out,"rule %d %llu %s\n", i, yyprofReduce[i], yyRuleName[i]);
+  }
+  for(i=0; i<YYNSTATE; i++){
+    fprintf(out,"state %d %llu %llu\n", i, yyprofShift[i], yyprofError[i]);
+  }
+}
+#endif
+
 /*
 ** Find the appropriate action for a parser given the terminal
 ** look-ahead token iLookAhead.
 */
-static YYACTIONTYPE yy_find_shift_action(
+static YYACTIONTYPE yy_find_shift_action_for(
+  const yyParser *yypParser, /* The parser, whose trace is used, or NULL */
   YYCODETYPE iLookAhead,    /* The look-ahead token */
   YYACTIONTYPE stateno      /* Current state number */
 ){
   int i;
 
+  (void)yypParser;
+
   if( stateno>YY_MAX_SHIFT ) return stateno;
   assert( stateno <= YY_SHIFT_COUNT );
 #if defined(YYCOVERAGE)
@@ -562,9 +1139,9 @@ static YYACTIONTYPE yy_find_shift_action(
       iFallback = yyFallback[iLookAhead];
       if( iFallback!=0 ){
 #ifndef NDEBUG
-        if( yyTraceFILE ){
-          fprintf(yyTraceFILE, "%sFALLBACK %s => %s\n",
-             yyTracePrompt, yyTokenName[iLookAhead], yyTokenName[iFallback]);
+        if( yyTraceOn(yypParser, YYEV_INPUT, -1) ){
+          fprintf(yyTraceOut(yypParser), "%sFALLBACK %s => %s\n",
+             yyTracePre(yypParser), yyTokenName[iLookAhead], yyTokenName[iFallback]);
         }
 #endif
         assert( yyFallback[iFallback]==0 ); /* Fallback loop must terminate */
@@ -578,9 +1155,9 @@ static YYACTIONTYPE yy_find_shift_action(
         assert( j<(int)(sizeof(yy_lookahead)/sizeof(yy_lookahead[0])) );
         if( yy_lookahead[j]==YYWILDCARD && iLookAhead>0 ){
 #ifndef NDEBUG
-          if( yyTraceFILE ){
-            fprintf(yyTraceFILE, "%sWILDCARD %s => %s\n",
-               yyTracePrompt, yyTokenName[iLookAhead],
+          if( yyTraceOn(yypParser, YYEV_INPUT, -1) ){
+            fprintf(yyTraceOut(yypParser), "%sWILDCARD %s => %s\n",
+               yyTracePre(yypParser), yyTokenName[iLookAhead],
                yyTokenName[YYWILDCARD]);
           }
 #endif /* NDEBUG */
@@ -596,6 +1173,9 @@ static YYACTIONTYPE yy_find_shift_action(
   }while(1);
 }
 
+/* Same as yy_find_shift_action_for(), with the global trace */
+#define yy_find_shift_action(X,Y) yy_find_shift_action_for(0,X,Y)
+
 /*
 ** Find the appropriate action for a parser given the non-terminal
 ** look-ahead token iLookAhead.
@@ -633,9 +1213,13 @@ static void yyStackOverflow(yyParser *yypParser){
    ParseARG_FETCH
    ParseCTX_FETCH
 #ifndef NDEBUG
-   if( yyTraceFILE ){
-     fprintf(yyTraceFILE,"%sStack Overflow!\n",yyTracePrompt);
+   if( yyTraceOn(yypParser, YYEV_OVERFLOW, -1) ){
+     fprintf(yyTraceOut(yypParser),"%sStack Overflow!\n",yyTracePre(yypParser));
    }
+#endif
+   yyTraceEvent(yypParser, YYEV_OVERFLOW, 0, 0, 0);
+#ifdef YYFLIGHTRECORDER
+   yypParser->yyfrPending = 1;
 #endif
    while( yypParser->yytos>yypParser->yystack ) yy_pop_parser_stack(yypParser);
    /* Here code is inserted which will execute if the parser
@@ -648,24 +1232,30 @@ static void yyStackOverflow(yyParser *yypParser){
 }
 
 /*
-** Print tracing information for a SHIFT action
+** Print tracing information for a SHIFT action, of a token, or of the
+** left-hand side of rule yyruleno if it is not negative
 */
 #ifndef NDEBUG
-static void yyTraceShift(yyParser *yypParser, int yyNewState, const char *zTag){
-  if( yyTraceFILE ){
+static void yyTraceShift(
+  yyParser *yypParser,
+  int yyNewState,
+  const char *zTag,
+  int yyruleno
+){
+  if( yyTraceOn(yypParser, yyruleno<0 ? YYEV_SHIFT : YYEV_GOTO, yyruleno) ){
     if( yyNewState<YYNSTATE ){
-      fprintf(yyTraceFILE,"%s%s '%s', go to state %d\n",
-         yyTracePrompt, zTag, yyTokenName[yypParser->yytos->major],
+      fprintf(yyTraceOut(yypParser),"%s%s '%s', go to state %d\n",
+         yyTracePre(yypParser), zTag, yyTokenName[yypParser->yytos->major],
          yyNewState);
     }else{
-      fprintf(yyTraceFILE,"%s%s '%s', pending reduce %d\n",
-         yyTracePrompt, zTag, yyTokenName[yypParser->yytos->major],
+      fprintf(yyTraceOut(yypParser),"%s%s '%s', pending reduce %d\n",
+         yyTracePre(yypParser), zTag, yyTokenName[yypParser->yytos->major],
          yyNewState - YY_MIN_REDUCE);
     }
   }
 }
 #else
-# define yyTraceShift(X,Y,Z)
+# define yyTraceShift(X,Y,Z,R)
 #endif
 
 /*
@@ -678,6 +1268,7 @@ static void yy_shift(
   ParseTOKENTYPE yyMinor        /* The minor token to shift in */
 ){
   yyStackEntry *yytos;
+  yyProfileState(yyprofShift, yypParser->yytos->stateno);
   yypParser->yytos++;
 #ifdef YYTRACKMAXSTACKDEPTH
   if( (int)(yypParser->yytos - yypParser->yystack)>yypParser->yyhwm ){
@@ -701,7 +1292,9 @@ static void yy_shift(
   yytos->stateno = yyNewState;
   yytos->major = yyMajor;
   yytos->minor.yy0 = yyMinor;
-  yyTraceShift(yypParser, yyNewState, "Shift");
+  yyTraceShift(yypParser, yyNewState, "Shift", -1);
+  yyTraceEvent(yypParser, YYEV_SHIFT, yyMajor, yyNewState, 0);
+  yyProfileDepth(yypParser);
 }
 
 /* For rule J, yyRuleInfoLhs[J] contains the symbol on the left-hand side
@@ -716,6 +1309,183 @@ static const signed char yyRuleInfoNRhs[] = {
 %%
 };
 
+#ifdef YYFLIGHTRECORDER
+/*
+** Apply an event of the flight recorder to a copy of the stack, without
+** its entry 0.  Only the events that move the stack change it.
+*/
+static void yyFlightApply(
+  yyFlightFrame *aFrame,        /* The copy of the stack */
+  int *pnFrame,                 /* Number of entries of the copy in use */
+  const yyFlightEvent *e        /* The event */
+){
+  switch( e->kind ){
+    case YYEV_SHIFT:
+    case YYEV_GOTO:
+      aFrame[*pnFrame].stateno = e->value;
+      aFrame[*pnFrame].major = e->major;
+      (*pnFrame)++;
+      break;
+    case YYEV_REDUCE:
+      *pnFrame += yyRuleInfoNRhs[e->value];
+      break;
+    case YYEV_POP:
+      (*pnFrame)--;
+      break;
+    case YYEV_ACCEPT:
+      *pnFrame = 0;
+      break;
+  }
+  assert( *pnFrame>=0 );
+}
+
+/*
+** Print an event of the flight recorder as the trace prints it
+*/
+static void yyFlightPrint(FILE *out, const yyFlightEvent *e){
+  switch( e->kind ){
+    case YYEV_INPUT:
+      if( e->value < YY_MIN_REDUCE ){
+        fprintf(out,"Input '%s' in state %d\n",yyTokenName[e->major],e->value);
+      }else{
+        fprintf(out,"Input '%s' with pending reduce %d\n",
+                yyTokenName[e->major],e->value-YY_MIN_REDUCE);
+      }
+      break;
+    case YYEV_SHIFT:
+    case YYEV_GOTO:
+      if( e->value<YYNSTATE ){
+        fprintf(out,"%s '%s', go to state %d\n",
+                e->kind==YYEV_SHIFT ? "Shift" : "... then shift",
+                yyTokenName[e->major], e->value);
+      }else{
+        fprintf(out,"%s '%s', pending reduce %d\n",
+                e->kind==YYEV_SHIFT ? "Shift" : "... then shift",
+                yyTokenName[e->major], e->value - YY_MIN_REDUCE);
+      }
+      break;
+    case YYEV_REDUCE:
+      if( yyRuleInfoNRhs[e->value] ){
+        fprintf(out,"Reduce %d [%s]%s, pop back to state %d.\n",
+                e->value, yyRuleName[e->value],
+                e->value<YYNRULE_WITH_ACTION ? "" : " without external action",
+                e->extra);
+      }else{
+        fprintf(out,"Reduce %d [%s]%s.\n",
+                e->value, yyRuleName[e->value],
+                e->value<YYNRULE_WITH_ACTION ? "" : " without external action");
+      }
+      break;
+    case YYEV_POP:
+      fprintf(out,"Popping %s\n",yyTokenName[e->major]);
+      break;
+    case YYEV_DISCARD:
+      fprintf(out,"Discard input token %s\n",yyTokenName[e->major]);
+      break;
+    case YYEV_ERROR:
+      fprintf(out,"Syntax Error!\n");
+      break;
+    case YYEV_ACCEPT:
+      fprintf(out,"Accept!\n");
+      break;
+    case YYEV_FAIL:
+      fprintf(out,"Fail!\n");
+      break;
+    case YYEV_OVERFLOW:
+      fprintf(out,"Stack Overflow!\n");
+      break;
+  }
+}
+
+/*
+** Write the events in the flight recorder of a parser to a stream, as
+** a trace that can be read like the one of ParseTrace().  The trace
+** starts at the oldest input still in the recorder, and first rebuilds
+** the stack at that point with one input and one shift per entry.
+**
+** Inputs:
+** <ul>
+** <li> A pointer to the parser.
+** <li> A FILE* to which the trace is written.
+** </ul>
+**
+** Outputs:
+** None.
+*/
+void ParseFlightDump(void *p, FILE *out){
+  yyParser *pParser = (yyParser*)p;
+  unsigned int iOldest = (pParser->yyfrNext - pParser->yyfrCount) & (YYFLIGHTRECORDER-1);
+  unsigned int i = 0;
+  int nFrame = pParser->yyfrBaseSize;
+  int j;
+  yyFlightFrame *aFrame;
+
+  /* The copy of the stack may grow by one entry per event */
+  aFrame = YYREALLOC(0, (nFrame+pParser->yyfrCount+1)*sizeof(aFrame[0]));
+  if( aFrame==0 ) return;
+  memcpy(aFrame, pParser->yyfrBase, nFrame*sizeof(aFrame[0]));
+  /* Events before the oldest input belong to a token whose input is
+  ** no longer recorded, so they only move the stack */
+  for(; i<pParser->yyfrCount; i++){
+    const yyFlightEvent *e = &pParser->yyfrRing[(iOldest+i) & (YYFLIGHTRECORDER-1)];
+    if( e->kind==YYEV_INPUT ) break;
+    yyFlightApply(aFrame, &nFrame, e);
+  }
+  for(j=0; j<nFrame; j++){
+    yyFlightEvent e;
+    e.kind = YYEV_INPUT;
+    e.major = aFrame[j].major;
+    e.value = j ? aFrame[j-1].stateno : 0;
+    e.extra = 0;
+    yyFlightPrint(out, &e);
+    e.kind = YYEV_SHIFT;
+    e.value = aFrame[j].stateno;
+    yyFlightPrint(out, &e);
+  }
+  for(; i<pParser->yyfrCount; i++){
+    yyFlightPrint(out, &pParser->yyfrRing[(iOldest+i) & (YYFLIGHTRECORDER-1)]);
+  }
+  fflush(out);
+  YYFREE(aFrame);
+}
+
+/*
+** Dump the flight recorder of a parser automatically to a stream, at the
+** end of the next call to Parse() that reports a syntax error, fails or
+** overflows the stack.  Only one dump is written; call this again to
+** get the next one.  ParseInit() and ParseAlloc() turn the automatic dump
+** off, so call this after them.
+**
+** Inputs:
+** <ul>
+** <li> A pointer to the parser.
+** <li> A FILE* to which the dump is written.  If NULL, the automatic
+**      dump is turned off.
+** </ul>
+**
+** Outputs:
+** None.
+*/
+void ParseFlightDumpOnError(void *p, FILE *out){
+  yyParser *pParser = (yyParser*)p;
+  pParser->yyfrOut = out;
+  pParser->yyfrPending = 0;
+}
+
+/*
+** Write the automatic dump of the flight recorder if one is due
+*/
+static void yyFlightAutoDump(yyParser *p){
+  if( p->yyfrPending && p->yyfrOut ){
+    ParseFlightDump(p, p->yyfrOut);
+    p->yyfrOut = 0;
+  }
+  p->yyfrPending = 0;
+}
+#else
+# define yyFlightAutoDump(P)
+#endif /* YYFLIGHTRECORDER */
+
 static void yy_accept(yyParser*);  /* Forward Declaration */
 
 /*
@@ -739,11 +1509,17 @@ static YYACTIONTYPE yy_reduce(
   YYACTIONTYPE yyact;             /* The next action */
   yyStackEntry *yymsp;            /* The top of the parser's stack */
   int yysize;                     /* Amount to pop the stack */
+#ifdef YYACTIONTIMING
+  long long yystart;              /* When the action started */
+#endif
   ParseARG_FETCH
   (void)yyLookahead;
   (void)yyLookaheadToken;
   yymsp = yypParser->yytos;
 
+#ifdef YYACTIONTIMING
+  yystart = YYACTIONCLOCK();
+#endif
   switch( yyruleno ){
   /* Beginning here are the reduction cases.  A typical example
   ** follows:
@@ -757,6 +1533,15 @@ static YYACTIONTYPE yy_reduce(
 %%
 /********** End reduce actions ************************************************/
   };
+#ifdef YYACTIONTIMING
+  if( yyruleno<YYNRULE_WITH_ACTION
+   && yyTraceOn(yypParser, YYEV_REDUCE, (int)yyruleno) ){
+    long long yyns = YYACTIONCLOCK() - yystart;
+    fprintf(yyTraceOut(yypParser),"%sAction of rule %d took %d ns.\n",
+      yyTracePre(yypParser), yyruleno,
+      yyns>0x7fffffff ? 0x7fffffff : (int)yyns);
+  }
+#endif
   assert( yyruleno<sizeof(yyRuleInfoLhs)/sizeof(yyRuleInfoLhs[0]) );
   yygoto = yyRuleInfoLhs[yyruleno];
   yysize = yyRuleInfoNRhs[yyruleno];
@@ -773,7 +1558,9 @@ static YYACTIONTYPE yy_reduce(
   yypParser->yytos = yymsp;
   yymsp->stateno = (YYACTIONTYPE)yyact;
   yymsp->major = (YYCODETYPE)yygoto;
-  yyTraceShift(yypParser, yyact, "... then shift");
+  yyTraceShift(yypParser, yyact, "... then shift", (int)yyruleno);
+  yyTraceEvent(yypParser, YYEV_GOTO, yygoto, yyact, 0);
+  yyProfileDepth(yypParser);
   return yyact;
 }
 
@@ -787,9 +1574,13 @@ static void yy_parse_failed(
   ParseARG_FETCH
   ParseCTX_FETCH
 #ifndef NDEBUG
-  if( yyTraceFILE ){
-    fprintf(yyTraceFILE,"%sFail!\n",yyTracePrompt);
+  if( yyTraceOn(yypParser, YYEV_FAIL, -1) ){
+    fprintf(yyTraceOut(yypParser),"%sFail!\n",yyTracePre(yypParser));
   }
+#endif
+  yyTraceEvent(yypParser, YYEV_FAIL, 0, 0, 0);
+#ifdef YYFLIGHTRECORDER
+  yypParser->yyfrPending = 1;
 #endif
   while( yypParser->yytos>yypParser->yystack ) yy_pop_parser_stack(yypParser);
   /* Here code is inserted which will be executed whenever the
@@ -812,6 +1603,9 @@ static void yy_syntax_error(
 ){
   ParseARG_FETCH
   ParseCTX_FETCH
+#ifdef YYFLIGHTRECORDER
+  yypParser->yyfrPending = 1;
+#endif
 #define TOKEN yyminor
 /************ Begin %syntax_error code ****************************************/
 %%
@@ -829,10 +1623,11 @@ static void yy_accept(
   ParseARG_FETCH
   ParseCTX_FETCH
 #ifndef NDEBUG
-  if( yyTraceFILE ){
-    fprintf(yyTraceFILE,"%sAccept!\n",yyTracePrompt);
+  if( yyTraceOn(yypParser, YYEV_ACCEPT, -1) ){
+    fprintf(yyTraceOut(yypParser),"%sAccept!\n",yyTracePre(yypParser));
   }
 #endif
+  yyTraceEvent(yypParser, YYEV_ACCEPT, 0, 0, 0);
 #ifndef YYNOERRORRECOVERY
   yypParser->yyerrcnt = -1;
 #endif
@@ -846,42 +1641,25 @@ static void yy_accept(
   ParseCTX_STORE
 }
 
-/* The main parser program.
-** The first argument is a pointer to a structure obtained from
-** "ParseAlloc" which describes the current state of the parser.
-** The second argument is the major token number.  The third is
-** the minor token.  The fourth optional argument is whatever the
-** user wants (and specified in the grammar) and is available for
-** use by the action routines.
-**
-** Inputs:
-** <ul>
-** <li> A pointer to the parser (an opaque structure.)
-** <li> The major token number.
-** <li> The minor token number.
-** <li> An option argument of a grammar-specified type.
-** </ul>
-**
-** Outputs:
-** None.
+/* Run the parser on a single token, once the %extra_argument
+** has been stored in the parser.  Return true if the token ended
+** the parse, by accepting the input or failing.
 */
-void Parse(
-  void *yyp,                   /* The parser */
+static int yy_parse_token(
+  yyParser *yypParser,         /* The parser */
   int yymajor,                 /* The major token code number */
   ParseTOKENTYPE yyminor       /* The value for the token */
-  ParseARG_PDECL               /* Optional %extra_argument parameter */
 ){
   YYMINORTYPE yyminorunion;
   YYACTIONTYPE yyact;   /* The parser action. */
+  int yyended = 0;      /* True once the parse is accepted or failed */
 #if !defined(YYERRORSYMBOL) && !defined(YYNOERRORRECOVERY)
   int yyendofinput;     /* True if we are at the end of input */
 #endif
 #ifdef YYERRORSYMBOL
   int yyerrorhit = 0;   /* True if yymajor has invoked an error */
 #endif
-  yyParser *yypParser = (yyParser*)yyp;  /* The parser */
   ParseCTX_FETCH
-  ParseARG_STORE
 
   assert( yypParser->yytos!=0 );
 #if !defined(YYERRORSYMBOL) && !defined(YYNOERRORRECOVERY)
@@ -890,40 +1668,49 @@ void Parse(
 
   yyact = yypParser->yytos->stateno;
 #ifndef NDEBUG
-  if( yyTraceFILE ){
+  if( yyTraceOut(yypParser) && yyTraceFlt(yypParser)->on
+   && yypParser->yytos==yypParser->yystack ){
+    /* Tell readers of the trace that steps of this input are missing */
+    fprintf(yyTraceOut(yypParser),"%sFiltered trace.\n",
+            yyTracePre(yypParser));
+  }
+  if( yyTraceOn(yypParser, YYEV_INPUT, -1) ){
     if( yyact < YY_MIN_REDUCE ){
-      fprintf(yyTraceFILE,"%sInput '%s' in state %d\n",
-              yyTracePrompt,yyTokenName[yymajor],yyact);
+      fprintf(yyTraceOut(yypParser),"%sInput '%s' in state %d\n",
+              yyTracePre(yypParser),yyTokenName[yymajor],yyact);
     }else{
-      fprintf(yyTraceFILE,"%sInput '%s' with pending reduce %d\n",
-              yyTracePrompt,yyTokenName[yymajor],yyact-YY_MIN_REDUCE);
+      fprintf(yyTraceOut(yypParser),"%sInput '%s' with pending reduce %d\n",
+              yyTracePre(yypParser),yyTokenName[yymajor],yyact-YY_MIN_REDUCE);
     }
   }
 #endif
+  yyTraceEvent(yypParser, YYEV_INPUT, yymajor, yyact, 0);
 
   while(1){ /* Exit by "break" */
     assert( yypParser->yytos>=yypParser->yystack );
     assert( yyact==yypParser->yytos->stateno );
-    yyact = yy_find_shift_action((YYCODETYPE)yymajor,yyact);
+    yyact = yy_find_shift_action_for(yypParser,(YYCODETYPE)yymajor,yyact);
     if( yyact >= YY_MIN_REDUCE ){
       unsigned int yyruleno = yyact - YY_MIN_REDUCE; /* Reduce by this rule */
 #ifndef NDEBUG
       assert( yyruleno<(int)(sizeof(yyRuleName)/sizeof(yyRuleName[0])) );
-      if( yyTraceFILE ){
+      if( yyTraceOn(yypParser, YYEV_REDUCE, (int)yyruleno) ){
         int yysize = yyRuleInfoNRhs[yyruleno];
         if( yysize ){
-          fprintf(yyTraceFILE, "%sReduce %d [%s]%s, pop back to state %d.\n",
-            yyTracePrompt,
+          fprintf(yyTraceOut(yypParser), "%sReduce %d [%s]%s, pop back to state %d.\n",
+            yyTracePre(yypParser),
             yyruleno, yyRuleName[yyruleno],
             yyruleno<YYNRULE_WITH_ACTION ? "" : " without external action",
             yypParser->yytos[yysize].stateno);
         }else{
-          fprintf(yyTraceFILE, "%sReduce %d [%s]%s.\n",
-            yyTracePrompt, yyruleno, yyRuleName[yyruleno],
+          fprintf(yyTraceOut(yypParser), "%sReduce %d [%s]%s.\n",
+            yyTracePre(yypParser), yyruleno, yyRuleName[yyruleno],
             yyruleno<YYNRULE_WITH_ACTION ? "" : " without external action");
         }
       }
 #endif /* NDEBUG */
+      yyTraceEvent(yypParser, YYEV_REDUCE, yyRuleInfoLhs[yyruleno], yyruleno,
+               yypParser->yytos[yyRuleInfoNRhs[yyruleno]].stateno);
 
       /* Check that the stack is large enough to grow by a single entry
       ** if the RHS of the rule is empty.  This ensures that there is room
@@ -943,6 +1730,12 @@ void Parse(
           }
         }
       }
+#ifdef YYTRACKREDUCECOUNT
+      yypParser->yynreduce++;
+#endif
+#ifdef YYPROFILE
+      yyprofReduce[yyruleno]++;
+#endif
       yyact = yy_reduce(yypParser,yyruleno,yymajor,yyminor ParseCTX_PARAM);
     }else if( yyact <= YY_MAX_SHIFTREDUCE ){
       yy_shift(yypParser,yyact,(YYCODETYPE)yymajor,yyminor);
@@ -953,7 +1746,8 @@ void Parse(
     }else if( yyact==YY_ACCEPT_ACTION ){
       yypParser->yytos--;
       yy_accept(yypParser);
-      return;
+      yyFlightAutoDump(yypParser);
+      return 1;
     }else{
       assert( yyact == YY_ERROR_ACTION );
       yyminorunion.yy0 = yyminor;
@@ -961,10 +1755,12 @@ void Parse(
       int yymx;
 #endif
 #ifndef NDEBUG
-      if( yyTraceFILE ){
-        fprintf(yyTraceFILE,"%sSyntax Error!\n",yyTracePrompt);
+      if( yyTraceOn(yypParser, YYEV_ERROR, -1) ){
+        fprintf(yyTraceOut(yypParser),"%sSyntax Error!\n",yyTracePre(yypParser));
       }
 #endif
+      yyTraceEvent(yypParser, YYEV_ERROR, 0, 0, 0);
+      yyProfileState(yyprofError, yypParser->yytos->stateno);
 #ifdef YYERRORSYMBOL
       /* A syntax error has occurred.
       ** The response to an error depends upon whether or not the
@@ -991,11 +1787,12 @@ void Parse(
       yymx = yypParser->yytos->major;
       if( yymx==YYERRORSYMBOL || yyerrorhit ){
 #ifndef NDEBUG
-        if( yyTraceFILE ){
-          fprintf(yyTraceFILE,"%sDiscard input token %s\n",
-             yyTracePrompt,yyTokenName[yymajor]);
+        if( yyTraceOn(yypParser, YYEV_DISCARD, -1) ){
+          fprintf(yyTraceOut(yypParser),"%sDiscard input token %s\n",
+             yyTracePre(yypParser),yyTokenName[yymajor]);
         }
 #endif
+        yyTraceEvent(yypParser, YYEV_DISCARD, yymajor, 0, 0);
         yy_destructor(yypParser, (YYCODETYPE)yymajor, &yyminorunion);
         yymajor = YYNOCODE;
       }else{
@@ -1011,6 +1808,7 @@ void Parse(
 #ifndef YYNOERRORRECOVERY
           yypParser->yyerrcnt = -1;
 #endif
+          yyended = 1;
           yymajor = YYNOCODE;
         }else if( yymx!=YYERRORSYMBOL ){
           yy_shift(yypParser,yyact,YYERRORSYMBOL,yyminor);
@@ -1051,24 +1849,89 @@ void Parse(
 #ifndef YYNOERRORRECOVERY
         yypParser->yyerrcnt = -1;
 #endif
+        yyended = 1;
       }
       break;
 #endif
     }
   }
 #ifndef NDEBUG
-  if( yyTraceFILE ){
+  if( yyTraceOut(yypParser) && !yyTraceFlt(yypParser)->on ){
     yyStackEntry *i;
     char cDiv = '[';
-    fprintf(yyTraceFILE,"%sReturn. Stack=",yyTracePrompt);
+    fprintf(yyTraceOut(yypParser),"%sReturn. Stack=",yyTracePre(yypParser));
     for(i=&yypParser->yystack[1]; i<=yypParser->yytos; i++){
-      fprintf(yyTraceFILE,"%c%s", cDiv, yyTokenName[i->major]);
+      fprintf(yyTraceOut(yypParser),"%c%s", cDiv, yyTokenName[i->major]);
       cDiv = ' ';
     }
-    fprintf(yyTraceFILE,"]\n");
+    fprintf(yyTraceOut(yypParser),"]\n");
   }
 #endif
-  return;
+  yyFlightAutoDump(yypParser);
+  return yyended;
+}
+
+/* The main parser program.
+** The first argument is a pointer to a structure obtained from
+** "ParseAlloc" which describes the current state of the parser.
+** The second argument is the major token number.  The third is
+** the minor token.  The fourth optional argument is whatever the
+** user wants (and specified in the grammar) and is available for
+** use by the action routines.
+**
+** Inputs:
+** <ul>
+** <li> A pointer to the parser (an opaque structure.)
+** <li> The major token number.
+** <li> The minor token number.
+** <li> An option argument of a grammar-specified type.
+** </ul>
+**
+** Outputs:
+** None.
+*/
+void Parse(
+  void *yyp,                   /* The parser */
+  int yymajor,                 /* The major token code number */
+  ParseTOKENTYPE yyminor       /* The value for the token */
+  ParseARG_PDECL               /* Optional %extra_argument parameter */
+){
+  yyParser *yypParser = (yyParser*)yyp;  /* The parser */
+  ParseARG_STORE
+  yy_parse_token(yypParser, yymajor, yyminor);
+}
+
+/* Run the parser on an array of tokens, as successive calls to Parse()
+** would, but without leaving the parser between tokens.  If the minor
+** tokens are NULL, every token gets a zero value.
+**
+** Stop after the token that makes the parser accept the input or fail,
+** so that the caller can start the next parse from the following token.
+** Return the number of tokens consumed, which is n unless the parse
+** ended early.
+*/
+size_t ParseTokens(
+  void *yyp,                     /* The parser */
+  const int *yymajors,           /* The major token code numbers */
+  ParseTOKENTYPE const *yyminors,/* Their values, or NULL */
+  size_t yyn                     /* Number of tokens */
+  ParseARG_PDECL                 /* Optional %extra_argument parameter */
+){
+  yyParser *yypParser = (yyParser*)yyp;  /* The parser */
+  size_t yyi;
+  ParseARG_STORE
+  if( yyminors==0 ){
+    YYMINORTYPE yyzero;
+    memset(&yyzero, 0, sizeof(yyzero));
+    for(yyi=0; yyi<yyn; yyi++){
+      if( yy_parse_token(yypParser, yymajors[yyi], yyzero.yy0) ) return yyi+1;
+    }
+  }else{
+    for(yyi=0; yyi<yyn; yyi++){
+      if( yy_parse_token(yypParser, yymajors[yyi], yyminors[yyi]) ) return yyi+1;
+    }
+  }
+  return yyn;
 }
 
 /*
@@ -140,19 +140,35 @@ void ascii_target::footer(parser_termination_cause cause) {
 }
 
 void ascii_target::input_token(const std::string_view& name) {
+    if (filteredTrace) {
+        *ostr << "  Input " << name << '\n';
+        return;
+    }
     // Postpone printing of the token until after pending reduce is handled
     pendingInput = name;
 }
 
 void ascii_target::shift(int nextState) {
+    if (filteredTrace) {
+        *ostr << "  Shift, go to state " << nextState << '\n';
+        return;
+    }
     shift_frame(nextState);
 }
 
 void ascii_target::shift_reduce() {
+    if (filteredTrace) {
+        *ostr << "  Shift, pending reduce\n";
+        return;
+    }
     shift_frame(std::nullopt);
 }
 
 void ascii_target::syntax_error() {
+    if (filteredTrace) {
+        *ostr << "  Syntax error\n";
+        return;
+    }
     // Syntax error means the new token was not expected in this state,
     // so it should be printed by now
     flush_input_token();
@@ -163,6 +179,10 @@ void ascii_target::syntax_error() {
 }
 
 void ascii_target::reduce(size_t count, const std::string_view& tokenName, const std::string_view& ruleName) {
+    if (filteredTrace) {
+        *ostr << "  Reduce [" << ruleName << "]\n";
+        return;
+    }
     // Indicate that a token has been read from the input,
     // unless the topmost frame is a pending reduce,
     // in which case the rule can be reduced before seeing that token
@@ -189,6 +209,14 @@ void ascii_target::reduce(size_t count, const std::string_view& tokenName, const
 }
 
 void ascii_target::pop() {
+    if (filteredTrace) {
+        *ostr << "  Pop\n";
+        return;
+    }
+    // The parser empties its stack after it fails, but the footer
+    // has already shown every state as discarded
+    if (stackContents.empty())
+        return;
     // Popping a token only makes sense in the context of error recovery
     if (!pendingSyntaxError)
         throw std::logic_error(__FUNCTION__);
@@ -198,6 +226,10 @@ void ascii_target::pop() {
 }
 
 void ascii_target::discard() {
+    if (filteredTrace) {
+        *ostr << "  Discard input token\n";
+        return;
+    }
     // Cannot discard a token when there are not any
     if (!pendingToken)
         throw std::logic_error(__FUNCTION__);
@@ -219,14 +251,26 @@ void ascii_target::discard() {
 }
 
 void ascii_target::accept() {
+    if (filteredTrace) {
+        *ostr << "  Accept\n";
+        return;
+    }
     footer(parser_termination_cause::accept);
 }
 
 void ascii_target::failure() {
+    if (filteredTrace) {
+        *ostr << "  Failure\n";
+        return;
+    }
     footer(parser_termination_cause::failure);
 }
 
 void ascii_target::stack_overflow() {
+    if (filteredTrace) {
+        *ostr << "  Stack overflow\n";
+        return;
+    }
     // Overflow may occurr by attempting to shift a new token
     // or the error nonterminal (or a different nonterminal,
     // but those have already been printed)
@@ -235,7 +279,42 @@ void ascii_target::stack_overflow() {
     footer(parser_termination_cause::stack_overflow);
 }
 
+void ascii_target::action_time(std::chrono::nanoseconds) {
+    // Timings have no place in the visualization
+}
+
+void ascii_target::stack_growth(size_t, size_t newSize, size_t entrySize) {
+    ++stackGrowths;
+    stackSize = newSize;
+    stackBytes += newSize * entrySize;
+}
+
+void ascii_target::filtered() {
+    // Each input of a filtered trace says so, but the notice is only needed once
+    if (filteredTrace)
+        return;
+    filteredTrace = true;
+    *ostr << "Filtered trace, only the traced steps are listed:\n";
+}
+
 void ascii_target::finalize() {
+    // A trace that stops during error recovery, such as a dump of the parser's
+    // flight recorder, still shows the error
+    if (pendingSyntaxError) {
+        blank_left_column();
+        right_column(state_fragment_data::row_kind::neutral);
+        fragments->syntax_error_label();
+        endl();
+        pendingSyntaxError = false;
+    }
+    // Growth is not drawn, but summed up to help size the stack
+    if (stackGrowths > 0) {
+        *ostr << "Stack grew " << stackGrowths << (stackGrowths == 1 ? " time" : " times")
+              << ", to " << stackSize << " entries";
+        if (stackBytes > 0)
+            *ostr << ", reallocating " << stackBytes << " bytes";
+        *ostr << '\n';
+    }
     ostr->flush();
 }
 
@@ -42,6 +42,15 @@ public:
     void accept() override;
     void failure() override;
     void stack_overflow() override;
+    void action_time(std::chrono::nanoseconds duration) override;
+    void stack_growth(size_t oldSize, size_t newSize, size_t entrySize) override;
+    /**
+     * @copydoc trace_action_sink::filtered
+     * 
+     * As the stack cannot be drawn without all steps,
+     * the steps that follow are listed instead
+     */
+    void filtered() override;
     void finalize() override;
 
 private:
@@ -122,8 +131,12 @@ private:
     bool pendingToken = false;
     bool pendingNonterminal = false;
     bool pendingSyntaxError = false;
+    bool filteredTrace = false;
     size_t errorRecoveryPopped = 0;
     size_t lineIndex = 0;
+    size_t stackGrowths = 0;
+    size_t stackSize = 0;
+    size_t stackBytes = 0;
     std::string pendingInput;
 };
 
@@ -7,6 +7,7 @@
 
 #include "default_target_factory.hpp"
 #include "ascii_target_factory_module.hpp"
+#include "latency_target_factory_module.hpp"
 
 namespace dmalem {
 
@@ -14,6 +15,7 @@ target_factory default_target_factory(std::ostream& ostr) {
     target_factory factory;
     factory.add_module("", std::make_unique<ascii_target_factory_module>(ostr));
     factory.add_module("ascii", std::make_unique<ascii_target_factory_module>(ostr));
+    factory.add_module("latency", std::make_unique<latency_target_factory_module>(ostr));
     return factory;
 }
 
@@ -49,6 +49,25 @@ static void reduce(trace_action_sink& sink, const std::vector<string_pattern::fi
     sink.reduce(separatorCount - 1, targetName, ruleText);
 }
 
+/**
+ * Pattern handler for notifications of stack growth
+ */
+static void stack_growth(trace_action_sink& sink, const std::vector<string_pattern::field>& fields) {
+    const int oldSize = std::get<int>(fields.at(0));
+    const int newSize = std::get<int>(fields.at(1));
+    // Older parsers do not tell the size of an entry
+    const int entrySize = fields.size() > 2 ? std::get<int>(fields.at(2)) : 0;
+    sink.stack_growth(oldSize, newSize, entrySize);
+}
+
+/**
+ * Pattern handler for the times of reduce actions
+ */
+static void action_time(trace_action_sink& sink, const std::vector<string_pattern::field>& fields) {
+    const int nanoseconds = std::get<int>(fields.at(1));
+    sink.action_time(std::chrono::nanoseconds(nanoseconds));
+}
+
 /**
  * Constructs a pattern handler that calls a method of the target
  * without any arguments
@@ -62,26 +81,29 @@ static auto method(void (trace_action_sink::* fun)()) {
 trace_parser<trace_action_sink> default_trace_parser() {
     trace_parser<trace_action_sink> parser;
     parser
-        .add_pattern("Stack grows from %d to %d entries.",                            nop)
-        .add_pattern("Popping %s",                                                    method(trace_action_sink::pop))
+        .add_pattern("Stack grows from %d to %d entries of %d bytes.",                stack_growth)
+        .add_pattern("Stack grows from %d to %d entries.",                            stack_growth)
+        .add_pattern("Popping %s",                                                    method(&trace_action_sink::pop))
         .add_pattern("FALLBACK %s => %s",                                             nop)
         .add_pattern("WILDCARD %s => %s",                                             nop)
-        .add_pattern("Stack Overflow!",                                               method(trace_action_sink::stack_overflow))
+        .add_pattern("Stack Overflow!",                                               method(&trace_action_sink::stack_overflow))
         .add_pattern("Shift '%S', go to state %d",                                    shift_state)
         .add_pattern("... then shift '%S', go to state %d",                           shift_state)
-        .add_pattern("Shift '%S', pending reduce %d",                                 method(trace_action_sink::shift_reduce))
-        .add_pattern("... then shift '%S', pending reduce %d",                        method(trace_action_sink::shift_reduce))
-        .add_pattern("Fail!",                                                         method(trace_action_sink::failure))
-        .add_pattern("Accept!",                                                       method(trace_action_sink::accept))
+        .add_pattern("Shift '%S', pending reduce %d",                                 method(&trace_action_sink::shift_reduce))
+        .add_pattern("... then shift '%S', pending reduce %d",                        method(&trace_action_sink::shift_reduce))
+        .add_pattern("Fail!",                                                         method(&trace_action_sink::failure))
+        .add_pattern("Accept!",                                                       method(&trace_action_sink::accept))
         .add_pattern("Input '%S' in state %d",                                        input_token)
         .add_pattern("Input '%S' with pending reduce %d",                             input_token)
         .add_pattern("Reduce %d [%S], pop back to state %d.",                         reduce)
         .add_pattern("Reduce %d [%S] without external action, pop back to state %d.", reduce)
         .add_pattern("Reduce %d [%S].",                                               reduce)
         .add_pattern("Reduce %d [%S] without external action.",                       reduce)
-        .add_pattern("Syntax Error!",                                                 method(trace_action_sink::syntax_error))
-        .add_pattern("Discard input token %s",                                        method(trace_action_sink::discard))
-        .add_pattern("Return. Stack=%S]",                                             nop);
+        .add_pattern("Syntax Error!",                                                 method(&trace_action_sink::syntax_error))
+        .add_pattern("Discard input token %s",                                        method(&trace_action_sink::discard))
+        .add_pattern("Action of rule %d took %d ns.",                                 action_time)
+        .add_pattern("Return. Stack=%S]",                                             nop)
+        .add_pattern("Filtered trace.",                                               method(&trace_action_sink::filtered));
     return parser;
 }
 
@@ -0,0 +1,123 @@
+/**
+ * @file latency_target.cpp
+ * 
+ * Implementation of @ref render_target that reports
+ * how long the actions of the parser's rules took
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+#include "latency_target.hpp"
+
+namespace dmalem {
+
+/**
+ * Width of the longest bar of the distribution, in characters
+ */
+static constexpr size_t barWidth = 40;
+
+/**
+ * Largest time held by a bucket, in nanoseconds
+ */
+static uint64_t bucket_limit(size_t bucket) {
+    return bucket == 0 ? 0 : (uint64_t(1) << bucket) - 1;
+}
+
+latency_target::latency_target(std::ostream& ostr, size_t ruleCount) :
+    ostr(&ostr),
+    ruleCount(ruleCount)
+{}
+
+void latency_target::reduce(size_t, const std::string_view&, const std::string_view& ruleName) {
+    auto it = rules.find(ruleName);
+    if (it == rules.end())
+        it = rules.emplace(ruleName, rule_times()).first;
+    lastRule = &it->second;
+}
+
+void latency_target::action_time(std::chrono::nanoseconds duration) {
+    if (!lastRule)
+        throw std::logic_error(__FUNCTION__);
+    const uint64_t nanoseconds = std::max<int64_t>(duration.count(), 0);
+    const size_t bucket = std::min<size_t>(std::bit_width(nanoseconds), allRules.buckets.size() - 1);
+    for (rule_times* times : {lastRule, &allRules}) {
+        ++times->count;
+        times->total += duration;
+        times->max = std::max(times->max, duration);
+        ++times->buckets[bucket];
+    }
+}
+
+uint64_t latency_target::percentile(const histogram& buckets, uint64_t count, double share) {
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(count * share)));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank)
+            return bucket_limit(bucket);
+    }
+    return bucket_limit(buckets.size() - 1);
+}
+
+void latency_target::print_rules() {
+    std::vector<const std::pair<const std::string, rule_times>*> timed;
+    for (const auto& rule : rules)
+        if (rule.second.count > 0)
+            timed.push_back(&rule);
+    std::ranges::stable_sort(timed, [](const auto* a, const auto* b) {
+        return a->second.total > b->second.total;
+    });
+    if (timed.size() > ruleCount)
+        timed.resize(ruleCount);
+
+    *ostr << std::setw(10) << "Actions"
+          << std::setw(13) << "Total (us)"
+          << std::setw(11) << "Mean (ns)"
+          << std::setw(11) << "p50 (ns)"
+          << std::setw(11) << "p99 (ns)"
+          << std::setw(11) << "Max (ns)"
+          << "  Rule\n";
+    for (const auto* rule : timed) {
+        const rule_times& times = rule->second;
+        *ostr << std::setw(10) << times.count
+              << std::setw(13) << std::fixed << std::setprecision(1) << times.total.count() / 1000.0
+              << std::setw(11) << times.total.count() / static_cast<int64_t>(times.count)
+              << std::setw(11) << "<=" + std::to_string(percentile(times.buckets, times.count, 0.5))
+              << std::setw(11) << "<=" + std::to_string(percentile(times.buckets, times.count, 0.99))
+              << std::setw(11) << times.max.count()
+              << "  " << rule->first << '\n';
+    }
+}
+
+void latency_target::print_distribution() {
+    const auto& buckets = allRules.buckets;
+    auto nonEmpty = [](uint64_t n) { return n > 0; };
+    const size_t first = std::ranges::find_if(buckets, nonEmpty) - buckets.begin();
+    const size_t last = buckets.rend() - std::find_if(buckets.rbegin(), buckets.rend(), nonEmpty) - 1;
+    const uint64_t highest = std::ranges::max(buckets);
+
+    *ostr << "\nTimes of all " << allRules.count << " actions:\n";
+    for (size_t bucket = first; bucket <= last; ++bucket) {
+        const uint64_t low = bucket == 0 ? 0 : bucket_limit(bucket - 1) + 1;
+        const size_t width = (buckets[bucket] * barWidth + highest - 1) / highest;
+        *ostr << std::setw(10) << low << " - " << std::setw(10) << bucket_limit(bucket) << " ns |"
+              << std::string(width, '#') << std::string(barWidth - width, ' ') << "| "
+              << buckets[bucket] << '\n';
+    }
+}
+
+void latency_target::finalize() {
+    if (allRules.count == 0) {
+        *ostr << "No action times in the trace, as no rule with action code was reduced\n";
+    } else {
+        print_rules();
+        print_distribution();
+    }
+    ostr->flush();
+}
+
+}
@@ -0,0 +1,99 @@
+/**
+ * @file latency_target.hpp
+ * 
+ * Implementation of @ref render_target that reports
+ * how long the actions of the parser's rules took
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include "render_target.hpp"
+
+namespace dmalem {
+
+/**
+ * Implementation of @ref render_target that collects the times of reduce actions,
+ * as traced by parsers built with `YYACTIONTIMING`, and reports the rules
+ * that took the longest in total and the distribution of all times
+ * 
+ * Times are kept in power-of-two buckets, so percentiles are reported
+ * as the upper bound of their bucket
+ */
+class latency_target : public render_target {
+public:
+    /**
+     * Constructs a latency render target that reports to a stream
+     * 
+     * @param ostr      The stream for the target to report to.
+     *                  Must outlive the target
+     * @param ruleCount How many of the slowest rules to report
+     */
+    latency_target(std::ostream& ostr, size_t ruleCount);
+
+    void input_token(const std::string_view&) override {}
+    void shift(int) override {}
+    void shift_reduce() override {}
+    void syntax_error() override {}
+    void reduce(size_t count, const std::string_view& tokenName, const std::string_view& ruleName) override;
+    void pop() override {}
+    void discard() override {}
+    void accept() override {}
+    void failure() override {}
+    void stack_overflow() override {}
+    /**
+     * @copydoc trace_action_sink::action_time
+     * @throw std::logic_error No rule has been reduced yet
+     */
+    void action_time(std::chrono::nanoseconds duration) override;
+    void stack_growth(size_t, size_t, size_t) override {}
+    void filtered() override {}
+    void finalize() override;
+
+private:
+    /**
+     * Bucket `b` holds the times of `2^(b-1)` to `2^b - 1` nanoseconds,
+     * and bucket 0 the times of 0 nanoseconds
+     */
+    using histogram = std::array<uint64_t, 33>;
+
+    /**
+     * Times of the actions of one rule
+     */
+    struct rule_times {
+        uint64_t count = 0;
+        std::chrono::nanoseconds total{0};
+        std::chrono::nanoseconds max{0};
+        histogram buckets{};
+    };
+
+    /**
+     * Time below which a share of the actions of a histogram ran
+     * 
+     * @param buckets The histogram
+     * @param count   Number of actions in the histogram
+     * @param share   The share, between 0 and 1
+     * @return        Upper bound of the bucket that holds the percentile, in nanoseconds
+     */
+    static uint64_t percentile(const histogram& buckets, uint64_t count, double share);
+    /**
+     * Prints the slowest rules
+     */
+    void print_rules();
+    /**
+     * Prints the distribution of the times of all actions
+     */
+    void print_distribution();
+
+    std::ostream* ostr;
+    size_t ruleCount;
+    std::map<std::string, rule_times, std::less<>> rules;
+    rule_times* lastRule = nullptr;
+    rule_times allRules;
+};
+
+}
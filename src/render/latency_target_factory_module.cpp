@@ -0,0 +1,41 @@
+/**
+ * @file latency_target_factory_module.cpp
+ * 
+ * @ref target_factory_module that creates render targets
+ * that report the times of the parser's reduce actions
+ */
+
+#include <charconv>
+#include "latency_target_factory_module.hpp"
+#include "latency_target.hpp"
+
+namespace dmalem {
+
+latency_target_factory_module::latency_target_factory_module(std::ostream& ostr) :
+    ostr(&ostr)
+{}
+
+std::unique_ptr<render_target> latency_target_factory_module::create_render_target() const {
+    return std::make_unique<latency_target>(*ostr, ruleCount);
+}
+
+void latency_target_factory_module::set_options(const std::vector<std::string>& options) {
+    size_t newRuleCount = 0;
+
+    for (const auto& option : options) {
+        if (option.starts_with("top=")) {
+            if (newRuleCount)
+                throw bad_render_target_options(option);
+            auto result = std::from_chars(&option[4], &option.back() + 1, newRuleCount);
+            if (result.ec != std::errc() || result.ptr != &option.back() + 1 || newRuleCount == 0)
+                throw bad_render_target_options(option);
+        } else {
+            throw bad_render_target_options(option);
+        }
+    }
+
+    if (newRuleCount)
+        ruleCount = newRuleCount;
+}
+
+}
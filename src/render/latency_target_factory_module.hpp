@@ -0,0 +1,40 @@
+/**
+ * @file latency_target_factory_module.hpp
+ * 
+ * @ref target_factory_module that creates render targets
+ * that report the times of the parser's reduce actions
+ */
+
+#pragma once
+
+#include <iostream>
+#include "target_factory_module.hpp"
+
+namespace dmalem {
+
+/**
+ * @ref target_factory_module that creates latency render targets
+ * 
+ * ## Render Target Options
+ * | Option    | Description                                      |
+ * |-----------|--------------------------------------------------|
+ * | `top=<n>` | Sets how many of the slowest rules are reported  |
+ */
+class latency_target_factory_module : public target_factory_module {
+public:
+    /**
+     * Constructs a new latency render target factory
+     * 
+     * @param ostr Stream that all render targets created by the factory
+     * will report to. Must outlive all render targets created by the factory
+     */
+    latency_target_factory_module(std::ostream& ostr);
+
+    std::unique_ptr<render_target> create_render_target() const override;
+    void set_options(const std::vector<std::string>& options) override;
+private:
+    std::ostream* ostr;
+    size_t ruleCount = 10;
+};
+
+}
@@ -30,10 +30,22 @@ bool string_pattern::is_pattern_character(char c) noexcept {
     return c == '%' || c == 'd' || c == 's' || c == 'S';
 }
 
-bool string_pattern::match(const std::string_view& target, std::vector<field>* fields) const {
+/**
+ * Matches a string against a pattern, appending the captured values
+ * 
+ * @param      pattern A valid pattern string
+ * @param      target  The input string to be matched against the pattern
+ * @param[out] fields  If not null, the captured values are appended to it,
+ *                     including those captured before a failed match
+ * @return             True if the pattern successfully matched, false othwerise
+ */
+static bool match_into(
+    const std::string& pattern,
+    const std::string_view& target,
+    std::vector<string_pattern::field>* fields
+) {
     string_reader t(target);
     t.take_ws();
-    std::vector<field> parsedFields;
     for (auto it = pattern.begin(); it != pattern.end(); ++it) {
         switch (*it) {
             case ' ': {
@@ -56,14 +68,16 @@ bool string_pattern::match(const std::string_view& target, std::vector<field>* f
                         int value;
                         if (!t.take_int(value))
                             return false;
-                        parsedFields.push_back(value);
+                        if (fields)
+                            fields->push_back(value);
                         break;
                     }
                     case 's': {
                         std::string_view token;
                         if (!t.take_token(token))
                             return false;
-                        parsedFields.push_back(token);
+                        if (fields)
+                            fields->push_back(token);
                         break;
                     }
                     case 'S': {
@@ -72,7 +86,8 @@ bool string_pattern::match(const std::string_view& target, std::vector<field>* f
                             span = t.take_all();
                         else if (!t.take_until(*std::next(it), span))
                             return false;
-                        parsedFields.push_back(span);
+                        if (fields)
+                            fields->push_back(span);
                         break;
                     }
                     default: {
@@ -91,10 +106,21 @@ bool string_pattern::match(const std::string_view& target, std::vector<field>* f
         }
     }
     t.take_ws();
-    if (!t.is_done())
+    return t.is_done();
+}
+
+bool string_pattern::match(const std::string_view& target, std::vector<field>* fields) const {
+    // Capture into the output vector directly, so that its capacity is reused
+    const size_t previousCount = fields ? fields->size() : 0;
+    if (!match_into(pattern, target, fields)) {
+        // Leave the output as it was
+        if (fields)
+            fields->erase(fields->begin() + previousCount, fields->end());
         return false;
+    }
+    // Only the values from this match remain
     if (fields)
-        *fields = std::move(parsedFields);
+        fields->erase(fields->begin(), fields->begin() + previousCount);
     return true;
 }
 
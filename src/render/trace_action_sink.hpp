@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <string_view>
 
 namespace dmalem {
@@ -72,6 +73,28 @@ public:
      * Notifies the observer that the parser has overflown its stack limit
      */
     virtual void stack_overflow() = 0;
+    /**
+     * Notifies the observer of how long the action code of the rule
+     * that has just been reduced took to run
+     * 
+     * @param duration Time spent in the action
+     */
+    virtual void action_time(std::chrono::nanoseconds duration) = 0;
+    /**
+     * Notifies the observer that the parser has moved its stack
+     * to a larger allocation
+     * 
+     * @param oldSize   Number of entries before the growth
+     * @param newSize   Number of entries after the growth
+     * @param entrySize Size of an entry in bytes, or 0 if the trace does not tell
+     */
+    virtual void stack_growth(size_t oldSize, size_t newSize, size_t entrySize) = 0;
+    /**
+     * Notifies the observer that the parser filters its trace,
+     * so that the steps it is notified of from now on are only some of them,
+     * and do not necessarily follow each other
+     */
+    virtual void filtered() = 0;
 };
 
 }
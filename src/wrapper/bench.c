@@ -0,0 +1,73 @@
+/**
+ * @file bench.c
+ * 
+ * Template file for the wrapper that measures the throughput
+ * of a parser, with tracing compiled out
+ * 
+ * Usage: `wrapper_bench [repeat] [tokenFile]`
+ * 
+ * The input tokens are parsed `repeat` times over, by the same parser.
+ * If a token file is given, its whitespace-separated token numbers
+ * are parsed instead of the tokens built into the wrapper
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <assert.h>
+#include "token_file.h"
+
+#define YYTRACKMAXSTACKDEPTH
+#define YYTRACKREDUCECOUNT
+#include "%parser%.h"
+#include "%parser%.c"
+
+const int inputTokens[] = { %tokens% };
+
+/**
+ * Reads the wall clock
+ * 
+ * @return Current time, in seconds
+ */
+static double wall_clock(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    unsigned long repeat = argc > 1 ? strtoul(argv[1], NULL, 10) : 1;
+    const int* tokens = inputTokens;
+    size_t tokenCount = sizeof(inputTokens) / sizeof(inputTokens[0]);
+    int* fileTokens = NULL;
+
+    if (argc > 2) {
+        fileTokens = read_token_file(argv[2], &tokenCount);
+        if (!fileTokens) {
+            fprintf(stderr, "Could not read tokens from %s\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+        tokens = fileTokens;
+    }
+
+    void* parser = ParseAlloc(malloc);
+    const double start = wall_clock();
+    for (unsigned long r = 0; r < repeat; ++r) {
+        for (size_t i = 0; i < tokenCount; )
+            i += ParseTokens(parser, tokens + i, NULL, tokenCount - i);
+    }
+    const double elapsed = wall_clock() - start;
+
+    const double tokensParsed = (double)tokenCount * repeat;
+    const unsigned long long reductions = ParseReduceCount(parser);
+    printf("tokens:            %.0f\n", tokensParsed);
+    printf("reductions:        %llu\n", reductions);
+    printf("time (s):          %.6f\n", elapsed);
+    printf("tokens/s:          %.0f\n", elapsed > 0 ? tokensParsed / elapsed : 0.0);
+    printf("reductions/s:      %.0f\n", elapsed > 0 ? reductions / elapsed : 0.0);
+    printf("peak stack depth:  %d\n", ParseStackPeak(parser));
+
+    ParseFree(parser, free);
+    free(fileTokens);
+    return EXIT_SUCCESS;
+}
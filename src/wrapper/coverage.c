@@ -0,0 +1,171 @@
+/**
+ * @file coverage.c
+ *
+ * Template file for the wrapper that measures which entries
+ * of a parser's action table are exercised by its input
+ *
+ * Usage: `wrapper_coverage report|missed [tokenFile]`
+ *
+ * The input is split into sessions at each end-of-input token (0),
+ * and all sessions are parsed by the same parser, reset between sessions.
+ * If a token file is given, its whitespace-separated token numbers
+ * are parsed instead of the tokens built into the wrapper.
+ *
+ * An entry of the action table is a pair of a state and a lookahead token
+ * that is not a syntax error. Coverage of all sessions is aggregated,
+ * and printed in one of the following formats:
+ *
+ * `report` - Machine-readable report:
+ * ```
+ * lemon-coverage 1
+ * states <nstate> tokens <ntoken> sessions <nsession> entries <nentry> hit <nhit>
+ * <state> <nentry> <nhit> [<missed lookahead token number> ...]
+ * ...
+ * ```
+ * with one line for each state that has at least one entry.
+ *
+ * `missed` - Human-readable list of states that were never exercised,
+ * and of lookahead tokens that were never seen in the other states.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "token_file.h"
+
+#define YYCOVERAGE
+#include "%parser%.h"
+#include "%parser%.c"
+
+const int inputTokens[] = { %tokens% };
+
+/**
+ * Checks whether a state/lookahead pair is an entry of the action table
+ *
+ * This is the same condition that @ref ParseCoverage uses
+ *
+ * @param stateno    Index of the state
+ * @param iLookAhead Number of the lookahead token
+ * @return           Nonzero if the pair is not a syntax error
+ */
+static int is_entry(int stateno, int iLookAhead) {
+    return yy_lookahead[yy_shift_ofst[stateno] + iLookAhead] == iLookAhead;
+}
+
+/**
+ * Counts the entries of a state and how many of them were exercised
+ *
+ * @param stateno    Index of the state
+ * @param[out] nHit  Receives the number of exercised entries
+ * @return           Number of entries of the state
+ */
+static int count_entries(int stateno, int* nHit) {
+    int nEntry = 0;
+    *nHit = 0;
+    for (int iLookAhead = 0; iLookAhead < YYNTOKEN; ++iLookAhead) {
+        if (!is_entry(stateno, iLookAhead))
+            continue;
+        ++nEntry;
+        if (yycoverage[stateno][iLookAhead])
+            ++*nHit;
+    }
+    return nEntry;
+}
+
+/**
+ * Prints the machine-readable coverage report
+ *
+ * @param out      Output stream
+ * @param sessions Number of sessions that have been parsed
+ */
+static void print_report(FILE* out, size_t sessions) {
+    int nEntry = 0, nHit = 0;
+    for (int stateno = 0; stateno < YYNSTATE; ++stateno) {
+        int stateHit;
+        nEntry += count_entries(stateno, &stateHit);
+        nHit += stateHit;
+    }
+    fprintf(out, "lemon-coverage 1\n");
+    fprintf(out, "states %d tokens %d sessions %zu entries %d hit %d\n",
+        YYNSTATE, YYNTOKEN, sessions, nEntry, nHit);
+    for (int stateno = 0; stateno < YYNSTATE; ++stateno) {
+        int stateHit;
+        int stateEntries = count_entries(stateno, &stateHit);
+        if (stateEntries == 0)
+            continue;
+        fprintf(out, "%d %d %d", stateno, stateEntries, stateHit);
+        for (int iLookAhead = 0; iLookAhead < YYNTOKEN; ++iLookAhead)
+            if (is_entry(stateno, iLookAhead) && !yycoverage[stateno][iLookAhead])
+                fprintf(out, " %d", iLookAhead);
+        fprintf(out, "\n");
+    }
+}
+
+/**
+ * Prints the human-readable list of missed states and entries
+ *
+ * @param out Output stream
+ */
+static void print_missed(FILE* out) {
+    int nUnvisited = 0, nMissed = 0;
+    for (int stateno = 0; stateno < YYNSTATE; ++stateno) {
+        int stateHit;
+        int stateEntries = count_entries(stateno, &stateHit);
+        if (stateEntries == 0 || stateHit == stateEntries)
+            continue;
+        if (stateHit == 0) {
+            fprintf(out, "State %d: never exercised\n", stateno);
+            ++nUnvisited;
+        } else {
+            fprintf(out, "State %d: missed lookahead", stateno);
+            for (int iLookAhead = 0; iLookAhead < YYNTOKEN; ++iLookAhead)
+                if (is_entry(stateno, iLookAhead) && !yycoverage[stateno][iLookAhead])
+                    fprintf(out, " %s", yyTokenName[iLookAhead]);
+            fprintf(out, "\n");
+        }
+        nMissed += stateEntries - stateHit;
+    }
+    fprintf(out, "%d states never exercised, %d entries missed in total\n", nUnvisited, nMissed);
+}
+
+int main(int argc, char** argv) {
+    const int* tokens = inputTokens;
+    size_t tokenCount = sizeof(inputTokens) / sizeof(inputTokens[0]);
+    int* fileTokens = NULL;
+    size_t sessions = 0;
+
+    if (argc < 2 || (strcmp(argv[1], "report") != 0 && strcmp(argv[1], "missed") != 0)) {
+        fprintf(stderr, "Usage: %s report|missed [tokenFile]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (argc > 2) {
+        fileTokens = read_token_file(argv[2], &tokenCount);
+        if (!fileTokens) {
+            fprintf(stderr, "Could not read tokens from %s\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+        tokens = fileTokens;
+    }
+
+    void* parser = ParseAlloc(malloc);
+    for (size_t i = 0; i < tokenCount; ++i) {
+        Parse(parser, tokens[i], NULL);
+        // End of input ends the session, start the next one from scratch
+        if (tokens[i] == 0) {
+            ParseReset(parser);
+            ++sessions;
+        }
+    }
+    // Count the last session even if it is not terminated
+    if (tokenCount > 0 && tokens[tokenCount - 1] != 0)
+        ++sessions;
+    ParseFree(parser, free);
+    free(fileTokens);
+
+    if (strcmp(argv[1], "report") == 0)
+        print_report(stdout, sessions);
+    else
+        print_missed(stdout);
+    return EXIT_SUCCESS;
+}
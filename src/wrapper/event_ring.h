@@ -0,0 +1,139 @@
+/**
+ * @file event_ring.h
+ * 
+ * Layout of the shared memory through which a parser hands its steps
+ * to the renderer, shared by the ring wrapper template and the render daemon
+ * 
+ * The memory starts with @ref event_ring_header, followed by the records,
+ * the rules and the names at the offsets it gives. The parser is the only
+ * producer, and the renderer the only consumer. Each side only writes its
+ * own index, and the other side reads it with atomic operations.
+ * 
+ * Each side sleeps on an eventfd, which the other side signals when
+ * the sleeping side has set its waiting flag:
+ * - The data eventfd tells the renderer that records have been published,
+ *   that the ring has been closed, or that the memory has been set up.
+ * - The space eventfd tells the parser that records have been consumed,
+ *   when the ring was full.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Value of @ref event_ring_header::magic, written last once the memory is set up
+ */
+#define EVENT_RING_MAGIC 0x4c4d4544u
+/**
+ * Version of the layout
+ */
+#define EVENT_RING_VERSION 1u
+
+/**
+ * Kinds of records, with the same values as the `YYEV_` kinds of steps of the parser
+ */
+#define EVENT_RING_INPUT     1
+#define EVENT_RING_SHIFT     2
+#define EVENT_RING_GOTO      3
+#define EVENT_RING_REDUCE    4
+#define EVENT_RING_POP       5
+#define EVENT_RING_DISCARD   6
+#define EVENT_RING_ERROR     7
+#define EVENT_RING_ACCEPT    8
+#define EVENT_RING_FAIL      9
+#define EVENT_RING_OVERFLOW 10
+
+/**
+ * Beginning of the shared memory
+ * 
+ * The indices count records from the start and wrap around 2^32,
+ * the slot of a record is its index modulo the capacity
+ */
+struct event_ring_header {
+    uint32_t magic;
+    uint32_t version;
+    /**
+     * Number of record slots, a power of two
+     */
+    uint32_t capacity;
+    /**
+     * Number of states of the parser. Shifts to larger values are pending reduces
+     */
+    uint32_t stateCount;
+    /**
+     * Number of terminals and nonterminals
+     */
+    uint32_t symbolCount;
+    uint32_t ruleCount;
+    /**
+     * Offset of the array of @ref event_ring_record
+     */
+    uint32_t recordsOffset;
+    /**
+     * Offset of the array of @ref event_ring_rule
+     */
+    uint32_t rulesOffset;
+    /**
+     * Offset of the names: those of the symbols, then those of the rules,
+     * each terminated by a null character
+     */
+    uint32_t namesOffset;
+    uint32_t namesSize;
+    /**
+     * Set by the parser once it will not publish any more records
+     */
+    uint32_t closed;
+    /**
+     * Set by the renderer before it sleeps on the data eventfd
+     */
+    uint32_t consumerWaiting;
+    /**
+     * Set by the parser before it sleeps on the space eventfd
+     */
+    uint32_t producerWaiting;
+    /**
+     * Index of the next record the parser publishes, on a cache line of its own
+     */
+    uint32_t head __attribute__((aligned(64)));
+    /**
+     * Index of the next record the renderer consumes, on a cache line of its own
+     */
+    uint32_t tail __attribute__((aligned(64)));
+};
+
+/**
+ * Step of the parser
+ */
+struct event_ring_record {
+    /**
+     * One of the `EVENT_RING_` kinds
+     */
+    uint16_t kind;
+    /**
+     * Symbol of the step, as given by the parser
+     */
+    uint16_t major;
+    /**
+     * State, action or rule, depending on the kind
+     */
+    uint32_t value;
+    /**
+     * State popped back to by a reduce
+     */
+    uint32_t extra;
+};
+
+/**
+ * Rule of the grammar
+ */
+struct event_ring_rule {
+    /**
+     * Symbol on the left-hand side
+     */
+    uint32_t lhs;
+    /**
+     * Number of symbols on the right-hand side
+     */
+    uint32_t rhsCount;
+};
@@ -0,0 +1,495 @@
+/**
+ * @file explore.c
+ * 
+ * Template file for the wrapper that explores every input of a parser
+ * up to a given length, by reading the parser's own tables
+ * 
+ * Usage: `wrapper_explore [length] [threads]`
+ * 
+ * Inputs are enumerated breadth first, one token longer at each level.
+ * Inputs that leave the parser stack in the same configuration
+ * have the same future, so only the first one found is explored further,
+ * which keeps the enumeration from growing exponentially.
+ * Each level is shared out between worker threads, which steal work
+ * from each other once they run out of their own.
+ * 
+ * Prints which rules are reduced, which states are reached,
+ * and which syntax errors (state and lookahead pairs) can happen,
+ * with the shortest input that leads to each error.
+ * When the grammar has an error symbol, exploration goes on past syntax errors
+ * with the error recovery of the parser, and otherwise stops at the first one.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "%parser%.h"
+#include "%parser%.c"
+#include "simulate.h"
+
+/**
+ * Number of configurations that a worker takes at once from a range
+ */
+#define EXPLORE_CHUNK 16
+/**
+ * Number of independently locked shards of the set of configurations
+ */
+#define EXPLORE_SHARDS 256
+
+/**
+ * Configuration of the parser stack, reached by a shortest input
+ */
+struct config {
+    /**
+     * Configuration before the last token of the input, or NULL for the empty input
+     */
+    const struct config* parent;
+    /**
+     * Next configuration in the same bucket of the set
+     */
+    struct config* next;
+    size_t hash;
+    /**
+     * Last token of the input
+     */
+    int token;
+    /**
+     * Number of tokens of the input
+     */
+    unsigned length;
+    /**
+     * Number of states on the stack, with their pending reduces done
+     */
+    size_t depth;
+    /**
+     * Whether the state on top was pushed by shifting the error symbol
+     */
+    int errorOnTop;
+    YYACTIONTYPE states[];
+};
+
+/**
+ * Part of the set of configurations, with its own lock
+ */
+struct config_shard {
+    pthread_mutex_t lock;
+    struct config** buckets;
+    size_t bucketCount;
+    size_t count;
+};
+
+/**
+ * Growable array of configurations
+ */
+struct config_list {
+    struct config** items;
+    size_t size;
+    size_t capacity;
+};
+
+struct explorer;
+
+/**
+ * Worker thread, with its share of a level and what it found
+ */
+struct worker {
+    struct explorer* explorer;
+    pthread_t thread;
+    /**
+     * Next index of its range of the level, also taken from by other workers
+     */
+    atomic_size_t next;
+    /**
+     * End of its range of the level
+     */
+    size_t end;
+    /**
+     * New configurations, for the next level
+     */
+    struct config_list found;
+    struct sim_trace trace;
+    /**
+     * Configuration before the shortest input that leads to each syntax error,
+     * indexed by state and lookahead
+     */
+    const struct config** errors;
+    /**
+     * Configuration before the end of the shortest accepted input
+     */
+    const struct config* accepted;
+    size_t transitions;
+    size_t overflows;
+    struct sim_stack scratch;
+    struct sim_stack settled;
+};
+
+/**
+ * State shared by all workers
+ */
+struct explorer {
+    struct config_shard shards[EXPLORE_SHARDS];
+    /**
+     * Configurations of the level being explored
+     */
+    struct config_list level;
+    unsigned maxLength;
+    size_t threadCount;
+    struct worker* workers;
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+    int finished;
+};
+
+/**
+ * Appends a configuration to a list
+ */
+static void push_config(struct config_list* list, struct config* config) {
+    if (list->size == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 1024;
+        list->items = realloc(list->items, list->capacity * sizeof(list->items[0]));
+        if (!list->items) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    list->items[list->size++] = config;
+}
+
+/**
+ * Hashes the states of a configuration (FNV-1a)
+ */
+static size_t hash_states(const YYACTIONTYPE* states, size_t count) {
+    size_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < count; ++i) {
+        hash ^= states[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Adds a configuration to the set, unless an equal one is already there
+ * 
+ * @return Nonzero if the configuration was added
+ */
+static int insert_config(struct explorer* explorer, struct config* config) {
+    struct config_shard* shard = &explorer->shards[config->hash % EXPLORE_SHARDS];
+    const size_t spread = config->hash / EXPLORE_SHARDS;
+    pthread_mutex_lock(&shard->lock);
+    for (const struct config* other = shard->buckets[spread & (shard->bucketCount - 1)]; other; other = other->next) {
+        if (other->hash == config->hash && other->depth == config->depth && other->errorOnTop == config->errorOnTop
+            && memcmp(other->states, config->states, config->depth * sizeof(YYACTIONTYPE)) == 0) {
+            pthread_mutex_unlock(&shard->lock);
+            return 0;
+        }
+    }
+    // Keep chains short by doubling the buckets as the shard fills up
+    if (shard->count >= shard->bucketCount) {
+        const size_t bucketCount = shard->bucketCount * 2;
+        struct config** buckets = calloc(bucketCount, sizeof(buckets[0]));
+        if (!buckets) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        for (size_t i = 0; i < shard->bucketCount; ++i) {
+            for (struct config* moved = shard->buckets[i], *next; moved; moved = next) {
+                next = moved->next;
+                struct config** bucket = &buckets[(moved->hash / EXPLORE_SHARDS) & (bucketCount - 1)];
+                moved->next = *bucket;
+                *bucket = moved;
+            }
+        }
+        free(shard->buckets);
+        shard->buckets = buckets;
+        shard->bucketCount = bucketCount;
+    }
+    struct config** bucket = &shard->buckets[spread & (shard->bucketCount - 1)];
+    config->next = *bucket;
+    *bucket = config;
+    ++shard->count;
+    pthread_mutex_unlock(&shard->lock);
+    return 1;
+}
+
+/**
+ * Creates a configuration from the states of a simulated stack
+ */
+static struct config* make_config(const struct sim_stack* stack, const struct config* parent, int token) {
+    assert(stack->belowSize == 0);
+    struct config* config = malloc(sizeof(struct config) + stack->size * sizeof(YYACTIONTYPE));
+    if (!config) {
+        fprintf(stderr, "Out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    config->parent = parent;
+    config->next = NULL;
+    config->token = token;
+    config->length = parent ? parent->length + 1 : 0;
+    config->depth = stack->size;
+    config->errorOnTop = stack->errorOnTop;
+    memcpy(config->states, stack->states, stack->size * sizeof(YYACTIONTYPE));
+    config->hash = hash_states(config->states, config->depth) ^ (size_t)config->errorOnTop;
+    return config;
+}
+
+/**
+ * Feeds every token to the parser in a configuration, and records what happens
+ */
+static void expand_config(struct worker* worker, const struct config* config) {
+    struct explorer* explorer = worker->explorer;
+    // The end of input is always tried, and other tokens only below the maximal length
+    const int lastToken = config->length < explorer->maxLength ? YYNTOKEN - 1 : 0;
+    for (int major = 0; major <= lastToken; ++major) {
+        if (major != 0 && !is_input_token(major))
+            continue;
+        ++worker->transitions;
+        sim_borrow_states(&worker->scratch, config->states, config->depth, config->errorOnTop);
+        enum sim_outcome outcome = sim_token(&worker->scratch, major, &worker->trace);
+        if (outcome == SIM_ERROR) {
+            const struct config** error = &worker->errors[sim_top(&worker->scratch) * YYNTOKEN + major];
+            if (!*error)
+                *error = config;
+#ifdef YYERRORSYMBOL
+            outcome = sim_recover(&worker->scratch, major, &worker->trace);
+#endif
+        }
+        switch (outcome) {
+        case SIM_SHIFT: {
+            // The end of input ends the input even when the recovery discards it
+            if (major == 0)
+                break;
+            sim_settle(&worker->scratch, &worker->trace);
+            sim_copy(&worker->settled, &worker->scratch);
+            struct config* next = make_config(&worker->settled, config, major);
+            if (insert_config(explorer, next))
+                push_config(&worker->found, next);
+            else
+                free(next);
+            break;
+        }
+        case SIM_ACCEPT:
+            if (!worker->accepted)
+                worker->accepted = config;
+            break;
+        case SIM_ERROR:
+            break;
+        case SIM_OVERFLOW:
+            ++worker->overflows;
+            break;
+        }
+    }
+}
+
+/**
+ * Takes the next chunk of a range of the level
+ * 
+ * @param from     Worker that owns the range
+ * @param[out] end Receives the end of the chunk
+ * @return         Start of the chunk, at or past the end of the range if it is exhausted
+ */
+static size_t take_chunk(struct worker* from, size_t* end) {
+    const size_t start = atomic_fetch_add(&from->next, EXPLORE_CHUNK);
+    *end = start + EXPLORE_CHUNK < from->end ? start + EXPLORE_CHUNK : from->end;
+    return start;
+}
+
+/**
+ * Explores the configurations of a level, first from its own range,
+ * then from the ranges of other workers
+ */
+static void explore_level(struct worker* worker) {
+    struct explorer* explorer = worker->explorer;
+    const size_t self = (size_t)(worker - explorer->workers);
+    for (size_t victim = 0; victim < explorer->threadCount; ++victim) {
+        struct worker* from = &explorer->workers[(self + victim) % explorer->threadCount];
+        size_t end;
+        for (size_t i = take_chunk(from, &end); i < end; i = take_chunk(from, &end))
+            for (; i < end; ++i)
+                expand_config(worker, explorer->level.items[i]);
+    }
+}
+
+/**
+ * Main function of the worker threads
+ */
+static void* run_worker(void* argument) {
+    struct worker* worker = argument;
+    for (;;) {
+        pthread_barrier_wait(&worker->explorer->start);
+        if (worker->explorer->finished)
+            return NULL;
+        explore_level(worker);
+        pthread_barrier_wait(&worker->explorer->done);
+    }
+}
+
+/**
+ * Prints the input that leads to a configuration, as token names
+ */
+static void print_input(const struct config* config) {
+    if (!config)
+        return;
+    print_input(config->parent);
+    if (config->parent)
+        printf(" %s", yyTokenName[config->token]);
+}
+
+/**
+ * Picks whichever configuration is reached by the shorter input
+ */
+static const struct config* shorter(const struct config* a, const struct config* b) {
+    return !a || (b && b->length < a->length) ? b : a;
+}
+
+int main(int argc, char** argv) {
+    struct explorer explorer = {0};
+    explorer.maxLength = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 10) : 5;
+    const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    explorer.threadCount = argc > 2 ? strtoul(argv[2], NULL, 10) : (processors > 0 ? (size_t)processors : 1);
+    if (explorer.threadCount == 0)
+        explorer.threadCount = 1;
+
+    for (size_t i = 0; i < EXPLORE_SHARDS; ++i) {
+        pthread_mutex_init(&explorer.shards[i].lock, NULL);
+        explorer.shards[i].bucketCount = 16;
+        explorer.shards[i].buckets = calloc(16, sizeof(struct config*));
+    }
+    explorer.workers = calloc(explorer.threadCount, sizeof(struct worker));
+    for (size_t t = 0; t < explorer.threadCount; ++t) {
+        struct worker* worker = &explorer.workers[t];
+        worker->explorer = &explorer;
+        worker->trace.rules = calloc(YYNRULE, 1);
+        worker->trace.states = calloc(YYNSTATE, 1);
+        worker->errors = calloc((size_t)YYNSTATE * YYNTOKEN, sizeof(worker->errors[0]));
+        if (!worker->trace.rules || !worker->trace.states || !worker->errors) {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The parser starts with state 0 alone on its stack
+    struct sim_stack initial = {0};
+    sim_push(&initial, 0);
+    struct config* root = make_config(&initial, NULL, 0);
+    free(initial.states);
+    insert_config(&explorer, root);
+    push_config(&explorer.level, root);
+
+    pthread_barrier_init(&explorer.start, NULL, (unsigned)explorer.threadCount + 1);
+    pthread_barrier_init(&explorer.done, NULL, (unsigned)explorer.threadCount + 1);
+    for (size_t t = 0; t < explorer.threadCount; ++t)
+        pthread_create(&explorer.workers[t].thread, NULL, run_worker, &explorer.workers[t]);
+
+    // Explore level by level, keeping the configurations of all levels for the inputs they stand for
+    struct config_list all = {0};
+    size_t configCount = 0;
+    while (explorer.level.size > 0) {
+        const size_t share = (explorer.level.size + explorer.threadCount - 1) / explorer.threadCount;
+        for (size_t t = 0; t < explorer.threadCount; ++t) {
+            struct worker* worker = &explorer.workers[t];
+            const size_t start = t * share < explorer.level.size ? t * share : explorer.level.size;
+            atomic_store(&worker->next, start);
+            worker->end = start + share < explorer.level.size ? start + share : explorer.level.size;
+        }
+        pthread_barrier_wait(&explorer.start);
+        pthread_barrier_wait(&explorer.done);
+
+        configCount += explorer.level.size;
+        for (size_t i = 0; i < explorer.level.size; ++i)
+            push_config(&all, explorer.level.items[i]);
+        explorer.level.size = 0;
+        for (size_t t = 0; t < explorer.threadCount; ++t) {
+            struct worker* worker = &explorer.workers[t];
+            for (size_t i = 0; i < worker->found.size; ++i)
+                push_config(&explorer.level, worker->found.items[i]);
+            worker->found.size = 0;
+        }
+    }
+    explorer.finished = 1;
+    pthread_barrier_wait(&explorer.start);
+    for (size_t t = 0; t < explorer.threadCount; ++t)
+        pthread_join(explorer.workers[t].thread, NULL);
+
+    // Merge what the workers found
+    unsigned char rules[YYNRULE] = {0}, states[YYNSTATE] = {0};
+    const struct config* accepted = NULL;
+    size_t transitions = 0, overflows = 0, ruleCount = 0, stateCount = 0, errorCount = 0;
+    for (size_t t = 0; t < explorer.threadCount; ++t) {
+        const struct worker* worker = &explorer.workers[t];
+        for (size_t i = 0; i < YYNRULE; ++i)
+            rules[i] |= worker->trace.rules[i];
+        for (size_t i = 0; i < YYNSTATE; ++i)
+            states[i] |= worker->trace.states[i];
+        accepted = shorter(accepted, worker->accepted);
+        transitions += worker->transitions;
+        overflows += worker->overflows;
+    }
+    for (size_t i = 0; i < YYNRULE; ++i)
+        ruleCount += rules[i];
+    for (size_t i = 0; i <= YY_MAX_SHIFT; ++i)
+        stateCount += states[i];
+    for (size_t i = 0; i < (size_t)YYNSTATE * YYNTOKEN; ++i) {
+        const struct config* error = NULL;
+        for (size_t t = 0; t < explorer.threadCount; ++t)
+            error = shorter(error, explorer.workers[t].errors[i]);
+        explorer.workers[0].errors[i] = error;
+        errorCount += error != NULL;
+    }
+
+    printf("Explored all inputs of up to %u tokens with %zu thread(s)\n", explorer.maxLength, explorer.threadCount);
+    printf("configurations:  %zu\n", configCount);
+    printf("transitions:     %zu\n", transitions);
+    printf("rules reduced:   %zu/%d\n", ruleCount, YYNRULE);
+    printf("states reached:  %zu/%d\n", stateCount, YY_MAX_SHIFT + 1);
+    printf("syntax errors:   %zu\n", errorCount);
+    printf("stack overflows: %zu\n", overflows);
+    if (accepted)
+        printf("shortest accepted input: %u tokens\n", accepted->length);
+    else
+        printf("shortest accepted input: none\n");
+
+    printf("\nRules never reduced:\n");
+    for (size_t i = 0; i < YYNRULE; ++i)
+        if (!rules[i])
+            printf("  %zu: %s\n", i, yyRuleName[i]);
+    printf("\nStates never reached:\n");
+    for (size_t i = 0; i <= YY_MAX_SHIFT; ++i)
+        if (!states[i])
+            printf("  %zu\n", i);
+    printf("\nSyntax errors (state, lookahead: shortest input):\n");
+    for (size_t i = 0; i < (size_t)YYNSTATE * YYNTOKEN; ++i) {
+        const struct config* error = explorer.workers[0].errors[i];
+        if (error) {
+            printf("  %zu, %s:", i / YYNTOKEN, yyTokenName[i % YYNTOKEN]);
+            print_input(error);
+            printf(" %s\n", yyTokenName[i % YYNTOKEN]);
+        }
+    }
+
+    for (size_t i = 0; i < all.size; ++i)
+        free(all.items[i]);
+    free(all.items);
+    free(explorer.level.items);
+    for (size_t t = 0; t < explorer.threadCount; ++t) {
+        struct worker* worker = &explorer.workers[t];
+        free(worker->found.items);
+        free(worker->trace.rules);
+        free(worker->trace.states);
+        free(worker->errors);
+        free(worker->scratch.states);
+        free(worker->settled.states);
+    }
+    free(explorer.workers);
+    for (size_t i = 0; i < EXPLORE_SHARDS; ++i) {
+        pthread_mutex_destroy(&explorer.shards[i].lock);
+        free(explorer.shards[i].buckets);
+    }
+    pthread_barrier_destroy(&explorer.start);
+    pthread_barrier_destroy(&explorer.done);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file flight.c
+ * 
+ * Template file for the wrapper that parses without tracing,
+ * and prints the last steps kept by the flight recorder of the parser
+ * 
+ * Usage: `wrapper_flight [tokenFile]`
+ * 
+ * Must be compiled with `YYFLIGHTRECORDER` defined to the number of steps
+ * to keep. If a token file is given, its whitespace-separated token numbers
+ * are parsed instead of the tokens built into the wrapper.
+ * 
+ * The recorder is dumped at the end of the first token that causes
+ * a syntax error, or else once all tokens have been parsed. Either way,
+ * the dump is a trace ready for the renderer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "token_file.h"
+#include "%parser%.h"
+#include "%parser%.c"
+
+const int inputTokens[] = { %tokens% };
+
+int main(int argc, char** argv) {
+    const int* tokens = inputTokens;
+    size_t tokenCount = sizeof(inputTokens) / sizeof(inputTokens[0]);
+    int* fileTokens = NULL;
+
+    if (argc > 1) {
+        fileTokens = read_token_file(argv[1], &tokenCount);
+        if (!fileTokens) {
+            fprintf(stderr, "Could not read tokens from %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+        tokens = fileTokens;
+    }
+
+    // Collect the automatic dump aside, to know whether there was one
+    char* dump = NULL;
+    size_t dumpSize = 0;
+    FILE* dumpStream = open_memstream(&dump, &dumpSize);
+    if (!dumpStream) {
+        fprintf(stderr, "Could not allocate the dump\n");
+        return EXIT_FAILURE;
+    }
+
+    void* parser = ParseAlloc(malloc);
+    ParseFlightDumpOnError(parser, dumpStream);
+    for (size_t i = 0; i < tokenCount; )
+        i += ParseTokens(parser, tokens + i, NULL, tokenCount - i);
+    fclose(dumpStream);
+    if (dumpSize > 0)
+        fwrite(dump, 1, dumpSize, stdout);
+    else
+        ParseFlightDump(parser, stdout);
+    ParseFree(parser, free);
+    free(dump);
+    free(fileTokens);
+}
@@ -0,0 +1,319 @@
+/**
+ * @file generate.c
+ * 
+ * Template file for the wrapper that generates random token sequences
+ * accepted by a parser, by reading the parser's own tables
+ * 
+ * Usage: `wrapper_generate [sessions] [length] [errorPercent] [seed]`
+ * 
+ * Prints `sessions` lines of whitespace-separated token numbers,
+ * each ending with the end-of-input token (0), in the format read
+ * by the other wrappers. Each session has at least `length` tokens,
+ * unless the grammar only accepts shorter inputs.
+ * A share of `errorPercent` of the tokens are chosen among those
+ * that are syntax errors, so that the parser has to recover from them.
+ * Without errors, every session is accepted by the parser.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "%parser%.h"
+#include "%parser%.c"
+#include "simulate.h"
+
+/**
+ * Longest sequence of tokens searched for to shrink the stack
+ */
+#define SHRINK_LENGTH 8
+/**
+ * Largest number of tokens tried while searching for a sequence that shrinks the stack
+ */
+#define SHRINK_BUDGET 200000
+
+/**
+ * Growable list of the tokens of a session
+ */
+struct token_list {
+    int* items;
+    size_t size;
+    size_t capacity;
+};
+
+/**
+ * Appends a token to a list
+ */
+static void push_token(struct token_list* list, int token) {
+    if (list->size == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 64;
+        list->items = realloc(list->items, list->capacity * sizeof(list->items[0]));
+        if (!list->items) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    list->items[list->size++] = token;
+}
+
+/**
+ * Search for a sequence of tokens that shrinks the stack of a parser
+ */
+struct shrink_search {
+    /**
+     * States of the parser before each token of the sequence, and after the last one
+     */
+    struct sim_stack levels[SHRINK_LENGTH + 1];
+    struct sim_stack scratch;
+    struct sim_stack probe;
+    /**
+     * Tokens of the sequence
+     */
+    int path[SHRINK_LENGTH];
+    /**
+     * Depth that the stack must get down to
+     */
+    size_t target;
+    /**
+     * Whether to skip tokens that leave nothing to parse but the end of input
+     */
+    int keepGoing;
+    /**
+     * Number of tokens that may still be tried
+     */
+    long budget;
+    /**
+     * Token tried first, so that searches do not always find the same sequences
+     */
+    int first;
+};
+
+/**
+ * Checks whether a parser can only accept the end of input
+ * 
+ * @param base    States of the parser, left unchanged
+ * @param scratch Working stack
+ * @return        Nonzero if the end of input is accepted and no input token can be shifted
+ */
+static int is_complete(const struct sim_stack* base, struct sim_stack* scratch) {
+    if (sim_try(base, scratch, 0) != SIM_ACCEPT)
+        return 0;
+    for (int major = 1; major < YYNTOKEN; ++major)
+        if (is_input_token(major) && sim_try(base, scratch, major) == SIM_SHIFT)
+            return 0;
+    return 1;
+}
+
+/**
+ * Random number in the range [0, n)
+ */
+static size_t random_below(size_t n) {
+    return (size_t)(((unsigned long long)rand() * RAND_MAX + rand()) % n);
+}
+
+/**
+ * Random event with a given probability
+ */
+static int chance(double probability) {
+    return probability > 0 && (double)rand() / RAND_MAX < probability;
+}
+
+/**
+ * Searches depth first for the rest of a sequence that shrinks the stack
+ * 
+ * @param search    The search, with the states before the token at `level`
+ * @param level     Index of the next token of the sequence
+ * @param remaining Largest number of tokens left in the sequence
+ * @return          Nonzero if a sequence was found
+ */
+static int shrink_from(struct shrink_search* search, size_t level, size_t remaining) {
+    for (int i = 0; i < YYNTOKEN - 1; ++i) {
+        const int major = 1 + (search->first + i) % (YYNTOKEN - 1);
+        if (!is_input_token(major))
+            continue;
+        if (--search->budget < 0)
+            return 0;
+        if (sim_try(&search->levels[level], &search->scratch, major) != SIM_SHIFT)
+            continue;
+        const size_t depth = sim_settle(&search->scratch, NULL);
+        sim_copy(&search->levels[level + 1], &search->scratch);
+        if (search->keepGoing && is_complete(&search->levels[level + 1], &search->probe))
+            continue;
+        search->path[level] = major;
+        if (depth <= search->target)
+            return 1;
+        if (remaining > 1 && shrink_from(search, level + 1, remaining - 1))
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * Searches for the shortest sequence of tokens after which the stack of a parser,
+ * once its pending reduces are done, is shallower than it is now
+ * 
+ * Greedily picking the token that leaves the stack shallowest is not enough,
+ * because many rules only reduce once tokens that deepen the stack have been shifted
+ * 
+ * @param search    The search
+ * @param base      States of the parser
+ * @param keepGoing Whether to skip sequences that leave nothing to parse but the end of input
+ * @return          Length of the sequence, stored in `search->path`, or 0 if none was found
+ */
+static size_t find_shrink(struct shrink_search* search, const struct sim_stack* base, int keepGoing) {
+    sim_copy(&search->levels[0], base);
+    const size_t depth = sim_settle(&search->levels[0], NULL);
+    if (depth <= 1)
+        return 0;
+    search->target = depth - 1;
+    search->keepGoing = keepGoing;
+    search->budget = SHRINK_BUDGET;
+    search->first = (int)random_below(YYNTOKEN - 1);
+    for (size_t length = 1; length <= SHRINK_LENGTH; ++length)
+        if (shrink_from(search, 0, length))
+            return length;
+    return 0;
+}
+
+/**
+ * Releases the stacks of a search
+ */
+static void free_shrink(struct shrink_search* search) {
+    for (size_t i = 0; i <= SHRINK_LENGTH; ++i)
+        free(search->levels[i].states);
+    free(search->scratch.states);
+    free(search->probe.states);
+}
+
+/**
+ * Generates one session and feeds it to the parser
+ * 
+ * Tokens are picked at random among those that the parser shifts.
+ * Once the session is long enough, and more and more often as the stack gets deeper,
+ * sequences of tokens that shrink the stack are picked instead,
+ * so that the parser soon accepts the end of input without overflowing
+ * 
+ * @param parser     The parser, in its initial state
+ * @param length     Minimal number of tokens, if the grammar allows it
+ * @param errorRate  Probability of choosing a token that is a syntax error
+ * @param search     Working space for the search of sequences that shrink the stack
+ * @param tokens     Receives the tokens of the session, without the end of input
+ * @return           Nonzero on success, zero if the session could not be completed
+ */
+static int generate_session(
+    yyParser* parser,
+    size_t length,
+    double errorRate,
+    struct shrink_search* search,
+    struct token_list* tokens
+) {
+    struct sim_stack base = {0}, scratch = {0}, probe = {0};
+    int valid[YYNTOKEN], invalid[YYNTOKEN], complete[YYNTOKEN];
+    // Give up on sessions that do not find their way to the end
+    const size_t limit = length * 4 + 1000;
+    // Depth past which sequences that shrink the stack are always picked
+#if YYGROWABLESTACK
+    const double depthLimit = 1000;
+#else
+    const double depthLimit = YYSTACKDEPTH / 2;
+#endif
+    int success = 0;
+
+    tokens->size = 0;
+    while (tokens->size < limit) {
+        sim_load(&base, parser);
+        // Finish the session as soon as it is long enough and the input may end
+        if (tokens->size >= length && sim_try(&base, &scratch, 0) == SIM_ACCEPT) {
+            Parse(parser, 0, NULL);
+            success = 1;
+            break;
+        }
+
+        const double pressure = base.size / depthLimit;
+        if (tokens->size >= length || chance(pressure * pressure)) {
+            const size_t n = find_shrink(search, &base, tokens->size < length);
+            for (size_t i = 0; i < n; ++i) {
+                push_token(tokens, search->path[i]);
+                Parse(parser, search->path[i], NULL);
+            }
+            if (n > 0)
+                continue;
+        }
+
+        size_t validCount = 0, invalidCount = 0, completeCount = 0;
+        for (int major = 1; major < YYNTOKEN; ++major) {
+            if (!is_input_token(major))
+                continue;
+            // Tokens that would overflow the stack are neither valid nor errors
+            const enum sim_outcome outcome = sim_try(&base, &scratch, major);
+            if (outcome == SIM_SHIFT) {
+                // Find out which tokens would leave nothing to parse but the end of input
+                sim_settle(&scratch, NULL);
+                sim_copy(&probe, &scratch);
+                complete[validCount] = tokens->size + 1 < length && is_complete(&probe, &scratch);
+                completeCount += complete[validCount];
+                valid[validCount++] = major;
+            } else if (outcome == SIM_ERROR) {
+                invalid[invalidCount++] = major;
+            }
+        }
+
+        int major;
+        if (invalidCount > 0 && chance(errorRate)) {
+            major = invalid[random_below(invalidCount)];
+        } else if (validCount == 0) {
+            // The grammar does not allow longer inputs here, so end the session early
+            if (sim_try(&base, &scratch, 0) == SIM_ACCEPT) {
+                Parse(parser, 0, NULL);
+                success = 1;
+            }
+            break;
+        } else {
+            // Keep the session going until it is long enough, if the grammar allows it
+            size_t candidates = 0;
+            for (size_t i = 0; i < validCount; ++i)
+                if (completeCount == validCount || !complete[i])
+                    valid[candidates++] = valid[i];
+            major = valid[random_below(candidates)];
+        }
+        push_token(tokens, major);
+        Parse(parser, major, NULL);
+    }
+
+    free(base.states);
+    free(scratch.states);
+    free(probe.states);
+    return success;
+}
+
+int main(int argc, char** argv) {
+    const unsigned long sessions = argc > 1 ? strtoul(argv[1], NULL, 10) : 1;
+    const unsigned long length = argc > 2 ? strtoul(argv[2], NULL, 10) : 10;
+    const double errorRate = argc > 3 ? strtod(argv[3], NULL) / 100 : 0;
+    srand(argc > 4 ? (unsigned)strtoul(argv[4], NULL, 10) : 1);
+
+    void* parser = ParseAlloc(malloc);
+    struct shrink_search search = {0};
+    struct token_list tokens = {0};
+    unsigned long failures = 0;
+    for (unsigned long s = 0; s < sessions; ) {
+        ParseReset(parser);
+        if (!generate_session(parser, length, errorRate, &search, &tokens)) {
+            // Try again, but not forever
+            if (++failures > sessions + 100) {
+                fprintf(stderr, "Could not generate sessions that the parser accepts\n");
+                return EXIT_FAILURE;
+            }
+            continue;
+        }
+        for (size_t i = 0; i < tokens.size; ++i)
+            printf("%d ", tokens.items[i]);
+        printf("0\n");
+        ++s;
+    }
+
+    ParseFree(parser, free);
+    free_shrink(&search);
+    free(tokens.items);
+    return EXIT_SUCCESS;
+}
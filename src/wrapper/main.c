@@ -3,21 +3,52 @@
  * 
  * Template file for the wrapper that executes a parser
  * with the desired input
+ * 
+ * Usage: `wrapper [-F filter] [tokenFile]`
+ * 
+ * If a token file is given, its whitespace-separated token numbers
+ * are parsed instead of the tokens built into the wrapper. With a filter,
+ * as read by @ref set_trace_filter, only the steps it selects are traced
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
+#include "token_file.h"
 #include "%parser%.h"
 #include "%parser%.c"
+#include "trace_filter.h"
 
 const int inputTokens[] = { %tokens% };
 
-int main(void) {
+int main(int argc, char** argv) {
+    const int* tokens = inputTokens;
+    size_t tokenCount = sizeof(inputTokens) / sizeof(inputTokens[0]);
+    int* fileTokens = NULL;
+
+    if (argc > 2 && strcmp(argv[1], "-F") == 0) {
+        if (!set_trace_filter(argv[2])) {
+            fprintf(stderr, "Invalid trace filter: %s\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc > 1) {
+        fileTokens = read_token_file(argv[1], &tokenCount);
+        if (!fileTokens) {
+            fprintf(stderr, "Could not read tokens from %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+        tokens = fileTokens;
+    }
+
     ParseTrace(stdout, "");
     void* parser = ParseAlloc(malloc);
-    for (size_t i = 0; i < sizeof(inputTokens) / sizeof(inputTokens[0]); ++i) {
-        Parse(parser, inputTokens[i], NULL);
-    }
+    // Each call stops after an accepted or failed parse, and the next one starts afresh
+    for (size_t i = 0; i < tokenCount; )
+        i += ParseTokens(parser, tokens + i, NULL, tokenCount - i);
     ParseFree(parser, free);
+    free(fileTokens);
 }
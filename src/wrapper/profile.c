@@ -0,0 +1,96 @@
+/**
+ * @file profile.c
+ * 
+ * Template file for the wrapper that counts how often the input
+ * exercises each rule and state of a parser
+ * 
+ * Usage: `wrapper_profile report|rules [tokenFile]`
+ * 
+ * The parser is built with `YYPROFILE`, without tracing. If a token file
+ * is given, its whitespace-separated token numbers are parsed
+ * instead of the tokens built into the wrapper. The counters are printed
+ * in one of the following formats:
+ * 
+ * `report` - Machine-readable report, as written by @ref ParseProfile
+ * 
+ * `rules` - Human-readable list of the rules, most reduced first,
+ * followed by the states in which syntax errors were detected
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "token_file.h"
+
+#define YYPROFILE
+#include "%parser%.h"
+#include "%parser%.c"
+
+const int inputTokens[] = { %tokens% };
+
+/**
+ * Orders rule numbers by decreasing reduction count, then by number
+ */
+static int compare_rules(const void* a, const void* b) {
+    const int ruleA = *(const int*)a, ruleB = *(const int*)b;
+    if (yyprofReduce[ruleA] != yyprofReduce[ruleB])
+        return yyprofReduce[ruleA] < yyprofReduce[ruleB] ? 1 : -1;
+    return ruleA - ruleB;
+}
+
+/**
+ * Prints the human-readable list of rules and error states
+ * 
+ * @param out Output stream
+ */
+static void print_rules(FILE* out) {
+    int rules[YYNRULE];
+    unsigned long long total = 0;
+    for (int i = 0; i < YYNRULE; ++i) {
+        rules[i] = i;
+        total += yyprofReduce[i];
+    }
+    qsort(rules, YYNRULE, sizeof(rules[0]), compare_rules);
+    for (int i = 0; i < YYNRULE; ++i) {
+        const int rule = rules[i];
+        fprintf(out, "%12llu %5.1f%%  %s\n", yyprofReduce[rule],
+            total > 0 ? 100.0 * yyprofReduce[rule] / total : 0.0, yyRuleName[rule]);
+    }
+    fprintf(out, "%llu reductions in total, deepest stack %d\n", total, yyprofDepth);
+    for (int stateno = 0; stateno < YYNSTATE; ++stateno)
+        if (yyprofError[stateno] > 0)
+            fprintf(out, "State %d: %llu syntax errors, %llu shifts\n",
+                stateno, yyprofError[stateno], yyprofShift[stateno]);
+}
+
+int main(int argc, char** argv) {
+    const int* tokens = inputTokens;
+    size_t tokenCount = sizeof(inputTokens) / sizeof(inputTokens[0]);
+    int* fileTokens = NULL;
+
+    if (argc < 2 || (strcmp(argv[1], "report") != 0 && strcmp(argv[1], "rules") != 0)) {
+        fprintf(stderr, "Usage: %s report|rules [tokenFile]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (argc > 2) {
+        fileTokens = read_token_file(argv[2], &tokenCount);
+        if (!fileTokens) {
+            fprintf(stderr, "Could not read tokens from %s\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+        tokens = fileTokens;
+    }
+
+    void* parser = ParseAlloc(malloc);
+    for (size_t i = 0; i < tokenCount; )
+        i += ParseTokens(parser, tokens + i, NULL, tokenCount - i);
+    ParseFree(parser, free);
+    free(fileTokens);
+
+    if (strcmp(argv[1], "report") == 0)
+        ParseProfile(stdout);
+    else
+        print_rules(stdout);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,219 @@
+/**
+ * @file ring.c
+ * 
+ * Template file for the wrapper that hands the steps of a parser
+ * to the renderer through shared memory, instead of a textual trace
+ * 
+ * Usage: `wrapper_ring <memoryFd> <dataFd> <spaceFd> [tokenFile]`
+ * 
+ * The descriptors are inherited from the render daemon, which started
+ * the wrapper: a memfd that receives the ring described in event_ring.h,
+ * and the eventfds of both sides. If a token file is given,
+ * its whitespace-separated token numbers are parsed instead of the tokens
+ * built into the wrapper.
+ * 
+ * The standard input of the wrapper stays open for as long as the renderer
+ * reads the ring, so the wrapper stops waiting for room in the ring
+ * if the renderer goes away.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "token_file.h"
+#include "event_ring.h"
+
+/**
+ * Number of record slots of the ring
+ */
+#define RING_CAPACITY 4096
+
+/**
+ * Producer side of the ring
+ */
+struct ring {
+    struct event_ring_header* header;
+    struct event_ring_record* records;
+    /**
+     * Index of the next record to publish
+     */
+    uint32_t head;
+    /**
+     * Index of the next record to consume, as last read from the header
+     */
+    uint32_t tail;
+    int dataFd;
+    int spaceFd;
+};
+
+static struct ring ring;
+
+/**
+ * Wakes up the other side
+ */
+static void ring_signal(int fd) {
+    const uint64_t one = 1;
+    while (write(fd, &one, sizeof(one)) < 0 && errno == EINTR)
+        ;
+}
+
+/**
+ * Sleeps until the renderer has consumed records, and exits
+ * if the renderer has gone away
+ */
+static void ring_wait_for_space(void) {
+    struct pollfd fds[2] = {
+        {.fd = ring.spaceFd, .events = POLLIN},
+        {.fd = STDIN_FILENO, .events = POLLIN},
+    };
+    if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+        perror("poll");
+        exit(EXIT_FAILURE);
+    }
+    if (fds[0].revents & POLLIN) {
+        uint64_t count;
+        if (read(ring.spaceFd, &count, sizeof(count)) < 0 && errno != EINTR) {
+            perror("read");
+            exit(EXIT_FAILURE);
+        }
+    } else if (fds[1].revents) {
+        fprintf(stderr, "The renderer stopped reading the ring\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Publishes a step of the parser, and waits for room in the ring first if it is full
+ */
+static void ring_push(int kind, int major, int value, int extra) {
+    while (ring.head - ring.tail == RING_CAPACITY) {
+        ring.tail = __atomic_load_n(&ring.header->tail, __ATOMIC_ACQUIRE);
+        if (ring.head - ring.tail != RING_CAPACITY)
+            break;
+        // Announce the wait, then look again so that a consumer that missed the flag
+        // has already made room
+        __atomic_store_n(&ring.header->producerWaiting, 1, __ATOMIC_SEQ_CST);
+        ring.tail = __atomic_load_n(&ring.header->tail, __ATOMIC_SEQ_CST);
+        if (ring.head - ring.tail == RING_CAPACITY)
+            ring_wait_for_space();
+    }
+    struct event_ring_record* r = &ring.records[ring.head & (RING_CAPACITY - 1)];
+    r->kind = (uint16_t)kind;
+    r->major = (uint16_t)major;
+    r->value = (uint32_t)value;
+    r->extra = (uint32_t)extra;
+    __atomic_store_n(&ring.header->head, ++ring.head, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring.header->consumerWaiting, __ATOMIC_SEQ_CST) &&
+        __atomic_exchange_n(&ring.header->consumerWaiting, 0, __ATOMIC_SEQ_CST))
+        ring_signal(ring.dataFd);
+}
+
+#define YYEVENTSINK(P, K, M, V, X) ring_push(K, M, V, X)
+#include "%parser%.h"
+#include "%parser%.c"
+
+_Static_assert(YYEV_INPUT == EVENT_RING_INPUT && YYEV_SHIFT == EVENT_RING_SHIFT &&
+    YYEV_GOTO == EVENT_RING_GOTO && YYEV_REDUCE == EVENT_RING_REDUCE &&
+    YYEV_POP == EVENT_RING_POP && YYEV_DISCARD == EVENT_RING_DISCARD &&
+    YYEV_ERROR == EVENT_RING_ERROR && YYEV_ACCEPT == EVENT_RING_ACCEPT &&
+    YYEV_FAIL == EVENT_RING_FAIL && YYEV_OVERFLOW == EVENT_RING_OVERFLOW,
+    "The kinds of records must match the kinds of steps of the parser");
+
+const int inputTokens[] = { %tokens% };
+
+/**
+ * Sizes the shared memory, and writes the tables of the parser into it
+ * 
+ * @return Nonzero on success, zero if the memory could not be set up
+ */
+static int ring_open(int memoryFd) {
+    const size_t symbolCount = sizeof(yyTokenName) / sizeof(yyTokenName[0]);
+    const size_t ruleCount = sizeof(yyRuleName) / sizeof(yyRuleName[0]);
+    size_t namesSize = 0;
+    for (size_t i = 0; i < symbolCount; ++i)
+        namesSize += strlen(yyTokenName[i]) + 1;
+    for (size_t i = 0; i < ruleCount; ++i)
+        namesSize += strlen(yyRuleName[i]) + 1;
+
+    const size_t recordsOffset = sizeof(struct event_ring_header);
+    const size_t rulesOffset = recordsOffset + RING_CAPACITY * sizeof(struct event_ring_record);
+    const size_t namesOffset = rulesOffset + ruleCount * sizeof(struct event_ring_rule);
+    const size_t size = namesOffset + namesSize;
+    if (ftruncate(memoryFd, (off_t)size) != 0)
+        return 0;
+    char* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, memoryFd, 0);
+    if (memory == MAP_FAILED)
+        return 0;
+
+    struct event_ring_rule* rules = (struct event_ring_rule*)(memory + rulesOffset);
+    for (size_t i = 0; i < ruleCount; ++i) {
+        rules[i].lhs = yyRuleInfoLhs[i];
+        rules[i].rhsCount = (uint32_t)-yyRuleInfoNRhs[i];
+    }
+    char* name = memory + namesOffset;
+    for (size_t i = 0; i < symbolCount; ++i)
+        name = stpcpy(name, yyTokenName[i]) + 1;
+    for (size_t i = 0; i < ruleCount; ++i)
+        name = stpcpy(name, yyRuleName[i]) + 1;
+
+    ring.header = (struct event_ring_header*)memory;
+    ring.records = (struct event_ring_record*)(memory + recordsOffset);
+    ring.header->version = EVENT_RING_VERSION;
+    ring.header->capacity = RING_CAPACITY;
+    ring.header->stateCount = YYNSTATE;
+    ring.header->symbolCount = (uint32_t)symbolCount;
+    ring.header->ruleCount = (uint32_t)ruleCount;
+    ring.header->recordsOffset = (uint32_t)recordsOffset;
+    ring.header->rulesOffset = (uint32_t)rulesOffset;
+    ring.header->namesOffset = (uint32_t)namesOffset;
+    ring.header->namesSize = (uint32_t)namesSize;
+    // The renderer maps the memory once it sees the magic number
+    __atomic_store_n(&ring.header->magic, EVENT_RING_MAGIC, __ATOMIC_RELEASE);
+    ring_signal(ring.dataFd);
+    return 1;
+}
+
+/**
+ * Tells the renderer that no more records will be published
+ */
+static void ring_close(void) {
+    __atomic_store_n(&ring.header->closed, 1, __ATOMIC_SEQ_CST);
+    ring_signal(ring.dataFd);
+}
+
+int main(int argc, char** argv) {
+    const int* tokens = inputTokens;
+    size_t tokenCount = sizeof(inputTokens) / sizeof(inputTokens[0]);
+    int* fileTokens = NULL;
+
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s <memoryFd> <dataFd> <spaceFd> [tokenFile]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    ring.dataFd = atoi(argv[2]);
+    ring.spaceFd = atoi(argv[3]);
+    if (argc > 4) {
+        fileTokens = read_token_file(argv[4], &tokenCount);
+        if (!fileTokens) {
+            fprintf(stderr, "Could not read tokens from %s\n", argv[4]);
+            return EXIT_FAILURE;
+        }
+        tokens = fileTokens;
+    }
+    if (!ring_open(atoi(argv[1]))) {
+        perror("Could not set up the ring");
+        return EXIT_FAILURE;
+    }
+
+    void* parser = ParseAlloc(malloc);
+    for (size_t i = 0; i < tokenCount; )
+        i += ParseTokens(parser, tokens + i, NULL, tokenCount - i);
+    ParseFree(parser, free);
+    ring_close();
+    free(fileTokens);
+}
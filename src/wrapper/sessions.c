@@ -0,0 +1,209 @@
+/**
+ * @file sessions.c
+ * 
+ * Template file for the wrapper that parses many sessions at once,
+ * on a pool of threads
+ * 
+ * Usage: `wrapper_sessions <sessionFile> [outputDirectory] [threads]`
+ * 
+ * Each line of the session file is a session of whitespace-separated
+ * token numbers, as printed by the generation wrapper. The end of input
+ * is added to sessions that do not end with it.
+ * 
+ * With an output directory, the trace of the n-th session (counting from 1)
+ * is written to `session-n.trace` in it, ready for the renderer.
+ * Otherwise the traces are written to the standard output, each session
+ * in one piece in the order in which they finish, and every line is tagged
+ * with the number of its session as `[n] `.
+ * 
+ * Each session takes a parser from the pool of its thread, and traces it
+ * to its own stream with @ref ParseTraceInstance, so that parsers are
+ * only allocated once per thread and keep the stack they grew.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define YYPARSERPOOL 1
+#include "%parser%.h"
+#include "%parser%.c"
+
+/**
+ * Tokens of one session
+ */
+struct session {
+    int* tokens;
+    size_t count;
+};
+
+/**
+ * Sessions and their distribution between threads
+ */
+struct runner {
+    struct session* sessions;
+    size_t sessionCount;
+    /**
+     * Index of the next session to parse
+     */
+    atomic_size_t next;
+    /**
+     * Directory that receives one trace file per session, or NULL for the standard output
+     */
+    const char* outputDirectory;
+    /**
+     * Keeps sessions written to the standard output in one piece
+     */
+    pthread_mutex_t outputLock;
+    /**
+     * Number of sessions whose trace could not be written
+     */
+    atomic_size_t failures;
+};
+
+/**
+ * Reads the sessions of a file, one per line
+ * 
+ * @param path          Path to the file
+ * @param[out] sessions Receives the array of the sessions, allocated with malloc
+ * @param[out] count    Receives the number of sessions
+ * @return              Nonzero on success, zero if the file could not be read
+ */
+static int read_sessions(const char* path, struct session** sessions, size_t* count) {
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return 0;
+    size_t capacity = 0;
+    char* line = NULL;
+    size_t lineCapacity = 0;
+    *sessions = NULL;
+    *count = 0;
+    while (getline(&line, &lineCapacity, file) >= 0) {
+        struct session s = {NULL, 0};
+        size_t tokenCapacity = 0;
+        int token, length;
+        for (const char* c = line; sscanf(c, "%d%n", &token, &length) == 1; c += length) {
+            if (s.count == tokenCapacity) {
+                tokenCapacity = tokenCapacity ? tokenCapacity * 2 : 64;
+                s.tokens = realloc(s.tokens, tokenCapacity * sizeof(int));
+            }
+            s.tokens[s.count++] = token;
+        }
+        // Skip blank lines
+        if (s.count == 0)
+            continue;
+        if (s.tokens[s.count - 1] != 0) {
+            if (s.count == tokenCapacity)
+                s.tokens = realloc(s.tokens, (tokenCapacity + 1) * sizeof(int));
+            s.tokens[s.count++] = 0;
+        }
+        if (*count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            *sessions = realloc(*sessions, capacity * sizeof(struct session));
+        }
+        (*sessions)[(*count)++] = s;
+    }
+    free(line);
+    fclose(file);
+    return 1;
+}
+
+/**
+ * Writes the trace of a session to the standard output, with every line tagged
+ */
+static void write_tagged(const char* trace, size_t size, size_t number) {
+    const char* end = trace + size;
+    while (trace < end) {
+        const char* newline = memchr(trace, '\n', (size_t)(end - trace));
+        const char* next = newline ? newline + 1 : end;
+        printf("[%zu] %.*s", number, (int)(next - trace), trace);
+        if (!newline)
+            putchar('\n');
+        trace = next;
+    }
+}
+
+/**
+ * Parses sessions until there are none left
+ */
+static void* run_worker(void* argument) {
+    struct runner* runner = argument;
+    for (;;) {
+        const size_t i = atomic_fetch_add(&runner->next, 1);
+        if (i >= runner->sessionCount)
+            break;
+
+        FILE* trace;
+        char* buffer = NULL;
+        size_t size = 0;
+        if (runner->outputDirectory) {
+            char path[4096];
+            snprintf(path, sizeof(path), "%s/session-%zu.trace", runner->outputDirectory, i + 1);
+            trace = fopen(path, "w");
+        } else {
+            trace = open_memstream(&buffer, &size);
+        }
+        if (!trace) {
+            fprintf(stderr, "Could not write the trace of session %zu\n", i + 1);
+            atomic_fetch_add(&runner->failures, 1);
+            continue;
+        }
+
+        void* parser = ParsePoolAcquire(malloc);
+        ParseTraceInstance(parser, trace, "");
+        const struct session* s = &runner->sessions[i];
+        for (size_t t = 0; t < s->count; ++t)
+            Parse(parser, s->tokens[t], NULL);
+        // Pop what is left of the session while it is still traced, as the single-session wrapper does
+        ParsePoolRelease(parser, free);
+        fclose(trace);
+
+        if (!runner->outputDirectory) {
+            pthread_mutex_lock(&runner->outputLock);
+            write_tagged(buffer, size, i + 1);
+            pthread_mutex_unlock(&runner->outputLock);
+            free(buffer);
+        }
+    }
+    ParsePoolDrain(free);
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <sessionFile> [outputDirectory] [threads]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    struct runner runner = {0};
+    if (!read_sessions(argv[1], &runner.sessions, &runner.sessionCount)) {
+        fprintf(stderr, "Could not read sessions from %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    runner.outputDirectory = argc > 2 && strcmp(argv[2], "-") != 0 ? argv[2] : NULL;
+    const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threadCount = argc > 3 ? strtoul(argv[3], NULL, 10) : (processors > 0 ? (size_t)processors : 1);
+    if (threadCount == 0)
+        threadCount = 1;
+    if (threadCount > runner.sessionCount && runner.sessionCount > 0)
+        threadCount = runner.sessionCount;
+    atomic_init(&runner.next, 0);
+    atomic_init(&runner.failures, 0);
+    pthread_mutex_init(&runner.outputLock, NULL);
+
+    pthread_t* threads = malloc(threadCount * sizeof(pthread_t));
+    for (size_t t = 0; t < threadCount; ++t)
+        pthread_create(&threads[t], NULL, run_worker, &runner);
+    for (size_t t = 0; t < threadCount; ++t)
+        pthread_join(threads[t], NULL);
+
+    pthread_mutex_destroy(&runner.outputLock);
+    for (size_t i = 0; i < runner.sessionCount; ++i)
+        free(runner.sessions[i].tokens);
+    free(runner.sessions);
+    free(threads);
+    return atomic_load(&runner.failures) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
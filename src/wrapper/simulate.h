@@ -0,0 +1,309 @@
+/**
+ * @file simulate.h
+ * 
+ * Simulation of a parser on a copy of its stack, driven by the parser's own tables,
+ * shared by the wrapper templates
+ * 
+ * Must be included after the source of the parser
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/**
+ * Possible outcomes of feeding a token to a simulated parser
+ */
+enum sim_outcome {
+    SIM_ERROR,
+    SIM_SHIFT,
+    SIM_ACCEPT,
+    SIM_OVERFLOW,
+};
+
+/**
+ * Stack of states of a simulated parser
+ * 
+ * The bottom of the stack may be borrowed from another stack, which is left unchanged,
+ * so that trying a token only copies the states that the token changes
+ */
+struct sim_stack {
+    /**
+     * States borrowed from another stack, under the own states
+     */
+    const YYACTIONTYPE* below;
+    /**
+     * Number of borrowed states still on the stack
+     */
+    size_t belowSize;
+    /**
+     * Own states, on top of the borrowed ones
+     */
+    YYACTIONTYPE* states;
+    size_t size;
+    size_t capacity;
+    /**
+     * Whether the state on top was pushed by shifting the error symbol,
+     * in which case another syntax error discards the lookahead
+     */
+    int errorOnTop;
+};
+
+/**
+ * Record of what a simulated parser went through, with one flag per rule and per state
+ */
+struct sim_trace {
+    /**
+     * Flags of the rules reduced, YYNRULE of them
+     */
+    unsigned char* rules;
+    /**
+     * Flags of the states in which an action was looked up, YYNSTATE of them
+     */
+    unsigned char* states;
+};
+
+/**
+ * Depth of a simulated stack
+ */
+static size_t sim_depth(const struct sim_stack* stack) {
+    return stack->belowSize + stack->size;
+}
+
+/**
+ * State on top of a simulated stack
+ */
+static YYACTIONTYPE sim_top(const struct sim_stack* stack) {
+    return stack->size > 0 ? stack->states[stack->size - 1] : stack->below[stack->belowSize - 1];
+}
+
+/**
+ * Pushes a state onto a simulated stack
+ */
+static void sim_push(struct sim_stack* stack, YYACTIONTYPE state) {
+    if (stack->size == stack->capacity) {
+        stack->capacity = stack->capacity ? stack->capacity * 2 : 64;
+        stack->states = realloc(stack->states, stack->capacity * sizeof(YYACTIONTYPE));
+        if (!stack->states) {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    stack->states[stack->size++] = state;
+    stack->errorOnTop = 0;
+}
+
+/**
+ * Pops states from a simulated stack, which must be deeper
+ */
+static void sim_pop(struct sim_stack* stack, size_t count) {
+    assert(count < sim_depth(stack));
+    if (count > 0)
+        stack->errorOnTop = 0;
+    if (count <= stack->size) {
+        stack->size -= count;
+    } else {
+        stack->belowSize -= count - stack->size;
+        stack->size = 0;
+    }
+}
+
+/**
+ * Makes a simulated stack start as a copy of states owned by another one
+ * 
+ * @param stack  The stack
+ * @param states States to borrow, from the bottom up, left unchanged
+ * @param count  Number of states to borrow
+ * @param errorOnTop Whether the state on top was pushed by shifting the error symbol
+ */
+static void sim_borrow_states(struct sim_stack* stack, const YYACTIONTYPE* states, size_t count, int errorOnTop) {
+    stack->below = states;
+    stack->belowSize = count;
+    stack->size = 0;
+    stack->errorOnTop = errorOnTop;
+}
+
+/**
+ * Makes a simulated stack start as a copy of another one, which must not borrow states
+ */
+static void sim_borrow(struct sim_stack* stack, const struct sim_stack* base) {
+    assert(base->belowSize == 0);
+    sim_borrow_states(stack, base->states, base->size, base->errorOnTop);
+}
+
+/**
+ * Copies all states of a simulated stack onto another one, which then borrows none
+ */
+static void sim_copy(struct sim_stack* stack, const struct sim_stack* source) {
+    stack->belowSize = 0;
+    stack->size = 0;
+    for (size_t i = 0; i < source->belowSize; ++i)
+        sim_push(stack, source->below[i]);
+    for (size_t i = 0; i < source->size; ++i)
+        sim_push(stack, source->states[i]);
+    stack->errorOnTop = source->errorOnTop;
+}
+
+/**
+ * Copies the states of a real parser onto a simulated stack
+ */
+static void sim_load(struct sim_stack* stack, const yyParser* parser) {
+    stack->belowSize = 0;
+    stack->size = 0;
+    for (const yyStackEntry* entry = parser->yystack; entry <= parser->yytos; ++entry)
+        sim_push(stack, entry->stateno);
+#ifdef YYERRORSYMBOL
+    stack->errorOnTop = parser->yytos->major == YYERRORSYMBOL;
+#endif
+}
+
+/**
+ * Checks whether a simulated stack has outgrown the stack of the real parser
+ */
+static int sim_overflow(const struct sim_stack* stack) {
+#if YYGROWABLESTACK
+    (void)stack;
+    return 0;
+#else
+    return sim_depth(stack) > YYSTACKDEPTH;
+#endif
+}
+
+/**
+ * Reduces a rule on a simulated stack
+ * 
+ * @param stack The stack
+ * @param rule  Number of the rule
+ * @param trace Receives the rule, or NULL
+ * @return      The new state on top of the stack, or 0 if the rule has more symbols than the stack
+ */
+static YYACTIONTYPE sim_reduce(struct sim_stack* stack, unsigned int rule, struct sim_trace* trace) {
+    // The table holds the negated length of the right side
+    const size_t pop = (size_t)(-yyRuleInfoNRhs[rule]);
+    if (pop >= sim_depth(stack))
+        return 0;
+    if (trace)
+        trace->rules[rule] = 1;
+    sim_pop(stack, pop);
+    const YYACTIONTYPE act = yy_find_reduce_action(sim_top(stack), (YYCODETYPE)yyRuleInfoLhs[rule]);
+    sim_push(stack, act);
+    return act;
+}
+
+/**
+ * Feeds a token to a simulated parser, with the same actions
+ * that @ref Parse would take, but without changing the real parser
+ * 
+ * On a syntax error, the stack is left as it was when the error was detected,
+ * so its top is the state that has no action for the token
+ * 
+ * @param stack  States of the simulated parser, updated by the token
+ * @param major  Number of the token
+ * @param trace  Receives the rules reduced and the states gone through, or NULL
+ * @return       What the parser does with the token
+ */
+static enum sim_outcome sim_token(struct sim_stack* stack, int major, struct sim_trace* trace) {
+    YYACTIONTYPE act = sim_top(stack);
+    for (;;) {
+        if (trace && act <= YY_MAX_SHIFT)
+            trace->states[act] = 1;
+        act = yy_find_shift_action((YYCODETYPE)major, act);
+        if (act >= YY_MIN_REDUCE) {
+            act = sim_reduce(stack, act - YY_MIN_REDUCE, trace);
+            if (act == 0)
+                return SIM_ERROR;
+            if (sim_overflow(stack))
+                return SIM_OVERFLOW;
+        } else if (act <= YY_MAX_SHIFTREDUCE) {
+            // Shift-reduce actions are kept on the stack as pending reduces
+            if (act > YY_MAX_SHIFT)
+                act += YY_MIN_REDUCE - YY_MIN_SHIFTREDUCE;
+            sim_push(stack, act);
+            return sim_overflow(stack) ? SIM_OVERFLOW : SIM_SHIFT;
+        } else if (act == YY_ACCEPT_ACTION) {
+            return SIM_ACCEPT;
+        } else {
+            return SIM_ERROR;
+        }
+    }
+}
+
+#ifdef YYERRORSYMBOL
+/**
+ * Recovers from a syntax error on a simulated parser, with the same actions
+ * that @ref Parse would take
+ * 
+ * Unless the error symbol was just shifted, states are popped down to one
+ * that shifts the error symbol, which is then shifted before the token is tried again.
+ * The token is discarded if it is still a syntax error.
+ * 
+ * @param stack  States of the simulated parser, as left by @ref sim_token on the error
+ * @param major  Number of the token
+ * @param trace  Receives the rules reduced and the states gone through, or NULL
+ * @return       What the parser does with the token, SIM_SHIFT if it is discarded,
+ *               and SIM_ERROR if the parse fails
+ */
+static enum sim_outcome sim_recover(struct sim_stack* stack, int major, struct sim_trace* trace) {
+    if (stack->errorOnTop)
+        return SIM_SHIFT;
+    // The state at the bottom of the stack is never checked, like in the parser
+    YYACTIONTYPE act = YY_ERROR_ACTION;
+    while (sim_depth(stack) > 1) {
+        act = yy_find_reduce_action(sim_top(stack), YYERRORSYMBOL);
+        if (act <= YY_MAX_SHIFTREDUCE)
+            break;
+        sim_pop(stack, 1);
+    }
+    if (sim_depth(stack) <= 1 || major == 0)
+        return SIM_ERROR;
+    if (act > YY_MAX_SHIFT)
+        act += YY_MIN_REDUCE - YY_MIN_SHIFTREDUCE;
+    sim_push(stack, act);
+    stack->errorOnTop = 1;
+    if (sim_overflow(stack))
+        return SIM_OVERFLOW;
+    const enum sim_outcome outcome = sim_token(stack, major, trace);
+    return outcome == SIM_ERROR ? SIM_SHIFT : outcome;
+}
+#endif
+
+/**
+ * Checks what a simulated parser does with a token
+ * 
+ * @param base    States of the parser, left unchanged
+ * @param scratch Receives the states of the parser after the token
+ * @param major   Number of the token
+ * @return        What the parser does with the token
+ */
+static enum sim_outcome sim_try(const struct sim_stack* base, struct sim_stack* scratch, int major) {
+    sim_borrow(scratch, base);
+    return sim_token(scratch, major, NULL);
+}
+
+/**
+ * Performs the pending reduces on top of a simulated stack,
+ * which do not depend on the next token
+ * 
+ * @param stack The stack
+ * @param trace Receives the rules reduced, or NULL
+ * @return      Depth of the stack once they are done
+ */
+static size_t sim_settle(struct sim_stack* stack, struct sim_trace* trace) {
+    YYACTIONTYPE act = sim_top(stack);
+    while (act >= YY_MIN_REDUCE && act < YY_MIN_REDUCE + YYNRULE)
+        act = sim_reduce(stack, act - YY_MIN_REDUCE, trace);
+    return sim_depth(stack);
+}
+
+/**
+ * Checks whether a token may appear in the input at all
+ */
+static int is_input_token(int major) {
+#ifdef YYERRORSYMBOL
+    if (major == YYERRORSYMBOL)
+        return 0;
+#endif
+    return major > 0 && major < YYNTOKEN;
+}
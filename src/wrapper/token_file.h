@@ -0,0 +1,43 @@
+/**
+ * @file token_file.h
+ * 
+ * Reading of parser input tokens from a file,
+ * shared by the wrapper templates
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Reads whitespace-separated token numbers from a file
+ * 
+ * @param path       Path to the file
+ * @param[out] count Receives the number of tokens read
+ * @return           Array of the tokens, allocated with malloc,
+ *                   or NULL if the file could not be read
+ */
+static int* read_token_file(const char* path, size_t* count) {
+    FILE* file = fopen(path, "r");
+    size_t capacity = 1024;
+    int* tokens;
+    int token;
+
+    *count = 0;
+    if (!file)
+        return NULL;
+    tokens = malloc(capacity * sizeof(tokens[0]));
+    while (tokens && fscanf(file, "%d", &token) == 1) {
+        if (*count == capacity) {
+            int* grown = realloc(tokens, (capacity *= 2) * sizeof(tokens[0]));
+            if (!grown)
+                free(tokens);
+            tokens = grown;
+        }
+        if (tokens)
+            tokens[(*count)++] = token;
+    }
+    fclose(file);
+    return tokens;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file trace_filter.h
+ * 
+ * Reading of the filter of the trace of a parser from its description,
+ * shared by the wrapper templates that trace
+ * 
+ * Must be included after the parser, as the filter is sized by its tables
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Names of the kinds of steps, indexed by their `YYEV_` code
+ */
+static const char* const traceKindNames[] = {
+    NULL, "input", "shift", "goto", "reduce", "pop",
+    "discard", "error", "accept", "fail", "overflow",
+};
+
+/**
+ * Reads a number or a range of numbers, such as `3` or `3-7`
+ * 
+ * @param text      The text, which must hold nothing else
+ * @param limit     Upper bound of the numbers
+ * @param[out] low  Receives the first number
+ * @param[out] high Receives the last number
+ * @return          1 if the range is valid, 0 otherwise
+ */
+static int read_trace_range(const char* text, long limit, long* low, long* high) {
+    char* end;
+    *low = strtol(text, &end, 10);
+    *high = *low;
+    if (end != text && *end == '-') {
+        text = end + 1;
+        *high = strtol(text, &end, 10);
+    }
+    return end != text && *end == '\0' && *low >= 0 && *low <= *high && *high < limit;
+}
+
+/**
+ * Sets the filter of the trace with @ref ParseTraceFilter from its description
+ * 
+ * The description is a comma-separated list of items, which are
+ * `rule:<n>` and `state:<n>` to trace the steps of a rule or in a state
+ * (or of a range, as in `state:3-7`), `depth:<n>` to trace the steps
+ * with at least `n` entries on the stack, and the names of the kinds
+ * of steps to trace (input, shift, goto, reduce, pop, discard, error,
+ * accept, fail and overflow). All rules, states and kinds are traced
+ * if none are named.
+ * 
+ * @param description The description, which is modified
+ * @return            1 if the filter is set, 0 if the description is invalid
+ */
+static int set_trace_filter(char* description) {
+    unsigned char rules[(YYNRULE + 7) / 8] = {0};
+    unsigned char states[(YYNSTATE + 7) / 8] = {0};
+    int hasRules = 0, hasStates = 0;
+    unsigned int kinds = 0;
+    int depth = 0;
+
+    for (char* item = strtok(description, ","); item; item = strtok(NULL, ",")) {
+        long low, high;
+        if (strncmp(item, "rule:", 5) == 0) {
+            if (!read_trace_range(item + 5, YYNRULE, &low, &high))
+                return 0;
+            for (long rule = low; rule <= high; ++rule)
+                rules[rule / 8] |= 1 << (rule % 8);
+            hasRules = 1;
+        } else if (strncmp(item, "state:", 6) == 0) {
+            if (!read_trace_range(item + 6, YYNSTATE, &low, &high))
+                return 0;
+            for (long state = low; state <= high; ++state)
+                states[state / 8] |= 1 << (state % 8);
+            hasStates = 1;
+        } else if (strncmp(item, "depth:", 6) == 0) {
+            if (!read_trace_range(item + 6, 1L << 30, &low, &high) || low != high)
+                return 0;
+            depth = (int)low;
+        } else {
+            size_t kind = 1;
+            while (kind < sizeof(traceKindNames) / sizeof(traceKindNames[0]) && strcmp(item, traceKindNames[kind]) != 0)
+                ++kind;
+            if (kind == sizeof(traceKindNames) / sizeof(traceKindNames[0]))
+                return 0;
+            kinds |= 1u << kind;
+        }
+    }
+    ParseTraceFilter(hasRules ? rules : NULL, hasStates ? states : NULL, kinds ? kinds : ~0u, depth);
+    return 1;
+}
@@ -0,0 +1,49 @@
+%token_prefix TK_
+
+%left ASSIGN.
+%left OR.
+%left AND.
+%left EQ NE.
+%left LT LE GT GE.
+%left PLUS MINUS.
+%left STAR SLASH PERCENT.
+%right CARET.
+%right NOT UMINUS.
+
+program ::= stmts.
+
+stmts ::= stmts stmt.
+stmts ::= .
+
+stmt ::= expr SEMI.
+stmt ::= ID ASSIGN expr SEMI.
+stmt ::= IF LP expr RP stmt ELSE stmt.
+stmt ::= WHILE LP expr RP stmt.
+stmt ::= LBRACE stmts RBRACE.
+stmt ::= SEMI.
+
+expr ::= NUM.
+expr ::= ID.
+expr ::= ID LP args RP.
+expr ::= LP expr RP.
+expr ::= expr OR expr.
+expr ::= expr AND expr.
+expr ::= expr EQ expr.
+expr ::= expr NE expr.
+expr ::= expr LT expr.
+expr ::= expr LE expr.
+expr ::= expr GT expr.
+expr ::= expr GE expr.
+expr ::= expr PLUS expr.
+expr ::= expr MINUS expr.
+expr ::= expr STAR expr.
+expr ::= expr SLASH expr.
+expr ::= expr PERCENT expr.
+expr ::= expr CARET expr.
+expr ::= NOT expr.
+expr ::= MINUS expr. [UMINUS]
+
+args ::= .
+args ::= arglist.
+arglist ::= arglist COMMA expr.
+arglist ::= expr.
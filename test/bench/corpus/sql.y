@@ -0,0 +1,191 @@
+%token_prefix TK_
+
+%left UNION.
+%left OR.
+%left AND.
+%right NOT.
+%left IS LIKE IN EQ NE.
+%left LT LE GT GE.
+%left CONCAT.
+%left PLUS MINUS.
+%left STAR SLASH PERCENT.
+%right UMINUS.
+
+program ::= cmdlist.
+
+cmdlist ::= cmdlist cmd SEMI.
+cmdlist ::= .
+
+cmd ::= select.
+cmd ::= INSERT INTO name collist_opt select.
+cmd ::= UPDATE name SET setlist where_opt.
+cmd ::= DELETE FROM name where_opt.
+cmd ::= CREATE TABLE ifnotexists name LP coldeflist RP.
+cmd ::= CREATE unique_opt INDEX ifnotexists name ON name LP sortlist RP.
+cmd ::= CREATE VIEW ifnotexists name AS select.
+cmd ::= DROP TABLE ifexists name.
+cmd ::= DROP INDEX ifexists name.
+cmd ::= DROP VIEW ifexists name.
+cmd ::= ALTER TABLE name ADD COLUMN coldef.
+cmd ::= ALTER TABLE name RENAME TO ID.
+cmd ::= BEGIN transaction_opt.
+cmd ::= COMMIT transaction_opt.
+cmd ::= ROLLBACK transaction_opt.
+
+transaction_opt ::= .
+transaction_opt ::= TRANSACTION.
+
+ifnotexists ::= .
+ifnotexists ::= IF NOT EXISTS.
+ifexists ::= .
+ifexists ::= IF EXISTS.
+unique_opt ::= .
+unique_opt ::= UNIQUE.
+
+name ::= ID.
+name ::= ID DOT ID.
+
+collist_opt ::= .
+collist_opt ::= LP idlist RP.
+idlist ::= idlist COMMA ID.
+idlist ::= ID.
+
+valueslist ::= valueslist COMMA LP exprlist RP.
+valueslist ::= LP exprlist RP.
+
+setlist ::= setlist COMMA ID EQ expr.
+setlist ::= ID EQ expr.
+
+coldeflist ::= coldeflist COMMA coldefitem.
+coldeflist ::= coldefitem.
+coldefitem ::= coldef.
+coldefitem ::= tableconstraint.
+coldef ::= ID typename constraints.
+typename ::= ID.
+typename ::= ID LP INTEGER RP.
+typename ::= ID LP INTEGER COMMA INTEGER RP.
+constraints ::= constraints constraint.
+constraints ::= .
+constraint ::= PRIMARY KEY sortorder autoinc.
+constraint ::= NOT NULL.
+constraint ::= NULL.
+constraint ::= UNIQUE.
+constraint ::= DEFAULT term.
+constraint ::= DEFAULT LP expr RP.
+constraint ::= CHECK LP expr RP.
+constraint ::= REFERENCES name collist_opt.
+constraint ::= COLLATE ID.
+autoinc ::= .
+autoinc ::= AUTOINCREMENT.
+
+tableconstraint ::= PRIMARY KEY LP idlist RP.
+tableconstraint ::= UNIQUE LP idlist RP.
+tableconstraint ::= CHECK LP expr RP.
+tableconstraint ::= FOREIGN KEY LP idlist RP REFERENCES name collist_opt.
+
+select ::= selectcore orderby_opt limit_opt.
+select ::= compound orderby_opt limit_opt.
+compound ::= selectcore UNION all_opt selectcore.
+compound ::= compound UNION all_opt selectcore.
+all_opt ::= .
+all_opt ::= ALL.
+
+selectcore ::= SELECT distinct selcollist from where_opt groupby_opt having_opt.
+selectcore ::= VALUES valueslist.
+
+distinct ::= DISTINCT.
+distinct ::= .
+
+selcollist ::= selcollist COMMA selcol.
+selcollist ::= selcol.
+selcol ::= STAR.
+selcol ::= ID DOT STAR.
+selcol ::= expr as.
+as ::= AS ID.
+as ::= ID.
+as ::= .
+
+from ::= .
+from ::= FROM seltablist.
+seltablist ::= seltablist joinop tablesrc joincond.
+seltablist ::= tablesrc.
+tablesrc ::= name as.
+tablesrc ::= LP select RP as.
+joinop ::= COMMA.
+joinop ::= JOIN.
+joinop ::= LEFT outer_opt JOIN.
+joinop ::= INNER JOIN.
+joinop ::= CROSS JOIN.
+outer_opt ::= .
+outer_opt ::= OUTER.
+joincond ::= .
+joincond ::= ON expr.
+joincond ::= USING LP idlist RP.
+
+where_opt ::= .
+where_opt ::= WHERE expr.
+groupby_opt ::= .
+groupby_opt ::= GROUP BY exprlist.
+having_opt ::= .
+having_opt ::= HAVING expr.
+orderby_opt ::= .
+orderby_opt ::= ORDER BY sortlist.
+sortlist ::= sortlist COMMA sortitem.
+sortlist ::= sortitem.
+sortitem ::= expr sortorder.
+sortorder ::= ASC.
+sortorder ::= DESC.
+sortorder ::= .
+limit_opt ::= .
+limit_opt ::= LIMIT expr.
+limit_opt ::= LIMIT expr OFFSET expr.
+
+exprlist ::= exprlist COMMA expr.
+exprlist ::= expr.
+
+expr ::= term.
+expr ::= name.
+expr ::= VARIABLE.
+expr ::= LP expr RP.
+expr ::= LP select RP.
+expr ::= EXISTS LP select RP.
+expr ::= ID LP RP.
+expr ::= ID LP STAR RP.
+expr ::= ID LP distinct exprlist RP.
+expr ::= CAST LP expr AS typename RP.
+expr ::= expr OR expr.
+expr ::= expr AND expr.
+expr ::= expr EQ expr.
+expr ::= expr NE expr.
+expr ::= expr LT expr.
+expr ::= expr LE expr.
+expr ::= expr GT expr.
+expr ::= expr GE expr.
+expr ::= expr LIKE expr.
+expr ::= expr NOT LIKE expr. [LIKE]
+expr ::= expr CONCAT expr.
+expr ::= expr PLUS expr.
+expr ::= expr MINUS expr.
+expr ::= expr STAR expr.
+expr ::= expr SLASH expr.
+expr ::= expr PERCENT expr.
+expr ::= expr IS NULL.
+expr ::= expr IS NOT NULL.
+expr ::= expr IN LP exprlist RP.
+expr ::= expr IN LP select RP.
+expr ::= expr NOT IN LP exprlist RP. [IN]
+expr ::= NOT expr.
+expr ::= MINUS expr. [UMINUS]
+expr ::= PLUS expr. [UMINUS]
+expr ::= CASE case_operand case_exprlist case_else END.
+case_operand ::= .
+case_operand ::= expr.
+case_exprlist ::= case_exprlist WHEN expr THEN expr.
+case_exprlist ::= WHEN expr THEN expr.
+case_else ::= .
+case_else ::= ELSE expr.
+
+term ::= INTEGER.
+term ::= FLOAT.
+term ::= STRING.
+term ::= NULL.
@@ -0,0 +1,7 @@
+start ::= block.
+block ::= Begin lines End.
+lines ::= .
+lines ::= lines line.
+lines ::= lines error.
+line ::= One.
+line ::= Two Two.
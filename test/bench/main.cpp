@@ -0,0 +1,94 @@
+/**
+ * @file main.cpp
+ * 
+ * Entry point of the benchmark runner
+ * 
+ * Usage: `bench [-m] [-q] [-s baselineFile] [-c baselineFile] [-t percent]`
+ * 
+ * `-m` prints tab-separated values instead of the human-readable report,
+ * `-q` takes fewer and shorter samples for a quick check,
+ * `-s` saves the statistics to a baseline file,
+ * `-c` compares the statistics to a baseline file and fails if any benchmark
+ * is significantly slower by more than the threshold set by `-t` (5% by default)
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include "../testbed/bench.hpp"
+#include "../testbed/baseline.hpp"
+
+/**
+ * Prints the usage of the runner
+ */
+static void print_usage(const char* name) {
+    std::cerr << "Usage: " << name << " [-m] [-q] [-s baselineFile] [-c baselineFile] [-t percent]" << std::endl;
+}
+
+int main(int argc, const char* const* argv) {
+    test::bench_config config;
+    bool machineReadable = false;
+    std::string savePath, comparePath;
+    double threshold = 0.05;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "-m") {
+            machineReadable = true;
+        } else if (arg == "-q") {
+            config.warmupSeconds = 0.005;
+            config.sampleSeconds = 0.0005;
+            config.sampleCount = 10;
+        } else if ((arg == "-s" || arg == "-c" || arg == "-t") && i + 1 < argc) {
+            const std::string value = argv[++i];
+            if (arg == "-s") {
+                savePath = value;
+            } else if (arg == "-c") {
+                comparePath = value;
+            } else try {
+                threshold = std::stod(value) / 100;
+            } catch (const std::exception&) {
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Read the baseline first, so that a missing file does not waste a whole run
+    test::bench_baseline baseline;
+    if (!comparePath.empty()) {
+        std::ifstream baselineFile(comparePath);
+        try {
+            if (!baselineFile)
+                throw std::invalid_argument(comparePath);
+            baseline = test::read_baseline(baselineFile);
+        } catch (const std::exception&) {
+            std::cerr << "Could not read baseline from " << comparePath << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!test::has_benchmarks()) {
+        std::cerr << "\33[0;31mNo benchmark cases found\33[0m" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<test::bench_record> records;
+    bool success = test::run_benchmarks(std::cout, config, machineReadable, &records);
+
+    if (!savePath.empty()) {
+        std::ofstream baselineFile(savePath);
+        test::write_benchmarks(baselineFile, records);
+        if (!baselineFile) {
+            std::cerr << "Could not write baseline to " << savePath << std::endl;
+            success = false;
+        }
+    }
+    if (!comparePath.empty())
+        success = test::check_regressions(machineReadable ? std::cerr : std::cout, records, baseline, threshold) && success;
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
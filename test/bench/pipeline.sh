@@ -0,0 +1,126 @@
+#!/bin/bash
+
+# Measures every stage of the pipeline of drawmealemon
+# (Lemon, wrapper compilation, parsing with trace, rendering)
+# over the corpus of grammars in test/bench/corpus
+#
+# Usage: test/bench/pipeline.sh [repeatCount...]
+#
+# Every grammar `<name>.y` in the corpus comes with `<name>.tokens`,
+# which lists the token names of its input in three lines:
+#   prefix: <tokens at the start of the input>
+#   unit: <tokens repeated repeatCount times>
+#   suffix: <tokens at the end of the input>
+# The end-of-input token is appended automatically.
+#
+# Results are printed as a table and saved as tab-separated values
+# to out/bench/pipeline.tsv
+
+# C compiler
+CC=${CC:-gcc}
+# Output directory (relative to the repository)
+OUT=out
+# Directory of the pipeline outputs within the output directory
+DIR="$OUT/bench/pipeline"
+# Directory of the corpus
+CORPUS=test/bench/corpus
+# Lengths of the inputs, as repetitions of their unit
+REPEATS=("$@")
+if (( ${#REPEATS[@]} == 0 ))
+then
+    REPEATS=(1 10 100 1000)
+fi
+
+# Switch to the repository, in case the script is called from elsewhere
+cd "`dirname $0`/../.." || exit 1
+
+# Prints the current time in nanoseconds
+now() {
+    date +%s%N
+}
+
+# Size of files in bytes
+# Arguments: paths of the files
+bytes() {
+    cat "$@" | wc -c
+}
+
+# Records the result of a stage
+# Arguments: grammar, token count, stage, start time, end time, output bytes
+record() {
+    local MS=`awk "BEGIN { printf \"%.3f\", ($5 - $4) / 1e6 }"`
+    printf "%s\t%s\t%s\t%s\t%s\n" "$1" "$2" "$3" "$MS" "$6" >> "$RESULTS"
+    printf "%-8s %8s  %-8s %12s ms %12s bytes\n" "$1" "$2" "$3" "$MS" "$6"
+}
+
+# Writes the numbers of the tokens of an input
+# Arguments: token file, header of the parser, token prefix, repeat count
+make_tokens() {
+    awk -v repeat="$4" -v prefix="$3" '
+        # Token numbers from the generated header
+        FNR == NR { if ($1 == "#define") number[$2] = $3; next }
+        # Token names from the token file
+        /^(prefix|unit|suffix):/ {
+            section = $1
+            sub(":", "", section)
+            for (i = 2; i <= NF; ++i) {
+                if (!((prefix $i) in number)) {
+                    print "Unknown token " $i > "/dev/stderr"
+                    exit 1
+                }
+                tokens[section] = tokens[section] " " number[prefix $i]
+            }
+        }
+        END {
+            out = tokens["prefix"]
+            for (r = 0; r < repeat; ++r)
+                out = out tokens["unit"]
+            print out tokens["suffix"] " 0"
+        }
+    ' "$2" "$1"
+}
+
+make build >&2 || exit 1
+rm -rf "$DIR"
+mkdir -p "$DIR"
+RESULTS="$OUT/bench/pipeline.tsv"
+printf "grammar\ttokens\tstage\tms\tbytes\n" > "$RESULTS"
+
+for GRAMMAR in "$CORPUS"/*.y
+do
+    NAME=`basename "${GRAMMAR%.y}"`
+    GDIR="$DIR/$NAME"
+    mkdir -p "$GDIR"
+    PREFIX=`sed -n 's/^%token_prefix[[:space:]]*\([A-Za-z0-9_]*\).*/\1/p' "$GRAMMAR"`
+
+    # Generate the parser
+    START=`now`
+    "$OUT"/lemon "$GRAMMAR" -d"$GDIR" -Tsrc/lemon/lempar.c >/dev/null || exit 1
+    END=`now`
+    record "$NAME" - lemon "$START" "$END" `bytes "$GDIR/$NAME".c "$GDIR/$NAME".h`
+
+    # Compile the wrapper, which reads the tokens from a file
+    sed -e "s;%parser%;$NAME;g" -e "s;%tokens%;0;g" src/wrapper/main.c > "$GDIR"/wrapper.c
+    START=`now`
+    "$CC" -Isrc/wrapper "$GDIR"/wrapper.c -o "$GDIR"/wrapper || exit 1
+    END=`now`
+    record "$NAME" - compile "$START" "$END" `bytes "$GDIR"/wrapper`
+
+    for REPEAT in "${REPEATS[@]}"
+    do
+        make_tokens "$CORPUS/$NAME".tokens "$GDIR/$NAME".h "$PREFIX" "$REPEAT" > "$GDIR/input$REPEAT.txt" || exit 1
+        COUNT=`wc -w < "$GDIR/input$REPEAT.txt"`
+
+        # Parse with trace
+        START=`now`
+        "$GDIR"/wrapper "$GDIR/input$REPEAT.txt" > "$GDIR/trace$REPEAT.txt" || exit 1
+        END=`now`
+        record "$NAME" "$COUNT" parse "$START" "$END" `bytes "$GDIR/trace$REPEAT.txt"`
+
+        # Render the trace
+        START=`now`
+        "$OUT"/render < "$GDIR/trace$REPEAT.txt" > "$GDIR/render$REPEAT.txt" || exit 1
+        END=`now`
+        record "$NAME" "$COUNT" render "$START" "$END" `bytes "$GDIR/render$REPEAT.txt"`
+    done
+done
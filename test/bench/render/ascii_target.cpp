@@ -0,0 +1,78 @@
+/**
+ * @file ascii_target.cpp
+ * 
+ * Benchmarks for the @ref ascii_target class over synthetic traces
+ */
+
+#include <memory>
+#include "../../testbed/bench.hpp"
+#include "../../../src/render/ascii_target.hpp"
+#include "../../../src/render/default_trace_parser.hpp"
+#include "../../../src/render/pure_ascii_fragment_table.hpp"
+#include "fixtures.hpp"
+
+using dmalem::ascii_target;
+using dmalem::pure_ascii_fragment_table;
+
+/**
+ * Renders a trace with @ref ascii_target, including the parsing of its lines
+ * 
+ * @param bench Benchmark state
+ * @param trace Lines of the trace
+ */
+static void render_trace(test::bench_state& bench, const std::vector<std::string>& trace) {
+    bench::null_stream ostr;
+    auto parser = dmalem::default_trace_parser();
+    bench.bytes_per_iteration(bench::trace_bytes(trace));
+    bench.items_per_iteration(trace.size());
+    bench.run([&] {
+        ascii_target target(ostr, std::make_unique<pure_ascii_fragment_table>());
+        parser.set_target(target);
+        for (const auto& line : trace)
+            parser.parse_line(line);
+        target.finalize();
+    });
+}
+
+BENCH(render_short_trace) {
+    render_trace(bench, bench::synthetic_trace(10));
+}
+
+BENCH(render_long_trace) {
+    render_trace(bench, bench::synthetic_trace(1000));
+}
+
+BENCH(render_deep_trace_with_errors) {
+    // Deep stack, half of the shifts pending, frequent error recovery
+    render_trace(bench, bench::generated_trace({
+        .tokens      = 2000,
+        .maxDepth    = 200,
+        .pendingRate = 0.5,
+        .errorRate   = 0.02,
+        .errorLength = 8,
+        .returnLines = false,
+    }));
+}
+
+BENCH(events_only) {
+    // Per-event cost of the layout, without parsing the trace
+    bench::null_stream ostr;
+    constexpr size_t lineCount = 100;
+    bench.items_per_iteration(lineCount);
+    bench.run([&] {
+        ascii_target target(ostr, std::make_unique<pure_ascii_fragment_table>());
+        target.input_token("Begin");
+        target.shift(2);
+        for (size_t i = 0; i < lineCount; ++i) {
+            target.input_token("One");
+            target.shift_reduce();
+            target.reduce(1, "line", "line ::= One");
+            target.shift_reduce();
+            target.reduce(2, "lines", "lines ::= lines line");
+            target.shift(1);
+        }
+        target.input_token("$");
+        target.accept();
+        target.finalize();
+    });
+}
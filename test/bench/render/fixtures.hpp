@@ -0,0 +1,155 @@
+/**
+ * @file fixtures.hpp
+ * 
+ * Shared inputs and sinks for benchmarks of the renderer
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../../../src/render/render_target.hpp"
+#include "../trace_generator.hpp"
+
+namespace bench {
+
+/**
+ * Stream buffer that discards everything written to it
+ */
+class null_buffer : public std::streambuf {
+protected:
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+/**
+ * Output stream that discards everything written to it,
+ * so that benchmarks measure formatting rather than memory growth
+ */
+class null_stream : public std::ostream {
+public:
+    null_stream() : std::ostream(&buffer) {}
+private:
+    null_buffer buffer;
+};
+
+/**
+ * Implementation of @ref dmalem::render_target that ignores all events
+ */
+class null_render_target : public dmalem::render_target {
+public:
+    void finalize() override {}
+    void input_token(const std::string_view&) override {}
+    void shift(int) override {}
+    void shift_reduce() override {}
+    void syntax_error() override {}
+    void reduce(size_t, const std::string_view&, const std::string_view&) override {}
+    void pop() override {}
+    void discard() override {}
+    void accept() override {}
+    void failure() override {}
+    void stack_overflow() override {}
+    void action_time(std::chrono::nanoseconds) override {}
+    void stack_growth(size_t, size_t, size_t) override {}
+    void filtered() override {}
+};
+
+/**
+ * Generates a Lemon trace of the grammar from the README,
+ * for an input of a given number of lines
+ * 
+ * The lines alternate between `One` and `Two Two`,
+ * and the session ends with acceptance
+ * 
+ * @param lineCount Number of lines of the parsed input
+ * @return Lines of the trace
+ */
+inline std::vector<std::string> synthetic_trace(size_t lineCount) {
+    using namespace std::string_literals;
+    std::vector<std::string> trace = {
+        "Input 'Begin' in state 0",
+        "Shift 'Begin', go to state 2",
+        "Return. Stack=[Begin]",
+    };
+    // Reductions of the previous line, performed once the next token is seen
+    auto reduce_line = [&trace](const char* rule, const char* nextToken, int pending) {
+        trace.push_back("Input '"s + nextToken + "' with pending reduce " + std::to_string(pending));
+        trace.push_back("Reduce "s + std::to_string(pending) + " [" + rule + "] without external action, pop back to state 1.");
+        trace.push_back("... then shift 'line', pending reduce 3");
+        trace.push_back("Reduce 3 [lines ::= lines line] without external action, pop back to state 2.");
+        trace.push_back("... then shift 'lines', go to state 1");
+    };
+    const char* previousRule = nullptr;
+    int previousPending = 0;
+    for (size_t i = 0; i < lineCount; ++i) {
+        const char* token = i % 2 == 0 ? "One" : "Two";
+        if (previousRule) {
+            reduce_line(previousRule, token, previousPending);
+        } else {
+            trace.push_back("Input '"s + token + "' in state 2");
+            trace.push_back("Reduce 2 [lines ::=] without external action.");
+            trace.push_back("... then shift 'lines', go to state 1");
+        }
+        if (i % 2 == 0) {
+            trace.push_back("Shift 'One', pending reduce 5");
+            trace.push_back("Return. Stack=[Begin lines One]");
+            previousRule = "line ::= One";
+            previousPending = 5;
+        } else {
+            trace.push_back("Shift 'Two', go to state 3");
+            trace.push_back("Return. Stack=[Begin lines Two]");
+            trace.push_back("Input 'Two' in state 3");
+            trace.push_back("Shift 'Two', pending reduce 6");
+            trace.push_back("Return. Stack=[Begin lines Two Two]");
+            previousRule = "line ::= Two Two";
+            previousPending = 6;
+        }
+    }
+    if (previousRule) {
+        reduce_line(previousRule, "End", previousPending);
+    } else {
+        trace.push_back("Input 'End' in state 2");
+        trace.push_back("Reduce 2 [lines ::=] without external action.");
+        trace.push_back("... then shift 'lines', go to state 1");
+    }
+    trace.push_back("Shift 'End', pending reduce 1");
+    trace.push_back("Return. Stack=[Begin lines End]");
+    trace.push_back("Input '$' with pending reduce 1");
+    trace.push_back("Reduce 1 [block ::= Begin lines End] without external action, pop back to state 0.");
+    trace.push_back("... then shift 'block', go to state 4");
+    trace.push_back("Reduce 0 [start ::= block] without external action, pop back to state 0.");
+    trace.push_back("... then shift 'start', pending reduce -2");
+    trace.push_back("Accept!");
+    return trace;
+}
+
+/**
+ * Generates a synthetic trace with @ref trace_generator
+ * 
+ * @param shape Parameters of the trace
+ * @return Lines of the trace
+ */
+inline std::vector<std::string> generated_trace(const trace_shape& shape) {
+    std::string text;
+    trace_generator(shape).generate([&text](const std::string& chunk) { text += chunk; });
+    std::vector<std::string> trace;
+    for (size_t start = 0, end; (end = text.find('\n', start)) != std::string::npos; start = end + 1)
+        trace.emplace_back(text, start, end - start);
+    return trace;
+}
+
+/**
+ * Total length of the lines of a trace, including line breaks
+ * 
+ * @param trace Lines of the trace
+ * @return Number of bytes of the trace
+ */
+inline size_t trace_bytes(const std::vector<std::string>& trace) {
+    size_t bytes = 0;
+    for (const auto& line : trace)
+        bytes += line.size() + 1;
+    return bytes;
+}
+
+}
@@ -0,0 +1,53 @@
+/**
+ * @file pure_ascii_fragment_table.cpp
+ * 
+ * Benchmarks for the @ref pure_ascii_fragment_table class
+ */
+
+#include "../../testbed/bench.hpp"
+#include "../../../src/render/pure_ascii_fragment_table.hpp"
+#include "fixtures.hpp"
+
+using dmalem::pure_ascii_fragment_table;
+using dmalem::state_fragment_data;
+
+BENCH(state_row) {
+    // One row of a stack that is 16 states deep
+    constexpr size_t columnCount = 16;
+    bench::null_stream ostr;
+    pure_ascii_fragment_table table(ostr);
+    size_t line = 0;
+    bench.items_per_iteration(columnCount);
+    bench.run([&] {
+        for (size_t i = 0; i < columnCount; ++i) {
+            table.state({
+                .state       = static_cast<int>(i),
+                .line        = (line + i) % 4,
+                .columnCount = columnCount,
+                .columnIndex = i,
+                .rowKind     = state_fragment_data::row_kind::neutral,
+                .popCount    = 0,
+            });
+        }
+        ++line;
+    });
+}
+
+BENCH(state_reduce_row) {
+    constexpr size_t columnCount = 16;
+    bench::null_stream ostr;
+    pure_ascii_fragment_table table(ostr);
+    bench.items_per_iteration(columnCount);
+    bench.run([&] {
+        for (size_t i = 0; i < columnCount; ++i) {
+            table.state({
+                .state       = static_cast<int>(i),
+                .line        = 2,
+                .columnCount = columnCount,
+                .columnIndex = i,
+                .rowKind     = state_fragment_data::row_kind::reduce,
+                .popCount    = 3,
+            });
+        }
+    });
+}
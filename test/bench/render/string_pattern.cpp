@@ -0,0 +1,41 @@
+/**
+ * @file string_pattern.cpp
+ * 
+ * Benchmarks for the @ref string_pattern class
+ */
+
+#include "../../testbed/bench.hpp"
+#include "../../../src/render/string_pattern.hpp"
+
+using dmalem::string_pattern;
+
+BENCH(match_with_fields) {
+    const string_pattern pattern("Reduce %d [%S] without external action, pop back to state %d.");
+    const std::string_view line = "Reduce 3 [lines ::= lines line] without external action, pop back to state 2.";
+    std::vector<string_pattern::field> fields;
+    bench.bytes_per_iteration(line.size());
+    bench.items_per_iteration(1);
+    bench.run([&] {
+        fields.clear();
+        test::do_not_optimize(pattern.match(line, fields));
+    });
+}
+
+BENCH(match_without_fields) {
+    const string_pattern pattern("Shift '%S', go to state %d");
+    const std::string_view line = "Shift 'lines', go to state 1";
+    bench.bytes_per_iteration(line.size());
+    bench.items_per_iteration(1);
+    bench.run([&] {
+        test::do_not_optimize(pattern.match(line));
+    });
+}
+
+BENCH(early_mismatch) {
+    const string_pattern pattern("Input '%S' with pending reduce %d");
+    const std::string_view line = "Reduce 3 [lines ::= lines line] without external action, pop back to state 2.";
+    bench.items_per_iteration(1);
+    bench.run([&] {
+        test::do_not_optimize(pattern.match(line));
+    });
+}
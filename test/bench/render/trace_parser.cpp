@@ -0,0 +1,36 @@
+/**
+ * @file trace_parser.cpp
+ * 
+ * Benchmarks for the @ref trace_parser class
+ * with the patterns of @ref default_trace_parser
+ */
+
+#include "../../testbed/bench.hpp"
+#include "../../../src/render/default_trace_parser.hpp"
+#include "fixtures.hpp"
+
+BENCH(parse_line_synthetic_trace) {
+    const auto trace = bench::synthetic_trace(100);
+    bench::null_render_target target;
+    auto parser = dmalem::default_trace_parser();
+    parser.set_target(target);
+    bench.bytes_per_iteration(bench::trace_bytes(trace));
+    bench.items_per_iteration(trace.size());
+    bench.run([&] {
+        for (const auto& line : trace)
+            test::do_not_optimize(parser.parse_line(line));
+    });
+}
+
+BENCH(parse_line_last_pattern) {
+    // Worst case, every pattern has to be tried before the last one matches
+    const std::string line = "Return. Stack=[Begin lines Two Two]";
+    bench::null_render_target target;
+    auto parser = dmalem::default_trace_parser();
+    parser.set_target(target);
+    bench.bytes_per_iteration(line.size());
+    bench.items_per_iteration(1);
+    bench.run([&] {
+        test::do_not_optimize(parser.parse_line(line));
+    });
+}
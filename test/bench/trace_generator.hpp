@@ -0,0 +1,298 @@
+/**
+ * @file trace_generator.hpp
+ * 
+ * Generator of synthetic Lemon traces, independent of any grammar
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/**
+ * Parameters of a synthetic trace
+ */
+struct trace_shape {
+    /**
+     * Number of input tokens, not counting the end of input
+     */
+    uint64_t tokens = 1000;
+    /**
+     * Stack depth at which the trace stops shifting and starts reducing
+     */
+    size_t maxDepth = 64;
+    /**
+     * Largest number of symbols on the right side of a rule, at least 2
+     */
+    size_t fanIn = 4;
+    /**
+     * Probability that a shift leaves a pending reduce instead of a state
+     */
+    double pendingRate = 0.3;
+    /**
+     * Probability that a token causes a syntax error
+     */
+    double errorRate = 0;
+    /**
+     * Largest number of frames popped while recovering from a syntax error
+     */
+    size_t errorLength = 3;
+    /**
+     * Number of distinct token names
+     */
+    size_t tokenKinds = 32;
+    /**
+     * Number of distinct nonterminal names
+     */
+    size_t nonterminalKinds = 16;
+    /**
+     * Whether to print the stack after each token, as Lemon does.
+     * The line is as long as the stack is deep
+     */
+    bool returnLines = true;
+    /**
+     * Seed of the random number generator
+     */
+    uint64_t seed = 1;
+};
+
+/**
+ * Generates a Lemon trace of a single parser session with a given shape
+ * 
+ * The trace uses exactly the line formats of @ref dmalem::default_trace_parser,
+ * and its events are consistent: every reduction pops frames that are on the stack,
+ * a pending reduce is always reduced before the next shift,
+ * and error recovery only pops frames above the bottom of the stack.
+ * The stack grows to @ref trace_shape::maxDepth and then shrinks
+ * back to the bottom, over and over, until the input is used up
+ */
+class trace_generator {
+public:
+    /**
+     * Constructor
+     * 
+     * @param shape Parameters of the trace
+     * @throw std::invalid_argument The fan-in is below 2 or the maximal depth is 0
+     */
+    explicit trace_generator(const trace_shape& shape) : shape(shape), random(shape.seed) {
+        if (shape.fanIn < 2 || shape.maxDepth == 0 || shape.tokenKinds == 0 || shape.nonterminalKinds == 0)
+            throw std::invalid_argument(__FUNCTION__);
+        for (size_t i = 0; i < shape.tokenKinds; ++i)
+            names.push_back("T" + std::to_string(i));
+        for (size_t i = 0; i < shape.nonterminalKinds; ++i)
+            names.push_back("n" + std::to_string(i));
+        errorSymbol = names.size();
+        names.push_back("error");
+        endSymbol = names.size();
+        names.push_back("$");
+        stack.push_back({.symbol = 0, .number = 0, .pending = false});
+    }
+
+    /**
+     * Generates the whole trace
+     * 
+     * @param output Receives chunks of the trace, as `output(const std::string&)`
+     */
+    template<class F>
+    void generate(F&& output) {
+        for (uint64_t i = 0; i < shape.tokens; ++i) {
+            token(uniform(0, shape.tokenKinds - 1));
+            if (buffer.size() >= chunkSize) {
+                output(buffer);
+                buffer.clear();
+            }
+        }
+        finish();
+        output(buffer);
+        buffer.clear();
+    }
+
+private:
+    /**
+     * Frame of the simulated parser stack
+     */
+    struct frame {
+        /**
+         * Index of the symbol name
+         */
+        size_t symbol;
+        /**
+         * Number of the state, or of the rule for a pending reduce
+         */
+        int number;
+        /**
+         * Whether the frame is a pending reduce
+         */
+        bool pending;
+    };
+
+    /**
+     * Random integer in a closed range
+     */
+    size_t uniform(size_t low, size_t high) {
+        return std::uniform_int_distribution<size_t>(low, high)(random);
+    }
+
+    /**
+     * Random event with a given probability
+     */
+    bool chance(double probability) {
+        return probability > 0 && std::uniform_real_distribution<double>(0, 1)(random) < probability;
+    }
+
+    /**
+     * Depth of the stack, not counting its bottom
+     */
+    size_t depth() const {
+        return stack.size() - 1;
+    }
+
+    /**
+     * Emits the notification of a new input token
+     */
+    void input(size_t symbol) {
+        const frame& top = stack.back();
+        buffer += "Input '" + names[symbol] + (top.pending ? "' with pending reduce " : "' in state ")
+            + std::to_string(top.number) + '\n';
+    }
+
+    /**
+     * Pushes a frame, and emits the notification of the shift
+     * 
+     * @param symbol Index of the shifted symbol
+     * @param prefix Prefix of the notification, which depends on what is shifted
+     */
+    void push(size_t symbol, const char* prefix) {
+        const bool pending = chance(shape.pendingRate);
+        const int number = static_cast<int>(pending ? uniform(0, ruleCount - 1) : uniform(1, stateCount - 1));
+        stack.push_back({.symbol = symbol, .number = number, .pending = pending});
+        buffer += prefix + names[symbol] + (pending ? "', pending reduce " : "', go to state ")
+            + std::to_string(number) + '\n';
+    }
+
+    /**
+     * Reduces a rule with a given number of symbols on its right side
+     */
+    void reduce(size_t count) {
+        const size_t lhs = shape.tokenKinds + uniform(0, shape.nonterminalKinds - 1);
+        const int rule = static_cast<int>(uniform(0, ruleCount - 1));
+        buffer += "Reduce " + std::to_string(rule) + " [" + names[lhs] + " ::=";
+        for (size_t i = stack.size() - count; i < stack.size(); ++i)
+            buffer += ' ' + names[stack[i].symbol];
+        stack.resize(stack.size() - count);
+        if (count == 0)
+            buffer += "] without external action.\n";
+        else
+            buffer += "] without external action, pop back to state " + std::to_string(stack.back().number) + ".\n";
+        push(lhs, "... then shift '");
+    }
+
+    /**
+     * Reduces the pending reduce on top of the stack, and any that follow from it
+     */
+    void reduce_pending() {
+        while (stack.back().pending)
+            reduce(uniform(1, std::min(shape.fanIn, depth())));
+    }
+
+    /**
+     * Performs the reductions that precede the shift of a token
+     */
+    void reductions() {
+        reduce_pending();
+        if (shrinking) {
+            // Unwind the stack quickly, at least by one frame per reduction
+            for (size_t n = uniform(1, shape.fanIn); n > 0 && depth() >= 2; --n) {
+                reduce(uniform(2, std::min(shape.fanIn, depth())));
+                reduce_pending();
+            }
+            if (depth() < 2)
+                shrinking = false;
+        } else if (chance(0.3)) {
+            // Keep growing, so only reduce rules with at most one symbol
+            reduce(uniform(0, std::min<size_t>(1, depth())));
+            reduce_pending();
+        }
+    }
+
+    /**
+     * Emits the error recovery for a token, which is then either shifted or discarded
+     */
+    void syntax_error(size_t symbol) {
+        buffer += "Syntax Error!\n";
+        if (chance(0.5) || depth() == 0) {
+            // Lemon discards tokens that cause errors right after an error
+            buffer += "Discard input token " + names[symbol] + '\n';
+            return;
+        }
+        for (size_t n = uniform(0, std::min(shape.errorLength, depth() - 1)); n > 0; --n) {
+            buffer += "Popping " + names[stack.back().symbol] + '\n';
+            stack.pop_back();
+        }
+        push(errorSymbol, "Shift '");
+        reduce_pending();
+        push(symbol, "Shift '");
+    }
+
+    /**
+     * Emits the processing of one input token
+     */
+    void token(size_t symbol) {
+        input(symbol);
+        reductions();
+        if (chance(shape.errorRate))
+            syntax_error(symbol);
+        else
+            push(symbol, "Shift '");
+        if (depth() >= shape.maxDepth)
+            shrinking = true;
+        if (shape.returnLines) {
+            buffer += "Return. Stack=[";
+            for (size_t i = 1; i < stack.size(); ++i)
+                buffer += (i > 1 ? " " : "") + names[stack[i].symbol];
+            buffer += "]\n";
+        }
+    }
+
+    /**
+     * Emits the end of input, which reduces the whole stack and accepts
+     */
+    void finish() {
+        input(endSymbol);
+        reduce_pending();
+        while (depth() > 1) {
+            reduce(std::min(shape.fanIn, depth()));
+            reduce_pending();
+        }
+        buffer += "Accept!\n";
+    }
+
+    /**
+     * Size of the buffer at which a chunk of the trace is output
+     */
+    static constexpr size_t chunkSize = 1 << 16;
+    /**
+     * Number of distinct states of the simulated parser
+     */
+    static constexpr size_t stateCount = 1000;
+    /**
+     * Number of distinct rules of the simulated parser
+     */
+    static constexpr size_t ruleCount = 500;
+
+    trace_shape shape;
+    std::mt19937_64 random;
+    std::vector<std::string> names;
+    size_t errorSymbol;
+    size_t endSymbol;
+    std::vector<frame> stack;
+    std::string buffer;
+    bool shrinking = false;
+};
+
+}
@@ -0,0 +1,61 @@
+/**
+ * @file tracegen.cpp
+ * 
+ * Command-line tool that prints a synthetic Lemon trace,
+ * for benchmarking and soak-testing the renderer
+ * 
+ * Usage: `tracegen [-n tokens] [-d maxDepth] [-f fanIn] [-p pendingPercent]
+ *         [-e errorPercent] [-l errorLength] [-s seed] [-R]`
+ * 
+ * `-R` leaves out the stack dumps after each token, which are
+ * as long as the stack is deep (see @ref bench::trace_shape)
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "trace_generator.hpp"
+
+/**
+ * Prints the usage of the tool
+ */
+static void print_usage(const char* name) {
+    std::cerr << "Usage: " << name << " [-n tokens] [-d maxDepth] [-f fanIn] [-p pendingPercent]"
+        " [-e errorPercent] [-l errorLength] [-s seed] [-R]" << std::endl;
+}
+
+int main(int argc, const char* const* argv) {
+    bench::trace_shape shape;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            if (arg == "-R") {
+                shape.returnLines = false;
+                continue;
+            }
+            if (arg.size() != 2 || arg[0] != '-' || i + 1 >= argc)
+                throw std::invalid_argument(argv[i]);
+            const std::string value = argv[++i];
+            switch (arg[1]) {
+                case 'n': shape.tokens = std::stoull(value); break;
+                case 'd': shape.maxDepth = std::stoull(value); break;
+                case 'f': shape.fanIn = std::stoull(value); break;
+                case 'p': shape.pendingRate = std::stod(value) / 100; break;
+                case 'e': shape.errorRate = std::stod(value) / 100; break;
+                case 'l': shape.errorLength = std::stoull(value); break;
+                case 's': shape.seed = std::stoull(value); break;
+                default: throw std::invalid_argument(argv[i - 1]);
+            }
+        }
+        bench::trace_generator generator(shape);
+        generator.generate([](const std::string& chunk) {
+            std::fwrite(chunk.data(), 1, chunk.size(), stdout);
+        });
+    } catch (const std::exception&) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    return std::fflush(stdout) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
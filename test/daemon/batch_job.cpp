@@ -0,0 +1,40 @@
+/**
+ * @file batch_job.cpp
+ * 
+ * Tests for the reading of @ref batch_job lists
+ */
+
+#include <sstream>
+#include "../testbed/test.hpp"
+#include "../../src/daemon/batch_job.hpp"
+
+using dmalem::read_jobs;
+
+TEST(jobs_skip_comments_and_empty_lines) {
+    std::istringstream list(
+        "# Nightly renders\n"
+        "\n"
+        "out/toy.txt grammars/toy.y -- 1 2\n"
+        "  /abs/sql.txt /abs/sql.y -t ascii -f sql.tokens\n"
+    );
+    const auto jobs = read_jobs(list, "/base", "jobs.txt");
+    TEST_ASSERT_EQ(jobs.size(), 2);
+    TEST_ASSERT_EQ(jobs[0].name, "jobs.txt:3");
+    TEST_ASSERT_EQ(jobs[0].outputPath.string(), "/base/out/toy.txt");
+    TEST_ASSERT_EQ(jobs[0].request.grammarPath, "/base/grammars/toy.y");
+    TEST_ASSERT_EQ(jobs[0].request.tokens, (std::vector<int>{1, 2, 0}));
+    TEST_ASSERT_EQ(jobs[1].name, "jobs.txt:4");
+    TEST_ASSERT_EQ(jobs[1].outputPath.string(), "/abs/sql.txt");
+    TEST_ASSERT_EQ(jobs[1].request.targetName, "ascii");
+    TEST_ASSERT_EQ(jobs[1].request.tokenFile, "/base/sql.tokens");
+}
+
+TEST(job_without_grammar_fails) {
+    std::istringstream list("out.txt\n");
+    TEST_ASSERT_THROW(read_jobs(list, "/base", "jobs.txt"), std::invalid_argument);
+}
+
+TEST(job_with_bad_flag_fails) {
+    std::istringstream list("out.txt g.y -x\n");
+    TEST_ASSERT_THROW(read_jobs(list, "/base", "jobs.txt"), std::invalid_argument);
+}
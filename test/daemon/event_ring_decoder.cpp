@@ -0,0 +1,111 @@
+/**
+ * @file event_ring_decoder.cpp
+ * 
+ * Tests for the decoding of the records of a parser in shared memory
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../testbed/test.hpp"
+#include "../../src/daemon/event_ring_decoder.hpp"
+
+using dmalem::event_ring_decoder;
+
+/**
+ * Sink that writes down the steps it is notified of
+ */
+class recording_sink : public dmalem::trace_action_sink {
+public:
+    void input_token(const std::string_view& name) override { steps.push_back("input " + std::string(name)); }
+    void shift(int nextState) override { steps.push_back("shift " + std::to_string(nextState)); }
+    void shift_reduce() override { steps.push_back("shift-reduce"); }
+    void syntax_error() override { steps.push_back("error"); }
+    void reduce(
+        size_t count,
+        const std::string_view& tokenName,
+        const std::string_view& ruleName
+    ) override {
+        steps.push_back("reduce " + std::to_string(count) + " " + std::string(tokenName) + " " + std::string(ruleName));
+    }
+    void pop() override { steps.push_back("pop"); }
+    void discard() override { steps.push_back("discard"); }
+    void accept() override { steps.push_back("accept"); }
+    void failure() override { steps.push_back("fail"); }
+    void stack_overflow() override { steps.push_back("overflow"); }
+    void action_time(std::chrono::nanoseconds duration) override { steps.push_back("time"); }
+    void stack_growth(size_t oldSize, size_t newSize, size_t entrySize) override { steps.push_back("growth"); }
+    void filtered() override { steps.push_back("filtered"); }
+
+    std::vector<std::string> steps;
+};
+
+/**
+ * Ring of a parser with 4 states, the symbols $, NUM and expr, and the rule expr ::= NUM
+ */
+static std::vector<char> make_ring() {
+    static const char names[] = "$\0NUM\0expr\0expr ::= NUM";
+    const size_t recordsOffset = sizeof(event_ring_header);
+    const size_t rulesOffset = recordsOffset + 4 * sizeof(event_ring_record);
+    const size_t namesOffset = rulesOffset + sizeof(event_ring_rule);
+    std::vector<char> memory(namesOffset + sizeof(names));
+
+    event_ring_header header{};
+    header.magic = EVENT_RING_MAGIC;
+    header.version = EVENT_RING_VERSION;
+    header.capacity = 4;
+    header.stateCount = 4;
+    header.symbolCount = 3;
+    header.ruleCount = 1;
+    header.recordsOffset = recordsOffset;
+    header.rulesOffset = rulesOffset;
+    header.namesOffset = namesOffset;
+    header.namesSize = sizeof(names);
+    std::memcpy(memory.data(), &header, sizeof(header));
+    const event_ring_rule rule{.lhs = 2, .rhsCount = 1};
+    std::memcpy(memory.data() + rulesOffset, &rule, sizeof(rule));
+    std::memcpy(memory.data() + namesOffset, names, sizeof(names));
+    return memory;
+}
+
+TEST(ring_records_notify_the_sink) {
+    const auto memory = make_ring();
+    const event_ring_decoder decoder(memory.data(), memory.size());
+    recording_sink sink;
+    const event_ring_record records[] = {
+        {.kind = EVENT_RING_INPUT, .major = 1, .value = 0, .extra = 0},
+        {.kind = EVENT_RING_SHIFT, .major = 1, .value = 3, .extra = 0},
+        {.kind = EVENT_RING_SHIFT, .major = 1, .value = 7, .extra = 0},
+        {.kind = EVENT_RING_REDUCE, .major = 2, .value = 0, .extra = 0},
+        {.kind = EVENT_RING_ERROR, .major = 0, .value = 0, .extra = 0},
+        {.kind = EVENT_RING_ACCEPT, .major = 0, .value = 0, .extra = 0},
+    };
+    for (const auto& r : records)
+        decoder.decode(r, sink);
+    TEST_ASSERT_EQ(sink.steps, (std::vector<std::string>{
+        "input NUM", "shift 3", "shift-reduce", "reduce 1 expr expr ::= NUM", "error", "accept",
+    }));
+}
+
+TEST(ring_records_out_of_range_fail) {
+    const auto memory = make_ring();
+    const event_ring_decoder decoder(memory.data(), memory.size());
+    recording_sink sink;
+    TEST_ASSERT_THROW(decoder.decode({.kind = EVENT_RING_INPUT, .major = 3, .value = 0, .extra = 0}, sink),
+        std::invalid_argument);
+    TEST_ASSERT_THROW(decoder.decode({.kind = EVENT_RING_REDUCE, .major = 2, .value = 1, .extra = 0}, sink),
+        std::invalid_argument);
+    TEST_ASSERT_THROW(decoder.decode({.kind = 42, .major = 0, .value = 0, .extra = 0}, sink),
+        std::invalid_argument);
+}
+
+TEST(ring_without_magic_fails) {
+    auto memory = make_ring();
+    memory[0] ^= 1;
+    TEST_ASSERT_THROW(event_ring_decoder(memory.data(), memory.size()), std::invalid_argument);
+}
+
+TEST(ring_with_truncated_names_fails) {
+    const auto memory = make_ring();
+    TEST_ASSERT_THROW(event_ring_decoder(memory.data(), memory.size() - 1), std::invalid_argument);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file record_stream.cpp
+ * 
+ * Tests for the framing of the responses of the render daemon
+ */
+
+#include <sstream>
+#include "../testbed/test.hpp"
+#include "../../src/daemon/record_stream.hpp"
+
+using dmalem::record;
+using dmalem::record_streambuf;
+using dmalem::record_type;
+using dmalem::read_record;
+using dmalem::write_record;
+
+TEST(record_round_trip) {
+    std::stringstream stream;
+    write_record(stream, record_type::output, "two\nlines\n");
+    write_record(stream, record_type::exit, "0");
+    record r;
+    TEST_ASSERT(read_record(stream, r));
+    TEST_ASSERT(r.type == record_type::output);
+    TEST_ASSERT_EQ(r.data, "two\nlines\n");
+    TEST_ASSERT(read_record(stream, r));
+    TEST_ASSERT(r.type == record_type::exit);
+    TEST_ASSERT_EQ(r.data, "0");
+    TEST_ASSERT(!read_record(stream, r));
+}
+
+TEST(empty_record_round_trip) {
+    std::stringstream stream;
+    write_record(stream, record_type::log, "");
+    record r;
+    TEST_ASSERT(read_record(stream, r));
+    TEST_ASSERT(r.type == record_type::log);
+    TEST_ASSERT(r.data.empty());
+}
+
+TEST(truncated_record_fails) {
+    std::istringstream stream("O10\nshort");
+    record r;
+    TEST_ASSERT_THROW(read_record(stream, r), std::invalid_argument);
+}
+
+TEST(record_of_unknown_type_fails) {
+    std::istringstream stream("Z1\na");
+    record r;
+    TEST_ASSERT_THROW(read_record(stream, r), std::invalid_argument);
+}
+
+TEST(record_streambuf_sends_complete_lines) {
+    std::stringstream stream;
+    {
+        record_streambuf buffer(stream, record_type::output);
+        std::ostream ostr(&buffer);
+        ostr << "first";
+        TEST_ASSERT(stream.str().empty());
+        ostr << " line\nsecond";
+    }
+    record r;
+    TEST_ASSERT(read_record(stream, r));
+    TEST_ASSERT_EQ(r.data, "first line\n");
+    TEST_ASSERT(read_record(stream, r));
+    TEST_ASSERT_EQ(r.data, "second");
+    TEST_ASSERT(!read_record(stream, r));
+}
+
+TEST(record_streambufs_interleave) {
+    std::stringstream stream;
+    record_streambuf outputBuffer(stream, record_type::output);
+    record_streambuf logBuffer(stream, record_type::log);
+    std::ostream output(&outputBuffer), log(&logBuffer);
+    output << "out\n";
+    log << "log" << std::flush;
+    output << 'x' << '\n';
+    record r;
+    TEST_ASSERT(read_record(stream, r) && r.type == record_type::output && r.data == "out\n");
+    TEST_ASSERT(read_record(stream, r) && r.type == record_type::log && r.data == "log");
+    TEST_ASSERT(read_record(stream, r) && r.type == record_type::output && r.data == "x\n");
+}
@@ -0,0 +1,100 @@
+/**
+ * @file render_request.cpp
+ * 
+ * Tests for the reading and writing of @ref render_request
+ */
+
+#include <sstream>
+#include "../testbed/test.hpp"
+#include "../../src/daemon/render_request.hpp"
+#include "../../src/render/argument_parser.hpp"
+
+using dmalem::render_request;
+using dmalem::read_request;
+using dmalem::write_request;
+
+TEST(request_round_trip) {
+    render_request request;
+    request.grammarPath = "/path/to/some grammar.y";
+    request.targetName = "ascii";
+    request.targetOptions = {"first", "second option"};
+    request.tokens = {3, 1, 4, 0};
+    std::stringstream stream;
+    write_request(stream, request);
+    const auto read = read_request(stream);
+    TEST_ASSERT_EQ(read.grammarPath, request.grammarPath);
+    TEST_ASSERT_EQ(read.targetName, request.targetName);
+    TEST_ASSERT_EQ(read.targetOptions, request.targetOptions);
+    TEST_ASSERT_EQ(read.tokens, request.tokens);
+    TEST_ASSERT(read.tokenFile.empty());
+}
+
+TEST(request_stops_at_empty_line) {
+    std::istringstream stream("grammar /g.y\ntokenfile /t.txt\n\nrest");
+    const auto read = read_request(stream);
+    TEST_ASSERT_EQ(read.grammarPath, "/g.y");
+    TEST_ASSERT_EQ(read.tokenFile, "/t.txt");
+    TEST_ASSERT(read.tokens.empty());
+    std::string rest;
+    std::getline(stream, rest);
+    TEST_ASSERT_EQ(rest, "rest");
+}
+
+TEST(request_without_grammar_fails) {
+    std::istringstream stream("target ascii\n\n");
+    TEST_ASSERT_THROW(read_request(stream), std::invalid_argument);
+}
+
+TEST(truncated_request_fails) {
+    std::istringstream stream("grammar /g.y\n");
+    TEST_ASSERT_THROW(read_request(stream), std::invalid_argument);
+}
+
+TEST(request_with_unknown_keyword_fails) {
+    std::istringstream stream("grammar /g.y\ncolor blue\n\n");
+    TEST_ASSERT_THROW(read_request(stream), std::invalid_argument);
+}
+
+TEST(request_with_duplicate_field_fails) {
+    std::istringstream stream("grammar /g.y\ntarget a\ntarget b\n\n");
+    TEST_ASSERT_THROW(read_request(stream), std::invalid_argument);
+}
+
+TEST(request_with_bad_token_fails) {
+    std::istringstream stream("grammar /g.y\ntokens 1 x 0\n\n");
+    TEST_ASSERT_THROW(read_request(stream), std::invalid_argument);
+}
+
+TEST(request_field_with_line_break_cannot_be_written) {
+    render_request request;
+    request.grammarPath = "/g.y";
+    request.targetOptions = {"a\nb"};
+    std::ostringstream stream;
+    TEST_ASSERT_THROW(write_request(stream, request), std::invalid_argument);
+}
+
+TEST(request_from_arguments_matches_drawmealemon) {
+    const auto request = dmalem::request_from_arguments(
+        {"g.y", "-tascii", "-o", "iw=10", "--", "4", "2"},
+        "/base"
+    );
+    TEST_ASSERT_EQ(request.grammarPath, "/base/g.y");
+    TEST_ASSERT_EQ(request.targetName, "ascii");
+    TEST_ASSERT_EQ(request.targetOptions, std::vector<std::string>{"iw=10"});
+    TEST_ASSERT_EQ(request.tokens, (std::vector<int>{4, 2, 0}));
+    TEST_ASSERT(request.tokenFile.empty());
+}
+
+TEST(request_from_arguments_prefers_token_file) {
+    const auto request = dmalem::request_from_arguments({"/abs/g.y", "-f", "t.txt", "--", "1"}, "/base");
+    TEST_ASSERT_EQ(request.grammarPath, "/abs/g.y");
+    TEST_ASSERT_EQ(request.tokenFile, "/base/t.txt");
+    TEST_ASSERT(request.tokens.empty());
+}
+
+TEST(request_from_arguments_rejects_bad_tokens) {
+    TEST_ASSERT_THROW(
+        dmalem::request_from_arguments({"g.y", "--", "1x"}, "/base"),
+        dmalem::argument_parser::error
+    );
+}
@@ -0,0 +1,47 @@
+/**
+ * @file task_pool.cpp
+ * 
+ * Tests for the @ref task_pool class
+ */
+
+#include <atomic>
+#include "../testbed/test.hpp"
+#include "../../src/daemon/task_pool.hpp"
+
+using dmalem::task_pool;
+
+TEST(pool_without_threads_fails) {
+    TEST_ASSERT_THROW(task_pool(0), std::invalid_argument);
+}
+
+TEST(pool_runs_every_task) {
+    std::atomic<int> count = 0;
+    task_pool pool(4);
+    for (int i = 0; i < 1000; ++i)
+        pool.submit([&] { ++count; });
+    pool.wait();
+    TEST_ASSERT_EQ(count.load(), 1000);
+}
+
+TEST(pool_waits_for_nested_tasks) {
+    std::atomic<int> count = 0;
+    task_pool pool(3);
+    for (int i = 0; i < 10; ++i) {
+        pool.submit([&] {
+            for (int j = 0; j < 10; ++j)
+                pool.submit([&] { ++count; });
+        });
+    }
+    pool.wait();
+    TEST_ASSERT_EQ(count.load(), 100);
+}
+
+TEST(pool_can_be_reused_after_wait) {
+    std::atomic<int> count = 0;
+    task_pool pool(2);
+    pool.submit([&] { ++count; });
+    pool.wait();
+    pool.submit([&] { ++count; });
+    pool.wait();
+    TEST_ASSERT_EQ(count.load(), 2);
+}
@@ -0,0 +1,125 @@
+/**
+ * @file ascii_target.cpp
+ * 
+ * Tests for the @ref ascii_target class
+ */
+
+#include <memory>
+#include <sstream>
+#include "../testbed/test.hpp"
+#include "../../src/render/ascii_target.hpp"
+#include "../../src/render/pure_ascii_fragment_table.hpp"
+
+using dmalem::ascii_target;
+using dmalem::pure_ascii_fragment_table;
+
+/**
+ * Stream buffer that discards everything written to it,
+ * so that only the allocations of the target itself are counted
+ */
+class discarding_buffer : public std::streambuf {
+protected:
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+/**
+ * Feeds the target the events of one line of the README grammar
+ */
+static void one_line(ascii_target& target) {
+    target.input_token("One");
+    target.shift_reduce();
+    target.reduce(1, "line", "line ::= One");
+    target.shift_reduce();
+    target.reduce(2, "lines", "lines ::= lines line");
+    target.shift(1);
+}
+
+TEST(steady_state_events_do_not_allocate) {
+    discarding_buffer buffer;
+    std::ostream ostr(&buffer);
+    ascii_target target(ostr, std::make_unique<pure_ascii_fragment_table>());
+    target.input_token("Begin");
+    target.shift(2);
+    // The first line grows the stack to its largest size
+    one_line(target);
+    TEST_ASSERT_NO_ALLOC(one_line(target));
+    TEST_ASSERT_NO_ALLOC({
+        target.input_token("$");
+        target.accept();
+        target.finalize();
+    });
+}
+
+TEST(renders_tokens_and_rules) {
+    std::ostringstream ostr;
+    ascii_target target(ostr, std::make_unique<pure_ascii_fragment_table>());
+    target.input_token("Begin");
+    target.shift(2);
+    one_line(target);
+    target.input_token("$");
+    target.accept();
+    target.finalize();
+    TEST_ASSERT_NE(ostr.str().find("Begin"), std::string::npos);
+    TEST_ASSERT_NE(ostr.str().find("One"), std::string::npos);
+    TEST_ASSERT_NE(ostr.str().find("lines ::= lines line"), std::string::npos);
+    TEST_ASSERT_NE(ostr.str().find("Accept"), std::string::npos);
+}
+
+TEST(trace_that_ends_in_error_recovery_shows_the_error) {
+    std::ostringstream ostr;
+    ascii_target target(ostr, std::make_unique<pure_ascii_fragment_table>());
+    target.input_token("Begin");
+    target.shift(2);
+    target.input_token("Begin");
+    target.syntax_error();
+    TEST_ASSERT_EQ(ostr.str().find("Syntax error"), std::string::npos);
+    target.finalize();
+    TEST_ASSERT_NE(ostr.str().find("Syntax error"), std::string::npos);
+}
+
+TEST(pops_after_failure_are_ignored) {
+    std::ostringstream ostr;
+    ascii_target target(ostr, std::make_unique<pure_ascii_fragment_table>());
+    target.input_token("Begin");
+    target.shift(2);
+    target.input_token("$");
+    target.syntax_error();
+    target.failure();
+    target.pop();
+    target.finalize();
+    TEST_ASSERT_NE(ostr.str().find("Failure"), std::string::npos);
+}
+
+TEST(stack_growth_is_summed_up) {
+    std::ostringstream ostr;
+    ascii_target target(ostr, std::make_unique<pure_ascii_fragment_table>());
+    target.stack_growth(4, 108, 16);
+    one_line(target);
+    target.stack_growth(108, 316, 16);
+    target.finalize();
+    TEST_ASSERT_NE(ostr.str().find("Stack grew 2 times, to 316 entries, reallocating 6784 bytes"), std::string::npos);
+}
+
+TEST(stack_without_growth_is_not_mentioned) {
+    std::ostringstream ostr;
+    ascii_target target(ostr, std::make_unique<pure_ascii_fragment_table>());
+    one_line(target);
+    target.finalize();
+    TEST_ASSERT_EQ(ostr.str().find("Stack grew"), std::string::npos);
+}
+
+TEST(filtered_steps_are_listed) {
+    std::ostringstream ostr;
+    ascii_target target(ostr, std::make_unique<pure_ascii_fragment_table>());
+    target.filtered();
+    target.reduce(1, "line", "line ::= One");
+    target.filtered();
+    target.shift(4);
+    target.finalize();
+    const std::string output = ostr.str();
+    const size_t notice = output.find("Filtered trace");
+    TEST_ASSERT_NE(notice, std::string::npos);
+    TEST_ASSERT_EQ(output.find("Filtered trace", notice + 1), std::string::npos);
+    TEST_ASSERT_NE(output.find("  Reduce [line ::= One]\n  Shift, go to state 4\n"), std::string::npos);
+}
@@ -0,0 +1,61 @@
+/**
+ * @file latency_target.cpp
+ * 
+ * Tests for the @ref latency_target class
+ */
+
+#include <sstream>
+#include "../testbed/test.hpp"
+#include "../../src/render/latency_target.hpp"
+
+using dmalem::latency_target;
+using namespace std::chrono_literals;
+
+TEST(slowest_rules_come_first) {
+    std::ostringstream ostr;
+    latency_target target(ostr, 10);
+    target.reduce(1, "expr", "expr ::= NUM");
+    target.action_time(10ns);
+    target.reduce(3, "expr", "expr ::= expr PLUS expr");
+    target.action_time(300ns);
+    target.reduce(1, "expr", "expr ::= NUM");
+    target.action_time(20ns);
+    target.finalize();
+    const std::string report = ostr.str();
+    const size_t plus = report.find("expr ::= expr PLUS expr");
+    const size_t num = report.find("expr ::= NUM");
+    TEST_ASSERT_NE(plus, std::string::npos);
+    TEST_ASSERT_NE(num, std::string::npos);
+    TEST_ASSERT_LT(plus, num);
+    TEST_ASSERT_NE(report.find("Times of all 3 actions"), std::string::npos);
+    TEST_ASSERT_NE(report.find("256 -        511 ns"), std::string::npos);
+}
+
+TEST(rules_without_times_are_left_out) {
+    std::ostringstream ostr;
+    latency_target target(ostr, 1);
+    target.reduce(0, "list", "list ::=");
+    target.reduce(1, "expr", "expr ::= NUM");
+    target.action_time(5ns);
+    target.reduce(1, "line", "line ::= expr");
+    target.action_time(1ns);
+    target.finalize();
+    const std::string report = ostr.str();
+    TEST_ASSERT_EQ(report.find("list ::="), std::string::npos);
+    TEST_ASSERT_NE(report.find("expr ::= NUM"), std::string::npos);
+    TEST_ASSERT_EQ_(report.find("line ::= expr"), std::string::npos, "Only the slowest rule should be listed");
+}
+
+TEST(time_before_any_reduce_fails) {
+    std::ostringstream ostr;
+    latency_target target(ostr, 10);
+    TEST_ASSERT_THROW(target.action_time(5ns), std::logic_error);
+}
+
+TEST(trace_without_times_says_so) {
+    std::ostringstream ostr;
+    latency_target target(ostr, 10);
+    target.reduce(1, "expr", "expr ::= NUM");
+    target.finalize();
+    TEST_ASSERT_NE(ostr.str().find("no rule with action code"), std::string::npos);
+}
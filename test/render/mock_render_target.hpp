@@ -31,6 +31,9 @@ public:
     void accept() override {}
     void failure() override {}
     void stack_overflow() override {}
+    void action_time(std::chrono::nanoseconds duration) override {}
+    void stack_growth(size_t oldSize, size_t newSize, size_t entrySize) override {}
+    void filtered() override {}
 };
 
 }
@@ -123,3 +123,44 @@ TEST(empty_pattern) {
     TEST_ASSERT(pat.match("  \n\n\t ", fields));
     TEST_ASSERT(fields.empty());
 }
+
+TEST(match_without_fields_does_not_allocate) {
+    const string_pattern pattern("Reduce %d [%S] without external action, pop back to state %d.");
+    const std::string_view line = "Reduce 3 [lines ::= lines line] without external action, pop back to state 2.";
+    bool matched = false;
+    TEST_ASSERT_NO_ALLOC(matched = pattern.match(line));
+    TEST_ASSERT(matched);
+}
+
+TEST(match_into_reserved_fields_does_not_allocate) {
+    const string_pattern pattern("Reduce %d [%S] without external action, pop back to state %d.");
+    const std::string_view line = "Reduce 3 [lines ::= lines line] without external action, pop back to state 2.";
+    std::vector<string_pattern::field> fields;
+    fields.reserve(3);
+    bool matched = false;
+    TEST_ASSERT_NO_ALLOC(matched = pattern.match(line, fields));
+    TEST_ASSERT(matched);
+    TEST_ASSERT_EQ(fields.size(), 3);
+}
+
+TEST(mismatch_does_not_allocate) {
+    const string_pattern pattern("Input '%S' with pending reduce %d");
+    std::vector<string_pattern::field> fields;
+    fields.reserve(2);
+    TEST_ASSERT_NO_ALLOC(pattern.match("Input 'One' in state 2", fields));
+}
+
+TEST(failed_match_leaves_fields_unchanged) {
+    std::vector<string_pattern::field> fields = {42};
+    TEST_ASSERT(!string_pattern("%d %d!").match("1 2?", fields));
+    TEST_ASSERT_EQ(fields.size(), 1);
+    TEST_ASSERT_EQ(std::get<int>(fields[0]), 42);
+}
+
+TEST(successful_match_replaces_fields) {
+    std::vector<string_pattern::field> fields = {42};
+    TEST_ASSERT(string_pattern("%d %d!").match("1 2!", fields));
+    TEST_ASSERT_EQ(fields.size(), 2);
+    TEST_ASSERT_EQ(std::get<int>(fields[0]), 1);
+    TEST_ASSERT_EQ(std::get<int>(fields[1]), 2);
+}
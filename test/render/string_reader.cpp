@@ -191,3 +191,22 @@ TEST(multiple_takes) {
     TEST_ASSERT_EQ(span, "world");
     TEST_ASSERT_EQ(value, 42);
 }
+
+TEST(reading_does_not_allocate) {
+    string_reader r("  Reduce 3 [lines ::= lines line], pop back to state 2.");
+    std::string_view token, span;
+    int value = 0;
+    TEST_ASSERT_NO_ALLOC({
+        r.take_ws();
+        r.take_token(token);
+        r.take_ws();
+        r.take_int(value);
+        r.take_ws();
+        r.take_char('[');
+        r.take_until(']', span);
+        r.take_all();
+    });
+    TEST_ASSERT_EQ(token, "Reduce");
+    TEST_ASSERT_EQ(value, 3);
+    TEST_ASSERT(r.is_done());
+}
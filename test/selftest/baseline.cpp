@@ -0,0 +1,121 @@
+/**
+ * @file baseline.cpp
+ * 
+ * Tests for the comparison of benchmarks to their baselines
+ */
+
+#include <cmath>
+#include <sstream>
+#include "../testbed/test.hpp"
+#include "../testbed/baseline.hpp"
+
+using namespace test;
+
+/**
+ * Header of a baseline, as written by @ref write_benchmarks
+ */
+static const std::string header = "suite\tcase\titerations\tmin_ns\tmedian_ns\tp99_ns\tbytes_per_s\titems_per_s\tsamples_ns\n";
+
+/**
+ * Makes the record of a benchmark with the given samples
+ */
+static bench_record record_of(const std::string& suite, const std::string& name, const std::vector<double>& samples) {
+    bench_record record;
+    record.suite = suite;
+    record.name = name;
+    record.result.samplesNs = samples;
+    return record;
+}
+
+TEST(identical_samples_are_not_significant) {
+    const std::vector<double> samples = {1, 2, 3, 4, 5};
+    const auto comparison = compare_samples(samples, samples);
+    TEST_ASSERT_EQ(comparison.medianRatio, 1);
+    TEST_ASSERT_LT(std::abs(comparison.pValue - 0.542235), 1e-6);
+}
+
+TEST(slower_samples_are_significant) {
+    const auto comparison = compare_samples({6, 7, 8, 9, 10}, {1, 2, 3, 4, 5});
+    TEST_ASSERT_LT(std::abs(comparison.medianRatio - 8.0 / 3), 1e-12);
+    TEST_ASSERT_LT(std::abs(comparison.pValue - 0.006093), 1e-6);
+}
+
+TEST(faster_samples_are_not_significant) {
+    const auto comparison = compare_samples({1, 2, 3, 4, 5}, {6, 7, 8, 9, 10});
+    TEST_ASSERT_LT(std::abs(comparison.medianRatio - 3.0 / 8), 1e-12);
+    TEST_ASSERT_LT(std::abs(comparison.pValue - 0.996692), 1e-6);
+}
+
+TEST(ties_share_their_rank) {
+    const auto comparison = compare_samples({2, 3, 3, 3}, {1, 1, 1, 2});
+    TEST_ASSERT_LT(std::abs(comparison.pValue - 0.016237), 1e-6);
+}
+
+TEST(ties_within_one_side_keep_the_test_exact) {
+    const auto comparison = compare_samples({2, 2, 2, 3}, {1, 2, 2, 2});
+    TEST_ASSERT_LT(std::abs(comparison.pValue - 0.128420), 1e-6);
+}
+
+TEST(all_equal_samples_are_not_slower) {
+    const auto comparison = compare_samples({4, 4, 4}, {4, 4});
+    TEST_ASSERT_EQ(comparison.medianRatio, 1);
+    TEST_ASSERT_EQ(comparison.pValue, 1);
+}
+
+TEST(empty_samples_are_rejected) {
+    const std::vector<double> samples = {1};
+    TEST_ASSERT_THROW(compare_samples({}, samples), std::invalid_argument);
+    TEST_ASSERT_THROW(compare_samples(samples, {}), std::invalid_argument);
+}
+
+TEST(baseline_round_trips) {
+    std::stringstream stream;
+    write_benchmarks(stream, {record_of("suite.cpp", "bench", {1.5, 2.25, 3})});
+    const auto baseline = read_baseline(stream);
+    TEST_ASSERT_EQ(baseline.size(), 1);
+    const auto& samples = baseline.at({"suite.cpp", "bench"});
+    TEST_ASSERT_EQ(samples.size(), 3);
+    TEST_ASSERT_EQ(samples[0], 1.5);
+    TEST_ASSERT_EQ(samples[1], 2.25);
+    TEST_ASSERT_EQ(samples[2], 3);
+}
+
+TEST(baseline_without_header_is_rejected) {
+    std::istringstream istr("suite.cpp\tbench\t1\t1\t1\t1\t0\t0\t1\n");
+    TEST_ASSERT_THROW(read_baseline(istr), std::invalid_argument);
+}
+
+TEST(baseline_line_with_missing_fields_is_rejected) {
+    std::istringstream istr(header + "suite.cpp\tbench\t1\t1\t1\n");
+    TEST_ASSERT_THROW(read_baseline(istr), std::invalid_argument);
+}
+
+TEST(baseline_line_with_bad_sample_is_rejected) {
+    std::istringstream istr(header + "suite.cpp\tbench\t1\t1\t1\t1\t0\t0\t1,fast\n");
+    TEST_ASSERT_THROW(read_baseline(istr), std::invalid_argument);
+}
+
+TEST(significant_slowdown_over_threshold_regresses) {
+    const bench_baseline baseline = {{{"suite.cpp", "bench"}, {1, 2, 3, 4, 5}}};
+    std::ostringstream ostr;
+    TEST_ASSERT(!check_regressions(ostr, {record_of("suite.cpp", "bench", {6, 7, 8, 9, 10})}, baseline, 0.05, 0.01));
+    TEST_ASSERT_NE(ostr.str().find("REGRESSION"), std::string::npos);
+}
+
+TEST(significant_slowdown_under_threshold_passes) {
+    const bench_baseline baseline = {{{"suite.cpp", "bench"}, {1, 2, 3, 4, 5}}};
+    std::ostringstream ostr;
+    TEST_ASSERT(check_regressions(ostr, {record_of("suite.cpp", "bench", {6, 7, 8, 9, 10})}, baseline, 2, 0.01));
+}
+
+TEST(insignificant_slowdown_passes) {
+    const bench_baseline baseline = {{{"suite.cpp", "bench"}, {1, 2, 3, 4, 5}}};
+    std::ostringstream ostr;
+    TEST_ASSERT(check_regressions(ostr, {record_of("suite.cpp", "bench", {6, 7, 8, 9, 10})}, baseline, 0.05, 0.001));
+}
+
+TEST(benchmark_missing_from_baseline_passes) {
+    std::ostringstream ostr;
+    TEST_ASSERT(check_regressions(ostr, {record_of("suite.cpp", "bench", {6, 7, 8, 9, 10})}, {}, 0.05, 0.01));
+    TEST_ASSERT_NE(ostr.str().find("not in baseline"), std::string::npos);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file suite.cpp
+ * 
+ * Tests for the selection of test cases by glob patterns
+ */
+
+#include "../testbed/test.hpp"
+
+using test::glob_match;
+using test::is_selected;
+
+TEST(literal_pattern_matches_itself) {
+    TEST_ASSERT(glob_match("string_pattern", "string_pattern"));
+}
+
+TEST(literal_pattern_rejects_other_text) {
+    TEST_ASSERT(!glob_match("string_pattern", "string_reader"));
+    TEST_ASSERT(!glob_match("string", "string_pattern"));
+    TEST_ASSERT(!glob_match("string_pattern", "string"));
+}
+
+TEST(empty_pattern_matches_only_empty_text) {
+    TEST_ASSERT(glob_match("", ""));
+    TEST_ASSERT(!glob_match("", "a"));
+}
+
+TEST(star_matches_any_sequence) {
+    TEST_ASSERT(glob_match("*", ""));
+    TEST_ASSERT(glob_match("*", "anything"));
+    TEST_ASSERT(glob_match("string_*", "string_"));
+    TEST_ASSERT(glob_match("string_*", "string_pattern"));
+    TEST_ASSERT(glob_match("*_pattern", "string_pattern"));
+    TEST_ASSERT(!glob_match("string_*", "strings"));
+}
+
+TEST(star_backtracks) {
+    TEST_ASSERT(glob_match("*ab*ab", "abxabab"));
+    TEST_ASSERT(glob_match("a*b*c", "aXbYbZc"));
+    TEST_ASSERT(!glob_match("a*b*c", "aXbYbZ"));
+}
+
+TEST(consecutive_stars_match_like_one) {
+    TEST_ASSERT(glob_match("a**", "a"));
+    TEST_ASSERT(glob_match("**b", "ab"));
+}
+
+TEST(question_mark_matches_one_character) {
+    TEST_ASSERT(glob_match("a?c", "abc"));
+    TEST_ASSERT(!glob_match("a?c", "ac"));
+    TEST_ASSERT(!glob_match("a?c", "abbc"));
+    TEST_ASSERT(glob_match("??", "ab"));
+}
+
+TEST(no_filters_select_everything) {
+    TEST_ASSERT(is_selected({}, "test/render/string_pattern.cpp", "construct_from_string"));
+}
+
+TEST(filter_selects_by_case_name) {
+    TEST_ASSERT(is_selected({"construct_*"}, "test/render/string_pattern.cpp", "construct_from_string"));
+    TEST_ASSERT(!is_selected({"construct_*"}, "test/render/string_pattern.cpp", "percent_at_end_is_invalid"));
+}
+
+TEST(filter_selects_by_suite_and_case_name) {
+    TEST_ASSERT(is_selected({"*string_pattern*"}, "test/render/string_pattern.cpp", "percent_at_end_is_invalid"));
+    TEST_ASSERT(is_selected({"test/render/string_pattern.cpp:construct_*"}, "test/render/string_pattern.cpp", "construct_from_string"));
+    TEST_ASSERT(!is_selected({"test/render/string_pattern.cpp:construct_*"}, "test/render/string_reader.cpp", "construct_from_string"));
+}
+
+TEST(suite_name_alone_does_not_select) {
+    TEST_ASSERT(!is_selected({"string_*"}, "test/render/string_pattern.cpp", "percent_at_end_is_invalid"));
+    TEST_ASSERT(!is_selected({"test/render/string_pattern.cpp"}, "test/render/string_pattern.cpp", "percent_at_end_is_invalid"));
+}
+
+TEST(any_filter_selects) {
+    TEST_ASSERT(is_selected({"nothing", "*:percent_*"}, "test/render/string_pattern.cpp", "percent_at_end_is_invalid"));
+}
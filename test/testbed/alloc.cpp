@@ -0,0 +1,83 @@
+/**
+ * @file alloc.cpp
+ * 
+ * Replacements of the global allocation functions
+ * that count the allocations of each thread
+ */
+
+#include <cstdlib>
+#include <new>
+#include "alloc.hpp"
+
+namespace test {
+
+/**
+ * Allocation totals of the current thread
+ */
+static thread_local allocation_totals totals;
+
+allocation_totals current_allocations() noexcept {
+    return totals;
+}
+
+/**
+ * Allocates memory and counts the allocation
+ * 
+ * @param size Number of bytes requested
+ * @param alignment Required alignment, or zero for the default
+ * @return Pointer to the memory, or null if it could not be allocated
+ */
+static void* counted_alloc(size_t size, size_t alignment) noexcept {
+    ++totals.allocations;
+    totals.bytes += size;
+    if (size == 0)
+        size = 1;
+    if (alignment <= alignof(std::max_align_t))
+        return std::malloc(size);
+    // Size passed to aligned_alloc must be a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+/**
+ * Allocates memory and counts the allocation, or throws on failure
+ */
+static void* counted_alloc_or_throw(size_t size, size_t alignment) {
+    void* ptr = counted_alloc(size, alignment);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+/**
+ * Releases memory and counts the deallocation
+ */
+static void counted_free(void* ptr) noexcept {
+    if (!ptr)
+        return;
+    ++totals.deallocations;
+    std::free(ptr);
+}
+
+}
+
+void* operator new(size_t size) { return test::counted_alloc_or_throw(size, 0); }
+void* operator new[](size_t size) { return test::counted_alloc_or_throw(size, 0); }
+void* operator new(size_t size, std::align_val_t al) { return test::counted_alloc_or_throw(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al) { return test::counted_alloc_or_throw(size, static_cast<size_t>(al)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return test::counted_alloc(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return test::counted_alloc(size, 0); }
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return test::counted_alloc(size, static_cast<size_t>(al)); }
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return test::counted_alloc(size, static_cast<size_t>(al)); }
+
+void operator delete(void* ptr) noexcept { test::counted_free(ptr); }
+void operator delete[](void* ptr) noexcept { test::counted_free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { test::counted_free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { test::counted_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { test::counted_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { test::counted_free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { test::counted_free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { test::counted_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { test::counted_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { test::counted_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { test::counted_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { test::counted_free(ptr); }
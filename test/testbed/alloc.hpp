@@ -0,0 +1,99 @@
+/**
+ * @file alloc.hpp
+ * 
+ * Counting of dynamic allocations made by tested code
+ * 
+ * The testbed replaces the global `operator new` and `operator delete`
+ * so that every allocation of the current thread is counted
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "assert.hpp"
+
+namespace test {
+
+/**
+ * Totals of allocations made by a thread since it started
+ */
+struct allocation_totals {
+    /**
+     * Number of calls to any form of `operator new`
+     */
+    size_t allocations = 0;
+    /**
+     * Number of calls to any form of `operator delete` with a non-null pointer
+     */
+    size_t deallocations = 0;
+    /**
+     * Number of bytes requested by all calls to `operator new`
+     */
+    size_t bytes = 0;
+};
+
+/**
+ * Retrieves the totals of allocations made by the current thread
+ * 
+ * @return The allocation totals
+ */
+allocation_totals current_allocations() noexcept;
+
+/**
+ * Counts the allocations made by the current thread during its lifetime
+ * 
+ * @example
+ * ```cpp
+ * test::allocation_scope scope;
+ * foo();
+ * TEST_ASSERT_EQ(scope.allocations(), 0);
+ * ```
+ */
+class allocation_scope {
+public:
+    allocation_scope() noexcept : start(current_allocations()) {}
+    /**
+     * Number of allocations made since the scope started
+     */
+    size_t allocations() const noexcept { return current_allocations().allocations - start.allocations; }
+    /**
+     * Number of deallocations made since the scope started
+     */
+    size_t deallocations() const noexcept { return current_allocations().deallocations - start.deallocations; }
+    /**
+     * Number of bytes allocated since the scope started
+     */
+    size_t bytes() const noexcept { return current_allocations().bytes - start.bytes; }
+private:
+    allocation_totals start;
+};
+
+}
+
+/**
+ * Fails a test case if a statement allocates dynamic memory
+ * 
+ * @param stmt The statement to verify
+ */
+#define TEST_ASSERT_NO_ALLOC(stmt) TEST_ASSERT_NO_ALLOC_(stmt, "")
+
+/**
+ * Fails a test case if a statement allocates dynamic memory
+ * 
+ * @param stmt The statement to verify
+ * @param msg Explanation of the assertion
+ */
+#define TEST_ASSERT_NO_ALLOC_(stmt, msg) \
+    ([&] { \
+        const ::test::allocation_scope allocScope; \
+        stmt; \
+        const size_t allocCount = allocScope.allocations(); \
+        const size_t allocBytes = allocScope.bytes(); \
+        if (allocCount != 0) \
+            FAIL_( \
+                "Assertion failed: " msg "\nStatement allocates: " #stmt \
+                "\n    Allocations: " + std::to_string(allocCount) + \
+                "\n          Bytes: " + std::to_string(allocBytes) \
+            ); \
+    }())
@@ -0,0 +1,142 @@
+/**
+ * @file baseline.cpp
+ * 
+ * Storage of benchmark baselines and detection of regressions against them
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include "baseline.hpp"
+
+namespace test {
+
+/**
+ * Splits a line into tab-separated fields
+ */
+static std::vector<std::string> split(const std::string& line, char separator) {
+    std::vector<std::string> fields;
+    std::istringstream istr(line);
+    std::string field;
+    while (std::getline(istr, field, separator))
+        fields.push_back(field);
+    return fields;
+}
+
+bench_baseline read_baseline(std::istream& istr) {
+    bench_baseline baseline;
+    std::string line;
+    // The first line is the header
+    if (!std::getline(istr, line) || !line.starts_with("suite\tcase\t"))
+        throw std::invalid_argument(__FUNCTION__);
+    while (std::getline(istr, line)) {
+        if (line.empty())
+            continue;
+        const auto fields = split(line, '\t');
+        if (fields.size() != 9)
+            throw std::invalid_argument(__FUNCTION__);
+        std::vector<double> samples;
+        for (const auto& sample : split(fields[8], ','))
+            samples.push_back(std::stod(sample));
+        if (samples.empty())
+            throw std::invalid_argument(__FUNCTION__);
+        baseline[{fields[0], fields[1]}] = std::move(samples);
+    }
+    return baseline;
+}
+
+/**
+ * Median of samples
+ */
+static double median(std::vector<double> samples) {
+    std::ranges::sort(samples);
+    const size_t n = samples.size();
+    return n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+}
+
+bench_comparison compare_samples(const std::vector<double>& current, const std::vector<double>& baseline) {
+    if (current.empty() || baseline.empty())
+        throw std::invalid_argument(__FUNCTION__);
+
+    // Rank all samples together, ties get the average of their ranks
+    std::vector<std::pair<double, bool>> pooled; // Sample, whether it is current
+    pooled.reserve(current.size() + baseline.size());
+    for (double sample : current)
+        pooled.emplace_back(sample, true);
+    for (double sample : baseline)
+        pooled.emplace_back(sample, false);
+    std::ranges::sort(pooled);
+
+    const double n1 = current.size(), n2 = baseline.size(), n = n1 + n2;
+    double currentRankSum = 0, tieCorrection = 0;
+    for (size_t first = 0; first < pooled.size(); ) {
+        size_t last = first;
+        while (last + 1 < pooled.size() && pooled[last + 1].first == pooled[first].first)
+            ++last;
+        const double rank = (first + last) / 2.0 + 1;
+        const double ties = last - first + 1;
+        tieCorrection += ties * ties * ties - ties;
+        for (size_t i = first; i <= last; ++i)
+            if (pooled[i].second)
+                currentRankSum += rank;
+        first = last + 1;
+    }
+
+    // Normal approximation of the U statistic of the current samples
+    const double u = currentRankSum - n1 * (n1 + 1) / 2;
+    const double mean = n1 * n2 / 2;
+    const double variance = n1 * n2 / 12 * ((n + 1) - tieCorrection / (n * (n - 1)));
+
+    bench_comparison comparison;
+    comparison.medianRatio = median(current) / median(baseline);
+    if (variance > 0) {
+        // Continuity correction, then the upper tail of the standard normal distribution
+        const double z = (u - mean - 0.5) / std::sqrt(variance);
+        comparison.pValue = 0.5 * std::erfc(z / std::sqrt(2.0));
+    } else {
+        // All samples are equal, nothing is slower
+        comparison.pValue = 1;
+    }
+    return comparison;
+}
+
+bool check_regressions(
+    std::ostream& ostr,
+    const std::vector<bench_record>& records,
+    const bench_baseline& baseline,
+    double threshold,
+    double alpha
+) {
+    int compared = 0, regressed = 0;
+    ostr << "\n===[ BASELINE ]===\n";
+
+    for (const auto& record : records) {
+        ostr << record.suite << ' ' << record.name << ": ";
+        const auto it = baseline.find({record.suite, record.name});
+        if (it == baseline.end()) {
+            ostr << "not in baseline" << std::endl;
+            continue;
+        }
+        const auto comparison = compare_samples(record.result.samplesNs, it->second);
+        const bool isRegression = comparison.pValue < alpha && comparison.medianRatio - 1 > threshold;
+        ostr << std::showpos << std::fixed << std::setprecision(1)
+            << (comparison.medianRatio - 1) * 100 << std::noshowpos << "% median, p="
+            << std::setprecision(4) << comparison.pValue
+            << (isRegression ? " \33[0;31mREGRESSION\33[0m" : "") << std::endl;
+        ++compared;
+        if (isRegression)
+            ++regressed;
+    }
+
+    const bool success = regressed == 0;
+    ostr << "\nBaseline result: "
+        << (success ? "\33[0;32mSUCCESS\33[0m\n" : "\33[0;31mFAILURE\33[0m\n")
+        << regressed << '/' << compared << " benchmarks slower than "
+        << std::setprecision(1) << threshold * 100 << "% over the baseline" << std::endl;
+    return success;
+}
+
+}
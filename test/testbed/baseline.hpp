@@ -0,0 +1,80 @@
+/**
+ * @file baseline.hpp
+ * 
+ * Storage of benchmark baselines and detection of regressions against them
+ */
+
+#pragma once
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench.hpp"
+
+namespace test {
+
+/**
+ * Samples of a previous run of the benchmarks, in nanoseconds per iteration,
+ * keyed by suite and case names
+ */
+using bench_baseline = std::map<std::pair<std::string, std::string>, std::vector<double>>;
+
+/**
+ * Reads a baseline in the format written by @ref write_benchmarks
+ * 
+ * @param istr Stream to read the baseline from
+ * @return The baseline
+ * @throw std::invalid_argument The stream does not contain a valid baseline
+ */
+bench_baseline read_baseline(std::istream& istr);
+
+/**
+ * Result of comparing a benchmark to its baseline
+ */
+struct bench_comparison {
+    /**
+     * Ratio of the current median time to the baseline median time
+     */
+    double medianRatio = 1;
+    /**
+     * Probability that samples at least this much slower than the baseline
+     * would be measured if the code was not slower at all
+     * (one-sided Mann-Whitney U test)
+     */
+    double pValue = 1;
+};
+
+/**
+ * Compares samples of a benchmark to samples of its baseline
+ * 
+ * @param current Current samples, not empty
+ * @param baseline Baseline samples, not empty
+ * @return The result of the comparison
+ * @throw std::invalid_argument Either list of samples is empty
+ */
+bench_comparison compare_samples(const std::vector<double>& current, const std::vector<double>& baseline);
+
+/**
+ * Compares benchmarks to a baseline and reports the results
+ * 
+ * A benchmark has regressed if it is slower with statistical significance
+ * and its median is slower than the baseline median by more than the threshold
+ * 
+ * @param ostr Stream to print the report to
+ * @param records Statistics of the current benchmarks
+ * @param baseline The baseline to compare to
+ * @param threshold Largest allowed slowdown of the median, as a fraction (0.05 is 5%)
+ * @param alpha Significance level of the test
+ * @return True if no benchmark has regressed, false otherwise
+ */
+bool check_regressions(
+    std::ostream& ostr,
+    const std::vector<bench_record>& records,
+    const bench_baseline& baseline,
+    double threshold,
+    double alpha = 0.01
+);
+
+}
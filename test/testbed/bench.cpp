@@ -0,0 +1,186 @@
+/**
+ * @file bench.cpp
+ * 
+ * Microbenchmark organization and measurement
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+#include "bench.hpp"
+
+using namespace std::string_literals;
+
+namespace test {
+
+/**
+ * Picks a value at a given rank from sorted samples
+ * 
+ * @param sorted Samples sorted ascending, not empty
+ * @param fraction Rank of the value, from 0 (minimum) to 1 (maximum)
+ * @return The value at the rank, rounded up to the nearest sample
+ */
+static double percentile(const std::vector<double>& sorted, double fraction) {
+    const size_t index = static_cast<size_t>(std::ceil(fraction * (sorted.size() - 1)));
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void bench_state::measure(const std::function<double(size_t)>& batch) {
+    if (measured)
+        throw std::logic_error(__FUNCTION__);
+    measured = true;
+
+    // Warm up caches and branch predictors, doubling the batch until it is long enough
+    size_t iterations = 1;
+    for (double elapsed = 0; elapsed < config.warmupSeconds; ) {
+        const double batchTime = batch(iterations);
+        elapsed += batchTime;
+        if (batchTime < config.sampleSeconds)
+            iterations *= 2;
+    }
+    // Calibrate the number of iterations so that one sample lasts long enough
+    for (double batchTime = batch(iterations); batchTime < config.sampleSeconds; batchTime = batch(iterations)) {
+        const double scale = batchTime > 0 ? config.sampleSeconds / batchTime : 10;
+        iterations = std::max(iterations + 1, static_cast<size_t>(iterations * std::min(scale * 1.2, 10.0)));
+    }
+
+    stats.iterations = iterations;
+    stats.samplesNs.clear();
+    stats.samplesNs.reserve(config.sampleCount);
+    for (size_t i = 0; i < std::max<size_t>(config.sampleCount, 1); ++i)
+        stats.samplesNs.push_back(batch(iterations) * 1e9 / iterations);
+    std::ranges::sort(stats.samplesNs);
+
+    stats.minNs = stats.samplesNs.front();
+    stats.medianNs = percentile(stats.samplesNs, 0.5);
+    stats.p99Ns = percentile(stats.samplesNs, 0.99);
+    if (stats.medianNs > 0) {
+        stats.bytesPerSecond = bytesPerIteration * 1e9 / stats.medianNs;
+        stats.itemsPerSecond = itemsPerIteration * 1e9 / stats.medianNs;
+    }
+}
+
+const bench_result& bench_state::result() const {
+    if (!measured)
+        throw std::logic_error(__FUNCTION__);
+    return stats;
+}
+
+/**
+ * Formats a quantity with a metric prefix
+ * 
+ * @param value The quantity
+ * @param unit Unit of the quantity
+ * @return The formatted quantity
+ */
+static std::string metric(double value, const char* unit) {
+    static const char* const prefixes[] = {"", "k", "M", "G", "T"};
+    size_t prefix = 0;
+    while (value >= 1000 && prefix + 1 < std::size(prefixes)) {
+        value /= 1000;
+        ++prefix;
+    }
+    std::ostringstream ostr;
+    ostr << std::fixed << std::setprecision(2) << value << ' ' << prefixes[prefix] << unit;
+    return ostr.str();
+}
+
+/**
+ * Prints statistics of a benchmark in human-readable form
+ */
+static void print_human(std::ostream& ostr, const bench_result& result) {
+    ostr << std::fixed << std::setprecision(1)
+        << "median " << result.medianNs << " ns"
+        << " (min " << result.minNs << ", p99 " << result.p99Ns << ")";
+    if (result.bytesPerSecond > 0)
+        ostr << ", " << metric(result.bytesPerSecond, "B/s");
+    if (result.itemsPerSecond > 0)
+        ostr << ", " << metric(result.itemsPerSecond, "items/s");
+    ostr << ", " << result.samplesNs.size() << 'x' << result.iterations << " iterations" << std::endl;
+}
+
+/**
+ * Header line of the tab-separated statistics
+ */
+static constexpr const char* machineHeader =
+    "suite\tcase\titerations\tmin_ns\tmedian_ns\tp99_ns\tbytes_per_s\titems_per_s\tsamples_ns";
+
+/**
+ * Prints statistics of a benchmark as one tab-separated line
+ */
+static void print_machine(std::ostream& ostr, const bench_record& record) {
+    const bench_result& result = record.result;
+    ostr << std::fixed << std::setprecision(3)
+        << record.suite << '\t' << record.name << '\t' << result.iterations << '\t'
+        << result.minNs << '\t' << result.medianNs << '\t' << result.p99Ns << '\t'
+        << result.bytesPerSecond << '\t' << result.itemsPerSecond << '\t';
+    for (size_t i = 0; i < result.samplesNs.size(); ++i)
+        ostr << (i ? "," : "") << result.samplesNs[i];
+    ostr << std::endl;
+}
+
+bool has_benchmarks() {
+    return !benchSuites.empty();
+}
+
+void write_benchmarks(std::ostream& ostr, const std::vector<bench_record>& records) {
+    ostr << machineHeader << std::endl;
+    for (const auto& record : records)
+        print_machine(ostr, record);
+}
+
+bool run_benchmarks(
+    std::ostream& ostr,
+    const bench_config& config,
+    bool machineReadable,
+    std::vector<bench_record>* records
+) {
+    bool success = true;
+    if (machineReadable)
+        ostr << machineHeader << std::endl;
+
+    for (const auto& [suiteName, cases] : benchSuites) {
+        if (!machineReadable)
+            ostr << "\n===[ " << suiteName << " ]===\n";
+
+        for (const auto& [caseName, fun] : cases) {
+            if (!machineReadable)
+                ostr << caseName << ": " << std::flush;
+            std::string note;
+
+            bench_state state(config);
+            try {
+                fun(state);
+                if (!state.has_result())
+                    note = "Benchmark did not measure any code";
+            } catch (const std::exception& e) {
+                note = "Benchmark threw an exception of type "s + typeid(e).name() + " [what: " + e.what() + ']';
+            } catch (...) {
+                note = "Benchmark threw a non-exception object";
+            }
+
+            if (!note.empty()) {
+                success = false;
+                std::cerr << suiteName << ' ' << caseName << ": " << note << std::endl;
+                if (!machineReadable)
+                    ostr << "\33[0;31mERROR\33[0m" << std::endl;
+                continue;
+            }
+
+            bench_record record{.suite = suiteName, .name = caseName, .result = state.result()};
+            if (machineReadable)
+                print_machine(ostr, record);
+            else
+                print_human(ostr, record.result);
+            if (records)
+                records->push_back(std::move(record));
+        }
+    }
+
+    return success;
+}
+
+}
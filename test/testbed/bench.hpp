@@ -0,0 +1,240 @@
+/**
+ * @file bench.hpp
+ * 
+ * Microbenchmark organization and measurement
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace test {
+
+/**
+ * Parameters of the measurement shared by all benchmarks
+ */
+struct bench_config {
+    /**
+     * How long the code is run before it is measured, in seconds
+     */
+    double warmupSeconds = 0.05;
+    /**
+     * Minimal duration of one sample, in seconds.
+     * The number of iterations per sample is calibrated to reach it
+     */
+    double sampleSeconds = 0.002;
+    /**
+     * How many samples are taken
+     */
+    size_t sampleCount = 100;
+};
+
+/**
+ * Statistics of a finished benchmark
+ */
+struct bench_result {
+    /**
+     * Number of iterations in one sample
+     */
+    size_t iterations = 0;
+    /**
+     * Time of one iteration in each sample, in nanoseconds, sorted ascending
+     */
+    std::vector<double> samplesNs;
+    /**
+     * Time of one iteration in the fastest sample, in nanoseconds
+     */
+    double minNs = 0;
+    /**
+     * Median time of one iteration, in nanoseconds
+     */
+    double medianNs = 0;
+    /**
+     * 99th percentile of the time of one iteration, in nanoseconds
+     */
+    double p99Ns = 0;
+    /**
+     * Bytes processed per second at the median time, zero if not set
+     */
+    double bytesPerSecond = 0;
+    /**
+     * Items processed per second at the median time, zero if not set
+     */
+    double itemsPerSecond = 0;
+};
+
+/**
+ * Statistics of a finished benchmark, with the name of the benchmark
+ */
+struct bench_record {
+    /**
+     * Name of the suite (source file) of the benchmark
+     */
+    std::string suite;
+    /**
+     * Name of the benchmark case
+     */
+    std::string name;
+    /**
+     * Statistics of the benchmark
+     */
+    bench_result result;
+};
+
+/**
+ * Handle through which a benchmark case measures its code
+ */
+class bench_state {
+public:
+    /**
+     * Constructor
+     *
+     * @param config Parameters of the measurement
+     */
+    explicit bench_state(const bench_config& config) noexcept : config(config) {}
+    /**
+     * Sets how many bytes one iteration processes,
+     * so that the throughput can be reported
+     *
+     * @param bytes Number of bytes
+     */
+    void bytes_per_iteration(size_t bytes) noexcept { bytesPerIteration = bytes; }
+    /**
+     * Sets how many items one iteration processes,
+     * so that the throughput can be reported
+     *
+     * @param items Number of items
+     */
+    void items_per_iteration(size_t items) noexcept { itemsPerIteration = items; }
+    /**
+     * Warms up, calibrates and measures a piece of code.
+     * Can be called only once per benchmark case
+     *
+     * @param fun The code to measure, called once per iteration
+     * @throw std::logic_error The code has already been measured
+     */
+    template<class F>
+    void run(F&& fun) {
+        measure([&fun](size_t iterations) {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i)
+                fun();
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        });
+    }
+    /**
+     * Statistics of the measurement
+     *
+     * @return Statistics of the measurement
+     * @throw std::logic_error The code has not been measured yet
+     */
+    const bench_result& result() const;
+    /**
+     * Checks whether the code has been measured
+     *
+     * @return True if the statistics are available, false otherwise
+     */
+    bool has_result() const noexcept { return measured; }
+
+private:
+    /**
+     * Runs the calibration and measurement
+     *
+     * @param batch Runs the code a given number of times
+     *              and returns the elapsed time in seconds
+     */
+    void measure(const std::function<double(size_t)>& batch);
+
+    bench_config config;
+    bench_result stats;
+    size_t bytesPerIteration = 0;
+    size_t itemsPerIteration = 0;
+    bool measured = false;
+};
+
+/**
+ * Prevents the compiler from optimizing away the computation of a value
+ * 
+ * @param value The value that must be computed
+ */
+template<class T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Runs all benchmarks and prints their statistics
+ * 
+ * @param ostr Stream to print the statistics to
+ * @param config Parameters of the measurement
+ * @param machineReadable Print tab-separated values with a header line
+ *                        instead of the human-readable report
+ * @param records If not null, receives the statistics of all benchmarks
+ *                that ran to completion
+ * @return True if all benchmarks ran to completion, false otherwise
+ */
+bool run_benchmarks(
+    std::ostream& ostr,
+    const bench_config& config,
+    bool machineReadable,
+    std::vector<bench_record>* records = nullptr
+);
+
+/**
+ * Prints statistics of benchmarks as tab-separated values with a header line,
+ * in the same format as @ref run_benchmarks
+ * 
+ * @param ostr Stream to print the statistics to
+ * @param records Statistics of the benchmarks
+ */
+void write_benchmarks(std::ostream& ostr, const std::vector<bench_record>& records);
+
+/**
+ * Checks whether any benchmarks have been registered
+ * 
+ * @return True if there are benchmarks to run, false otherwise
+ */
+bool has_benchmarks();
+
+/**
+ * Benchmarks that have been registered, organized into suites
+ */
+inline std::map<std::string, std::map<std::string, void(*)(bench_state&)>> benchSuites;
+
+}
+
+/**
+ * Declares a benchmark case
+ * 
+ * The body receives a @ref test::bench_state named `bench`
+ * 
+ * @param case Name of the benchmark case
+ * 
+ * @example
+ * ```cpp
+ * BENCH(bar_case) {
+ *     // setup goes here
+ *     bench.bytes_per_iteration(input.size());
+ *     bench.run([&] { test::do_not_optimize(foo(input)); });
+ * }
+ * ```
+ */
+#define BENCH(case) \
+    BENCH_FUN_DECL(case); \
+    ADD_BENCH_CASE(case); \
+    BENCH_FUN_DECL(case)
+
+#define BENCH_INSERT_DUMMY(case) bench_insert_ ## case
+
+#define ADD_BENCH_CASE(case) \
+    static void (* BENCH_INSERT_DUMMY(case))(::test::bench_state&) = \
+    ::test::benchSuites[__BASE_FILE__][#case] = &BENCH_FUN_NAME(case)
+
+#define BENCH_FUN_NAME(case) bench_case_ ## case
+
+#define BENCH_FUN_DECL(case) static void BENCH_FUN_NAME(case)([[maybe_unused]] ::test::bench_state& bench)
@@ -2,15 +2,43 @@
  * @file main.cpp
  * 
  * Entry point of the test runner
+ * 
+ * Usage: `test [-j jobs] [-t seconds] [filter...]`
+ * 
+ * `-j` runs the test cases in the given number of worker processes,
+ * `-t` fails test cases that run longer than the given time,
+ * and filters are glob patterns that select test cases by name
+ * (see @ref test::run_options)
  */
 
 #include <iostream>
 #include <cstdlib>
+#include <string>
+#include <string_view>
 #include "suite.hpp"
 
-int main() {
+int main(int argc, const char* const* argv) {
+    test::run_options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        try {
+            if (arg == "-j" && i + 1 < argc) {
+                options.jobs = std::stoul(argv[++i]);
+            } else if (arg == "-t" && i + 1 < argc) {
+                options.timeoutSeconds = std::stod(argv[++i]);
+            } else if (arg.starts_with('-')) {
+                throw std::invalid_argument(argv[i]);
+            } else {
+                options.filters.emplace_back(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Usage: " << argv[0] << " [-j jobs] [-t seconds] [filter...]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     if (test::has_tests()) {
-        return test::run_tests() ? EXIT_SUCCESS : EXIT_FAILURE;
+        return test::run_tests(options) ? EXIT_SUCCESS : EXIT_FAILURE;
     } else {
         std::cout << "\33[0;31mNo test cases found\33[0m" << std::endl;
         return EXIT_FAILURE;
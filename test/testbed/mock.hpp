@@ -129,7 +129,7 @@ private:
  */
 template<class F>
 class mock {
-    static_assert(false, "Only function types can be mocked");
+    static_assert(!std::is_same_v<F, F>, "Only function types can be mocked");
 };
 
 template<class R, class...Args>
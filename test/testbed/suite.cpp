@@ -4,51 +4,296 @@
  * Test suite organization
  */
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <typeinfo>
+#include <vector>
 #include "suite.hpp"
 #include "failure.hpp"
 
+#if defined(__unix__) || defined(__APPLE__)
+#define TEST_HAS_FORK 1
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#define TEST_HAS_FORK 0
+#endif
+
 using namespace std::string_literals;
 
 namespace test {
 
+/**
+ * A test case selected to run, with its result once it has run
+ */
+struct case_run {
+    const std::string* suiteName;
+    const std::string* caseName;
+    void (*fun)();
+    bool succeeded = false;
+    std::string note;
+};
+
 bool has_tests() {
     return !testSuites.empty();
 }
 
-bool run_tests() {
+bool glob_match(const std::string_view& pattern, const std::string_view& text) noexcept {
+    // Backtrack to the most recent star only, which is enough for globs
+    size_t p = 0, t = 0, starP = std::string_view::npos, starT = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            ++p;
+            ++t;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starT = t;
+        } else if (starP != std::string_view::npos) {
+            p = starP + 1;
+            t = ++starT;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*')
+        ++p;
+    return p == pattern.size();
+}
+
+bool is_selected(const std::vector<std::string>& filters, const std::string& suiteName, const std::string& caseName) {
+    if (filters.empty())
+        return true;
+    const std::string fullName = suiteName + ':' + caseName;
+    return std::ranges::any_of(filters, [&](const std::string& filter) {
+        return glob_match(filter, caseName) || glob_match(filter, fullName);
+    });
+}
+
+/**
+ * Runs a test case in the current process
+ */
+static void run_case(case_run& run) {
+    try {
+        run.fun();
+        run.succeeded = true;
+    } catch (const test_failure& e) {
+        run.note = e.message();
+    } catch (const std::exception& e) {
+        run.note = "Test threw an exception of type "s + typeid(e).name() + " [what: " + e.what() + ']';
+    } catch (...) {
+        run.note = "Test threw a non-exception object";
+    }
+}
+
+/**
+ * Prints the result of a test case
+ */
+static void print_case(const case_run& run) {
+    if (run.succeeded)
+        std::cout << "\33[0;32mPASS\33[0m" << std::endl;
+    else
+        std::cout << "\33[0;31mFAIL\33[0m\n" << run.note << std::endl;
+}
+
+#if TEST_HAS_FORK
+
+/**
+ * A test case running in a worker process
+ */
+struct worker {
+    case_run* run;
+    pid_t pid;
+    int pipe;
+    std::string report;
+    std::chrono::steady_clock::time_point deadline;
+    bool timedOut = false;
+};
+
+/**
+ * Starts a worker process for a test case
+ * 
+ * The worker reports back through a pipe: `P` if the case passed,
+ * or `F` followed by the description of the failure
+ */
+static bool start_worker(case_run& run, const run_options& options, worker& w) {
+    int fds[2];
+    if (::pipe(fds) != 0)
+        return false;
+    // Do not let the worker repeat buffered output of the runner
+    std::cout.flush();
+    std::cerr.flush();
+    const pid_t pid = ::fork();
+    if (pid < 0) {
+        ::close(fds[0]);
+        ::close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        ::close(fds[0]);
+        run_case(run);
+        const std::string report = (run.succeeded ? "P"s : "F"s) + run.note;
+        for (size_t written = 0; written < report.size(); ) {
+            const ssize_t n = ::write(fds[1], report.data() + written, report.size() - written);
+            if (n <= 0)
+                break;
+            written += n;
+        }
+        std::cout.flush();
+        ::_exit(EXIT_SUCCESS);
+    }
+    ::close(fds[1]);
+    w = {.run = &run, .pid = pid, .pipe = fds[0]};
+    if (options.timeoutSeconds > 0)
+        w.deadline = std::chrono::steady_clock::now()
+            + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(options.timeoutSeconds));
+    return true;
+}
+
+/**
+ * Collects the result of a worker process whose pipe has been closed
+ */
+static void finish_worker(worker& w, const run_options& options) {
+    ::close(w.pipe);
+    int status = 0;
+    while (::waitpid(w.pid, &status, 0) < 0 && errno == EINTR) {}
+    case_run& run = *w.run;
+    if (w.timedOut) {
+        std::ostringstream note;
+        note << "Test timed out after " << options.timeoutSeconds << " s";
+        run.note = note.str();
+    } else if (WIFSIGNALED(status)) {
+        run.note = "Test crashed with signal "s + std::to_string(WTERMSIG(status))
+            + " (" + ::strsignal(WTERMSIG(status)) + ')';
+    } else if (w.report.empty() || (WIFEXITED(status) && WEXITSTATUS(status) != EXIT_SUCCESS)) {
+        run.note = "Test process exited with code " + std::to_string(WEXITSTATUS(status)) + " without a result";
+    } else {
+        run.succeeded = w.report[0] == 'P';
+        run.note = w.report.substr(1);
+    }
+}
+
+/**
+ * Runs test cases in parallel worker processes, one process per case
+ * 
+ * @return False if the worker processes could not be started
+ */
+static bool run_isolated(std::vector<case_run>& runs, const run_options& options) {
+    const size_t jobs = std::max(options.jobs, 1u);
+    std::vector<worker> active;
+    size_t next = 0;
+
+    while (next < runs.size() || !active.empty()) {
+        // Keep all workers busy
+        while (active.size() < jobs && next < runs.size()) {
+            worker w;
+            if (!start_worker(runs[next], options, w))
+                return false;
+            active.push_back(std::move(w));
+            ++next;
+        }
+
+        // Wait for output from the workers, or for the nearest deadline
+        int timeoutMs = -1;
+        if (options.timeoutSeconds > 0) {
+            const auto now = std::chrono::steady_clock::now();
+            auto nearest = active.front().deadline;
+            for (const auto& w : active)
+                nearest = std::min(nearest, w.deadline);
+            timeoutMs = static_cast<int>(std::max<long long>(0,
+                std::chrono::duration_cast<std::chrono::milliseconds>(nearest - now).count() + 1));
+        }
+        std::vector<pollfd> fds;
+        for (const auto& w : active)
+            fds.push_back({.fd = w.pipe, .events = POLLIN, .revents = 0});
+        if (::poll(fds.data(), fds.size(), timeoutMs) < 0 && errno != EINTR)
+            return false;
+
+        const auto now = std::chrono::steady_clock::now();
+        for (size_t i = active.size(); i-- > 0; ) {
+            worker& w = active[i];
+            bool done = false;
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                char buffer[4096];
+                const ssize_t n = ::read(w.pipe, buffer, sizeof(buffer));
+                if (n > 0)
+                    w.report.append(buffer, n);
+                else if (n == 0 || errno != EINTR)
+                    done = true;
+            } else if (options.timeoutSeconds > 0 && now >= w.deadline) {
+                ::kill(w.pid, SIGKILL);
+                w.timedOut = true;
+                done = true;
+            }
+            if (done) {
+                finish_worker(w, options);
+                active.erase(active.begin() + i);
+            }
+        }
+    }
+    return true;
+}
+
+#endif
+
+bool run_tests(const run_options& options) {
     int suitesRun = 0, suitesPassed = 0, casesRun = 0, casesPassed = 0;
-    std::cout << "Running all tests...\n";
 
-    for (const auto& [suiteName, cases] : testSuites) {
+    std::vector<case_run> runs;
+    for (const auto& [suiteName, cases] : testSuites)
+        for (const auto& [caseName, fun] : cases)
+            if (is_selected(options.filters, suiteName, caseName))
+                runs.push_back({.suiteName = &suiteName, .caseName = &caseName, .fun = fun});
+    if (runs.empty()) {
+        std::cout << "\33[0;31mNo test cases match the filters\33[0m" << std::endl;
+        return false;
+    }
+
+    // Cases in worker processes run ahead, and are reported once all have finished
+    const bool isolated = options.jobs > 0 || options.timeoutSeconds > 0;
+    if (isolated) {
+#if TEST_HAS_FORK
+        std::cout << "Running " << runs.size() << " tests in "
+            << std::max(options.jobs, 1u) << " worker process(es)..." << std::endl;
+        if (!run_isolated(runs, options)) {
+            std::cout << "\33[0;31mCould not run worker processes\33[0m" << std::endl;
+            return false;
+        }
+#else
+        std::cout << "Worker processes are not supported on this platform" << std::endl;
+        return false;
+#endif
+    } else {
+        std::cout << "Running all tests...\n";
+    }
+
+    for (size_t first = 0; first < runs.size(); ) {
+        const std::string& suiteName = *runs[first].suiteName;
+        size_t last = first;
+        while (last < runs.size() && runs[last].suiteName == runs[first].suiteName)
+            ++last;
         int currentCasesRun = 0, currentCasesPassed = 0;
-        std::cout << "\n===[ " << suiteName << " (" << cases.size()
-            << " test" << (cases.size() == 1 ? "" : "s") << ") ]===\n";
-
-        for (const auto& [caseName, fun] : cases) {
-            std::cout << caseName << ": ";
-            bool succeeded = false;
-            std::string note;
-
-            try {
-                fun();
-                succeeded = true;
-            } catch (const test_failure& e) {
-                note = e.message();
-            } catch (const std::exception& e) {
-                note = "Test threw an exception of type "s + typeid(e).name() + " [what: " + e.what() + ']';
-            } catch (...) {
-                note = "Test threw a non-exception object";
-            }
+        const size_t caseCount = last - first;
+        std::cout << "\n===[ " << suiteName << " (" << caseCount
+            << " test" << (caseCount == 1 ? "" : "s") << ") ]===\n";
 
-            if (succeeded) {
-                std::cout << "\33[0;32mPASS\33[0m" << std::endl;
-                ++currentCasesPassed;
-            } else {
-                std::cout << "\33[0;31mFAIL\33[0m\n" << note << std::endl;
+        for (size_t i = first; i < last; ++i) {
+            case_run& run = runs[i];
+            std::cout << *run.caseName << ": ";
+            if (!isolated) {
+                std::cout.flush();
+                run_case(run);
             }
+            print_case(run);
+            if (run.succeeded)
+                ++currentCasesPassed;
             ++currentCasesRun;
         }
 
@@ -57,6 +302,7 @@ bool run_tests() {
         ++suitesRun;
         if (currentCasesRun == currentCasesPassed)
             ++suitesPassed;
+        first = last;
     }
 
     const bool testSuccess = casesRun == casesPassed;
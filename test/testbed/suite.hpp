@@ -8,15 +8,61 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace test {
 
 /**
- * Runs and evaluates all tests
+ * Settings of a test run
+ */
+struct run_options {
+    /**
+     * Number of worker processes that run the test cases in parallel.
+     * If zero, test cases run one after another in the runner process itself
+     */
+    unsigned jobs = 0;
+    /**
+     * Time limit of each test case in seconds, zero for no limit.
+     * Enforcing it needs worker processes, so at least one is used
+     */
+    double timeoutSeconds = 0;
+    /**
+     * Glob patterns (with `*` and `?`) that select the test cases to run.
+     * A pattern selects a test case if it matches either its name
+     * or its full name in the form `suite:case`.
+     * If empty, all test cases run
+     */
+    std::vector<std::string> filters;
+};
+
+/**
+ * Runs and evaluates all tests selected by the options
  * 
+ * @param options Settings of the test run
  * @return True if all tests succeeded, false otherwise
  */
-bool run_tests();
+bool run_tests(const run_options& options = {});
+
+/**
+ * Matches a string against a glob pattern
+ * 
+ * @param pattern The pattern, where `*` matches any sequence of characters
+ *                and `?` matches any one character
+ * @param text The string to match
+ * @return True if the pattern matches the whole string, false otherwise
+ */
+bool glob_match(const std::string_view& pattern, const std::string_view& text) noexcept;
+
+/**
+ * Checks whether a test case is selected by the filters of a test run
+ * 
+ * @param filters   Glob patterns, as in @ref run_options::filters
+ * @param suiteName Name of the suite of the test case
+ * @param caseName  Name of the test case
+ * @return True if any pattern matches the name or the full name of the test case,
+ *         or there are no patterns
+ */
+bool is_selected(const std::vector<std::string>& filters, const std::string& suiteName, const std::string& caseName);
 
 /**
  * Checks whether any tests have been registered
@@ -9,3 +9,4 @@
 #include "suite.hpp"
 #include "assert.hpp"
 #include "mock.hpp"
+#include "alloc.hpp"